@@ -15,6 +15,7 @@
 
 // Game-related constructs
 #include "./game/game.c"
+#include "./game/generator.game.c"
 #include "./game/profile.game.c"
 
 // Our utils
@@ -53,6 +54,8 @@
 
 #define ENGINE_MAIN "engine-main"
 #define ENGINE_MAIN_THREAD "engine-main-thread"
+#define ENGINE_FRAME_SIGNAL "engine-frame-signal"
+#define ENGINE_STATE_SIGNAL "engine-state-signal"
 
 typedef struct Engine Engine;
 
@@ -81,6 +84,8 @@ struct Engine {
   EventStore eventStore;              // Stores values updated by events
   EventManager eventManager;          // Deals with events
   ThreadManager threadManager;        // Manages the different threads of the program
+  Generator generator;                // Keeps no-guess boards ready in the background
+  Probability probability;            // Works out the mine chances while playing
 
   // The actual game object
   Game standardGame;                  // Holds the state of a standard game
@@ -90,11 +95,15 @@ struct Engine {
   Profile profile;                    // Info about the current active profile
 
   int bState;                         // The state of the engine
+  Signal *pFrameSignal;               // Wakes the main thread up when an event has been resolved
+  Signal *pStateSignal;               // Tells whoever is waiting on the engine that it's done
 
 };
 
 void Engine_init(Engine *this);
 
+void Engine_resolve(p_obj pArgs_Engine, int tArg_NULL);
+
 void Engine_main(p_obj pArgs_Engine, int tArg_NULL);
 
 void Engine_exit(Engine *this);
@@ -114,9 +123,14 @@ void Engine_exit(Engine *this);
  * @param   { Engine * }  this      The engine object.
 */
 void Engine_init(Engine *this) {
+
+  // Start from a clean slate; the games free their old fields whenever they're re-initialized
+  memset(this, 0, sizeof(*this));
   
   // The engine is currently running
   this->bState = 1;
+  this->pFrameSignal = Signal_create(ENGINE_FRAME_SIGNAL);
+  this->pStateSignal = Signal_create(ENGINE_STATE_SIGNAL);
 
   /**
    * Initialize the managers
@@ -179,6 +193,14 @@ void Engine_init(Engine *this) {
   this->standardGame.pProfile = &this->profile;
   this->editorGame.pProfile = &this->profile;
 
+  // Only the standard game needs ready boards
+  this->standardGame.pGenerator = &this->generator;
+  this->editorGame.pGenerator = NULL;
+
+  // The editor shows every mine anyway
+  this->standardGame.pProbability = &this->probability;
+  this->editorGame.pProbability = NULL;
+
   /**
    * Creates event listeners and handlers, alongside their mutexes
   */
@@ -210,8 +232,8 @@ void Engine_init(Engine *this) {
     ENGINE_EVENT_HANDLERS_THREAD,
     ENGINE_EVENT_HANDLERS_MUTEX,
 
-    EventManager_resolveEvent,                    // The routine that resolves events
-    &this->eventManager,                          // The event manager
+    Engine_resolve,                               // The routine that resolves events
+    this,                                         // The engine itself
     0);                                           // A dummy value
 
   /**
@@ -227,6 +249,25 @@ void Engine_init(Engine *this) {
     this,                                         // The engine itself
     0);                                           // A dummy value
 
+  // The main thread sleeps until an event comes in or the page asks for a frame
+  ThreadManager_setThreadSignal(&this->threadManager, ENGINE_MAIN_THREAD, this->pFrameSignal);
+
+  /**
+   * Threads that keep no-guess boards ready
+  */
+  Generator_init(&this->generator, &this->threadManager);
+  Generator_addKind(&this->generator, GAME_EASY_COLUMNS, GAME_EASY_ROWS, GAME_EASY_MINES);
+  Generator_addKind(&this->generator, GAME_DIFFICULT_COLUMNS, GAME_DIFFICULT_ROWS, GAME_DIFFICULT_MINES);
+  Generator_setReadySignal(&this->generator, this->pFrameSignal);
+  Generator_start(&this->generator);
+
+  /**
+   * Threads that help work out the mine chances
+  */
+  Probability_init(&this->probability, &this->threadManager);
+  Probability_setReadySignal(&this->probability, this->pFrameSignal);
+  Probability_start(&this->probability);
+
   /**
    * Finally, we configure the settings 
   */
@@ -252,8 +293,16 @@ void Engine_exit(Engine *this) {
   // Exit the event manager first, since it relies on the threads
   EventManager_exit(&this->eventManager);
 
+  // The generator waits for its workers, so it has to go before them
+  Generator_exit(&this->generator);
+
   // Exit the thread manager last
   ThreadManager_exit(&this->threadManager);
+
+  // Nothing is using the chances anymore
+  Probability_exit(&this->probability);
+
+  // The signals are left alone, since the threads don't wait for each other before they finish
 }
 
 /**
@@ -263,8 +312,28 @@ void Engine_exit(Engine *this) {
  * ////////
  * ////////// 
 */
+/**
+ * Resolves the events that came in, then wakes the main thread up so it can draw them.
+ * 
+ * @param   { p_obj * }   pArgs_Engine  The engine object.
+ * @param   { int }       tArg_NULL     A dummy value.
+*/
+void Engine_resolve(p_obj pArgs_Engine, int tArg_NULL) {
+  
+  // Get the engine
+  Engine *this = (Engine *) pArgs_Engine;
+  int bHasEvent = this->eventManager.dEventCount > 0;
+
+  EventManager_resolveEvent(&this->eventManager, tArg_NULL);
+
+  if(bHasEvent)
+    Signal_raise(this->pFrameSignal);
+}
+
 /**
  * The main thread of the engine.
+ * Frames are only drawn when the page needs them; otherwise the thread sleeps until
+ *    a key is pressed or the page's next frame is due.
  * 
  * @param   { p_obj * }   pArgs_Engine  The engine object.
  * @param   { int }       tArg_NULL     A dummy value.
@@ -273,17 +342,28 @@ void Engine_main(p_obj pArgs_Engine, int tArg_NULL) {
 
   // Get the engine
   Engine *this = (Engine *) pArgs_Engine;
+  int dSleep;
 
   // If the game is done, return
   if(!this->bState)
     return;
 
-  // Update the page
-  PageManager_update(&this->pageManager);
+  // Update the page; whatever the game was waiting on might have come in too
+  if(EventStore_get(&this->eventStore, "key-pressed") || Game_hasNews(&this->standardGame))
+    PageManager_wake(&this->pageManager);
+
+  if(PageManager_needsFrame(&this->pageManager))
+    PageManager_update(&this->pageManager);
+
+  // Keep the usual frame rate while the page is still changing
+  dSleep = PageManager_getSleep(&this->pageManager);
+  ThreadManager_setThreadSleep(&this->threadManager, ENGINE_MAIN_THREAD, dSleep ? dSleep : THREAD_TIMEOUT);
 
   // Termination condition
-  if(EventStore_get(&this->eventStore, "terminate") == 'y')
+  if(EventStore_get(&this->eventStore, "terminate") == 'y') {
     this->bState = 0;
+    Signal_raise(this->pStateSignal);
+  }
 
   // Reset event store each time
   // This has to happen on this thread because this is where the "key-pressed" data is read
@@ -310,4 +390,14 @@ int Engine_getState(Engine *this) {
   return this->bState;
 }
 
+/**
+ * Sleeps until the engine stops running.
+ * 
+ * @param   { Engine * }  this  The engine object.
+*/
+void Engine_wait(Engine *this) {
+  while(this->bState)
+    Signal_wait(this->pStateSignal, PAGE_MAX_SLEEP);
+}
+
 #endif
\ No newline at end of file
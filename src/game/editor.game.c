@@ -15,10 +15,14 @@
 
 #include "../utils/utils.file.h"
 #include "../utils/utils.grid.h"
+#include "../utils/utils.math.h"
 
 #include <stdio.h>
 #include <string.h>
 
+// The chance of a tile getting a mine when the editor scatters mines
+#define EDITOR_SCATTER_PERCENT 15
+
 /**
  * Initializes the game object.
  * 
@@ -46,15 +50,12 @@ void Editor_setup(Game *this) {
  * @param   { int }     dHeight   The height of the field.
 */
 void Editor_init(Game *this, int dWidth, int dHeight) {
-  int x, y;
 
   // Init the field
   Field_init(&this->field, dWidth, dHeight);
 
-  // Mark all bits as inspectd
-  for(x = 0; x < dWidth; x++)
-    for(y = 0; y < dHeight; y++)
-      Field_inspect(&this->field, x, y);
+  // Mark all bits as inspected
+  Grid_clear(this->field.pInspectGrid, 1);
 
   // Compute the numbers
   Field_setNumbers(&this->field);
@@ -190,27 +191,13 @@ int Editor_levelAddable(Game *this, char *sLevelName) {
 
 /**
  * Returns the number of mines on the field.
- * Returns 0 if no mines or if there are too many mines.
- * Max number of mines is dWidth * dHeight - 1.
+ * The editor keeps this count up to date with every edit, so nothing gets rescanned.
  * 
- * @param   { Grid * }      pMines      Grid where the mines are placed.
+ * @param   { Game * }      this        The game object.
  * @return  { int }         dMines      Number of mines on the grid.
 */
 int Editor_countMines(Game *this) {
-	int x, y;
-	int dMines = 0;		// Number of mines on the grid
-
-	// Loops through each tile
-	for(x = 0; x < this->field.dWidth; x++) {
-		for(y = 0; y < this->field.dHeight; y++) {
-
-			// Increments dMines when a mine is found
-			if(Grid_getBit(this->field.pMineGrid, x, y))
-				dMines++;
-		}
-	}
-  
-	return dMines;
+	return this->field.dMines;
 }
 
 /**
@@ -221,10 +208,10 @@ int Editor_countMines(Game *this) {
 */
 int Editor_loadLevel(Game *this) {
   int i, j;
-  int nRows = 0, nColumns = 0;
-  char sRows[4], sColumns[4];
+  int nLines = 0, nRows = 0, nColumns = 0;
+  char sRows[12], sColumns[12];
   char sLevelName[LEVELS_MAX_NAME_LENGTH + 1];
-  char *sLevelArray[GAME_MAX_ROWS + 1];
+  char **sLevelArray;
 
   // Get the level name
   strcpy(sLevelName, this->sSaveName);
@@ -252,18 +239,21 @@ int Editor_loadLevel(Game *this) {
   pLevelFile = File_create(sPath);
 
   // Read the file
-  File_readText(pLevelFile, GAME_MAX_ROWS + 2, &nRows, sLevelArray);
+  // The level can be as tall as the file allows, so the line buffer lives on the heap
+  sLevelArray = calloc(FILE_MAX_LINES + 1, sizeof(*sLevelArray));
+  File_readText(pLevelFile, FILE_MAX_LINES + 1, &nLines, sLevelArray);
 
   // Get the rows and columns
-  String_clear(4, sRows);
-  String_clear(4, sColumns);
+  String_clear(12, sRows);
+  String_clear(12, sColumns);
   
-  i = 0; while(sLevelArray[0][i] >= '0' && sLevelArray[0][i] <= '9') sRows[strlen(sRows)] = sLevelArray[0][i++];
-  i++; while(sLevelArray[0][i] >= '0' && sLevelArray[0][i] <= '9') sColumns[strlen(sColumns)] = sLevelArray[0][i++];
+  i = 0; while(i < 11 && sLevelArray[0][i] >= '0' && sLevelArray[0][i] <= '9') sRows[strlen(sRows)] = sLevelArray[0][i++];
+  i++; while(strlen(sColumns) < 11 && sLevelArray[0][i] >= '0' && sLevelArray[0][i] <= '9') sColumns[strlen(sColumns)] = sLevelArray[0][i++];
 
   // Convert to int
-  nRows = atoi(sRows);
-  nColumns = atoi(sColumns);
+  // Don't trust the header over what the file actually has
+  nRows = minInt(atoi(sRows), nLines - 1);
+  nColumns = minInt(atoi(sColumns), FILE_MAX_LINE_LEN - 1);
 
   // Init the field
   Field_init(&this->field, nColumns, nRows);
@@ -283,7 +273,8 @@ int Editor_loadLevel(Game *this) {
 
   // Clean up then return
   File_kill(pLevelFile);
-  File_freeBuffer(nRows, sLevelArray);
+  File_freeBuffer(nLines, sLevelArray);
+  free(sLevelArray);
   return 1;
 }
 
@@ -312,7 +303,7 @@ int Editor_saveLevel(Game *this) {
   // Some stuff about the buffer we're going to write
   int nRows = this->field.dHeight;          // How many rows we actually have
   int nColumns = this->field.dWidth;        // How many columns we have
-  char *sLevelArray[GAME_MAX_ROWS + 1];     // The buffer that stores what we want to write
+  char **sLevelArray;                       // The buffer that stores what we want to write
 
 	// Completes the path of the level's file
 	snprintf(sPath, LEVELS_MAX_PATH_LENGTH, "%s%s.txt", LEVELS_FOLDER_PATH, sLevelName);
@@ -329,8 +320,11 @@ int Editor_saveLevel(Game *this) {
   // Clear the file
   File_clear(pLevelFile);
 
+  // One line for the header and one for each row
+  sLevelArray = calloc(nRows + 1, sizeof(*sLevelArray));
+
   // Append the width and height first
-  sLevelArray[0] = String_alloc(nColumns + 1);
+  sLevelArray[0] = String_alloc(32);
   sprintf(sLevelArray[0], "%d %d\n", nRows, nColumns);
 
   // Create the data
@@ -351,6 +345,7 @@ int Editor_saveLevel(Game *this) {
   // Garbage collection
   for(i = 0; i <= nRows; i++)
     String_kill(sLevelArray[i]);
+  free(sLevelArray);
   File_kill(pLevelFile);
 
   return 1;
@@ -424,28 +419,31 @@ int Editor_register(Game* this) {
 }
 
 /**
- * Adds a mine on a tile and recomputes numbers.
+ * Adds a mine on a tile and updates the numbers around it.
  * 
  * @param   { Game * }     this     The game object to be modified.
 */
 void Editor_addMine(Game *this) {
-  if(!Grid_getBit(this->field.pMineGrid, this->dCursorX, this->dCursorY))
-    Grid_setBit(this->field.pMineGrid, this->dCursorX, this->dCursorY, 1);
-
-  // Recompute numbers
-  Field_setNumbers(&this->field);
+  Field_setMine(&this->field, this->dCursorX, this->dCursorY, 1);
 }
 
 /**
- * Removes a mine from a tile and recomputes numbers.
+ * Removes a mine from a tile and updates the numbers around it.
  * 
  * @param   { Game * }      this      The game object to be modified.
 */
 void Editor_removeMine(Game *this) {
-  if(Grid_getBit(this->field.pMineGrid, this->dCursorX, this->dCursorY))
-    Grid_setBit(this->field.pMineGrid, this->dCursorX, this->dCursorY, 0);
+  Field_setMine(&this->field, this->dCursorX, this->dCursorY, 0);
+}
 
-  // Recompute numbers
+/**
+ * Recounts the mines and recomputes all the numbers.
+ * The bulk edits below change whole words of the mine grid at once, so they call this when they're done.
+ * 
+ * @param   { Game * }  this  The game object.
+*/
+void Editor_refresh(Game *this) {
+  this->field.dMines = Grid_getCount(this->field.pMineGrid);
   Field_setNumbers(&this->field);
 }
 
@@ -456,6 +454,95 @@ void Editor_removeMine(Game *this) {
 */
 void Editor_clearMines(Game *this) {
   Field_clearMines(&this->field);
+  this->field.dMines = 0;
+}
+
+/**
+ * Fills a rectangle with mines, or clears it.
+ * The parts of the rectangle outside the field are ignored.
+ * 
+ * @param   { Game * }  this      The game object.
+ * @param   { int }     x         The x-coordinate of the top-left corner.
+ * @param   { int }     y         The y-coordinate of the top-left corner.
+ * @param   { int }     dWidth    The width of the rectangle.
+ * @param   { int }     dHeight   The height of the rectangle.
+ * @param   { int }     bMines    Whether to fill the rectangle with mines or clear it.
+*/
+void Editor_fillRect(Game *this, int x, int y, int dWidth, int dHeight, int bMines) {
+  Grid_setRect(this->field.pMineGrid, x, y, dWidth, dHeight, bMines);
+  Editor_refresh(this);
+}
+
+/**
+ * Replaces the mines with random ones, each tile having the given chance of getting a mine.
+ * 
+ * @param   { Game * }  this      The game object.
+ * @param   { int }     dPercent  The chance of each tile being a mine, from 0 to 100.
+*/
+void Editor_fillRandom(Game *this, int dPercent) {
+  int y, w;
+  uint64_t *pRow;
+  Grid *pMines = this->field.pMineGrid;
+  Random random;
+
+  Random_seed(&random, Random_makeSeed());
+
+  // A whole word of tiles at a time
+  for(y = 0; y < pMines->dHeight; y++) {
+    pRow = Grid_getRow(pMines, y);
+
+    // The padding is kept clear
+    for(w = 0; w < pMines->dStride; w++)
+      pRow[w] = Random_getBits(&random, dPercent * 256 / 100) & 
+        (w == pMines->dStride - 1 ? Grid_getTailMask(pMines) : ~0ULL);
+  }
+
+  Editor_refresh(this);
+}
+
+/**
+ * Mirrors the mines from left to right; the cursor stays on the same tile.
+ * 
+ * @param   { Game * }  this  The game object.
+*/
+void Editor_mirror(Game *this) {
+  Grid_mirror(this->field.pMineGrid);
+  this->dCursorX = this->field.dWidth - 1 - this->dCursorX;
+  Editor_refresh(this);
+}
+
+/**
+ * Flips the mines upside down; the cursor stays on the same tile.
+ * 
+ * @param   { Game * }  this  The game object.
+*/
+void Editor_flip(Game *this) {
+  Grid_flip(this->field.pMineGrid);
+  this->dCursorY = this->field.dHeight - 1 - this->dCursorY;
+  Editor_refresh(this);
+}
+
+/**
+ * Rotates the mines clockwise; the cursor stays on the same tile.
+ * Unless the field is square, this swaps its width and height, so the field is re-initialized.
+ * 
+ * @param   { Game * }  this  The game object.
+*/
+void Editor_rotate(Game *this) {
+  int dCursorX = this->dCursorX;
+  Grid *pMines = Grid_create(this->field.dHeight, this->field.dWidth);
+
+  // A clockwise turn is a transpose followed by a mirror
+  Grid_transpose(pMines, this->field.pMineGrid);
+  Grid_mirror(pMines);
+
+  Editor_init(this, pMines->dWidth, pMines->dHeight);
+  Grid_copy(this->field.pMineGrid, pMines);
+  Grid_kill(pMines);
+
+  this->dCursorX = this->field.dWidth - 1 - this->dCursorY;
+  this->dCursorY = dCursorX;
+  Editor_refresh(this);
 }
 
 /**
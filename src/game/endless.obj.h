@@ -0,0 +1,540 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 13:05:37
+ * @ Modified time: 2026-10-16 13:05:37
+ * @ Description:
+ *
+ * The endless field is a board with no edges, split into 64x64 chunks.
+ * Chunks only exist once something touches them, so memory grows with the explored area.
+ * The mines of a chunk don't need to be stored anywhere to be known: every row of mines comes
+ *    from a hash of (seed, chunk, row), so a neighbour's edge can be read without creating it.
+ * Each chunk is just a 64x64 field, which means every row of it is a single word.
+ */
+
+#ifndef GAME_ENDLESS_
+#define GAME_ENDLESS_
+
+#include "./field.obj.h"
+
+#include "../utils/utils.grid.h"
+#include "../utils/utils.hashmap.h"
+#include "../utils/utils.queue.h"
+#include "../utils/utils.random.h"
+#include "../utils/utils.types.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ENDLESS_CHUNK_SIZE GRID_WORD_SIZE         // Chunks are one word wide, so rows never straddle words
+#define ENDLESS_CHUNK_SHIFT GRID_WORD_SHIFT
+
+#define ENDLESS_DENSITY_DEFAULT 40                // Mines per 256 tiles (around 15.6%)
+#define ENDLESS_DENSITY_MIN 32                    // Any sparser and the empty areas stop being finite, so
+                                                  //    a single cascade could run forever
+#define ENDLESS_DENSITY_MAX 128
+
+typedef struct Chunk Chunk;
+typedef struct Endless Endless;
+
+/**
+ * //
+ * ////
+ * //////    Chunk struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * A 64x64 piece of the endless field.
+ *
+ * @struct
+*/
+struct Chunk {
+  int dX, dY;             // The coordinates of the chunk (in chunks, not tiles)
+  int bHasNumbers;        // The numbers are only computed once they're needed
+  int bIsQueued;          // Whether or not the chunk is waiting to resolve its pending tiles
+
+  Field field;            // The mines, flags, inspections and numbers of the chunk
+  Grid *pPending;         // Tiles a cascade from a neighbouring chunk wants inspected
+
+  Chunk *pNext;           // All the chunks are chained so we can free them later
+};
+
+/**
+ * //
+ * ////
+ * //////    Endless struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * The endless field.
+ * This is not a class; it lives wherever the game needs it.
+ *
+ * @struct
+*/
+struct Endless {
+  uint64_t dSeed;         // Every mine on the field comes from this
+  int dDensity;           // How many mines there are per 256 tiles
+
+  HashMap *pChunkMap;     // The chunks that exist so far, keyed by "x,y"
+  Chunk *pChunks;         // The same chunks, chained
+  int dChunkCount;        // How many chunks exist
+
+  int dInspected;         // How many tiles have been inspected
+};
+
+/**
+ * Initializes the endless field.
+ * The 3x3 area around (0, 0) never has mines, so that's where the player should start.
+ *
+ * @param   { Endless * }   this        The endless field to initialize.
+ * @param   { uint64_t }    dSeed       The seed of the field.
+ * @param   { int }         dDensity    The number of mines per 256 tiles.
+*/
+void Endless_init(Endless *this, uint64_t dSeed, int dDensity) {
+  this->dSeed = dSeed;
+  this->dDensity = dDensity < ENDLESS_DENSITY_MIN ? ENDLESS_DENSITY_MIN :
+    dDensity > ENDLESS_DENSITY_MAX ? ENDLESS_DENSITY_MAX : dDensity;
+
+  this->pChunkMap = HashMap_create();
+  this->pChunks = NULL;
+  this->dChunkCount = 0;
+  this->dInspected = 0;
+}
+
+/**
+ * Frees all the chunks of the endless field.
+ *
+ * @param   { Endless * }   this  The endless field to clean up.
+*/
+void Endless_exit(Endless *this) {
+  char sKey[STRING_KEY_MAX_LENGTH];
+  Chunk *pChunk = this->pChunks, *pNext;
+
+  while(pChunk != NULL) {
+    pNext = pChunk->pNext;
+
+    // The hashmap would try to free the chunk itself, so take it out first
+    sprintf(sKey, "%d,%d", pChunk->dX, pChunk->dY);
+    HashMap_set(this->pChunkMap, sKey, NULL);
+
+    Field_exit(&pChunk->field);
+    Grid_kill(pChunk->pPending);
+    free(pChunk);
+
+    pChunk = pNext;
+  }
+
+  HashMap_kill(this->pChunkMap);
+
+  this->pChunks = NULL;
+  this->dChunkCount = 0;
+}
+
+/**
+ * Converts a tile coordinate into the coordinate of its chunk.
+ * This rounds down, so tile -1 belongs to chunk -1 and not chunk 0.
+ *
+ * @param   { int }   d   The tile coordinate.
+ * @return  { int }       The chunk coordinate.
+*/
+int Endless_getChunkCoord(int d) {
+  return d >= 0 ? d / ENDLESS_CHUNK_SIZE : -((-d - 1) / ENDLESS_CHUNK_SIZE) - 1;
+}
+
+/**
+ * Converts a tile coordinate into its coordinate within its chunk.
+ *
+ * @param   { int }   d   The tile coordinate.
+ * @return  { int }       The coordinate within the chunk (0 to 63).
+*/
+int Endless_getLocalCoord(int d) {
+  return d - Endless_getChunkCoord(d) * ENDLESS_CHUNK_SIZE;
+}
+
+/**
+ * Returns a row of mines of any chunk, whether or not the chunk exists.
+ * Each bit is a mine with probability dDensity / 256 (see Random_getBits()).
+ *
+ * @param   { Endless * }   this  The endless field.
+ * @param   { int }         dX    The x-coordinate of the chunk.
+ * @param   { int }         dY    The y-coordinate of the chunk.
+ * @param   { int }         dRow  The row within the chunk.
+ * @return  { uint64_t }          The mines on that row.
+*/
+uint64_t Endless_getMineRow(Endless *this, int dX, int dY, int dRow) {
+  Random random;
+  uint64_t dMines;
+  int x;
+
+  // Every row gets its own generator
+  Random_seed(&random, this->dSeed ^
+    (uint64_t) (uint32_t) dX * 0x9e3779b97f4a7c15ULL ^
+    (uint64_t) (uint32_t) dY * 0xc2b2ae3d27d4eb4fULL ^
+    (uint64_t) (uint32_t) dRow * 0x165667b19e3779f9ULL);
+
+  dMines = Random_getBits(&random, this->dDensity);
+
+  // Keep the starting area clear
+  if(dY * ENDLESS_CHUNK_SIZE + dRow >= -1 && dY * ENDLESS_CHUNK_SIZE + dRow <= 1)
+    for(x = -1; x <= 1; x++)
+      if(Endless_getChunkCoord(x) == dX)
+        dMines &= ~((uint64_t) 1 << Endless_getLocalCoord(x));
+
+  return dMines;
+}
+
+/**
+ * Returns the chunk with the given coordinates, if it exists.
+ *
+ * @param   { Endless * }   this  The endless field.
+ * @param   { int }         dX    The x-coordinate of the chunk.
+ * @param   { int }         dY    The y-coordinate of the chunk.
+ * @return  { Chunk * }           The chunk, or NULL if it hasn't been touched yet.
+*/
+Chunk *Endless_findChunk(Endless *this, int dX, int dY) {
+  char sKey[STRING_KEY_MAX_LENGTH];
+
+  sprintf(sKey, "%d,%d", dX, dY);
+
+  return (Chunk *) HashMap_get(this->pChunkMap, sKey);
+}
+
+/**
+ * Returns the chunk with the given coordinates, creating it if needed.
+ * New chunks get their mines right away, but not their numbers.
+ *
+ * @param   { Endless * }   this  The endless field.
+ * @param   { int }         dX    The x-coordinate of the chunk.
+ * @param   { int }         dY    The y-coordinate of the chunk.
+ * @return  { Chunk * }           The chunk.
+*/
+Chunk *Endless_getChunk(Endless *this, int dX, int dY) {
+  char sKey[STRING_KEY_MAX_LENGTH];
+  Chunk *pChunk = Endless_findChunk(this, dX, dY);
+  int y;
+
+  if(pChunk != NULL)
+    return pChunk;
+
+  pChunk = calloc(1, sizeof(*pChunk));
+  pChunk->dX = dX;
+  pChunk->dY = dY;
+  pChunk->pPending = Grid_create(ENDLESS_CHUNK_SIZE, ENDLESS_CHUNK_SIZE);
+
+  // Fill in the mines
+  Field_init(&pChunk->field, ENDLESS_CHUNK_SIZE, ENDLESS_CHUNK_SIZE);
+
+  for(y = 0; y < ENDLESS_CHUNK_SIZE; y++) {
+    Grid_getRow(pChunk->field.pMineGrid, y)[0] = Endless_getMineRow(this, dX, dY, y);
+    pChunk->field.dMines += __builtin_popcountll(Grid_getRow(pChunk->field.pMineGrid, y)[0]);
+  }
+
+  // Save the chunk
+  sprintf(sKey, "%d,%d", dX, dY);
+  HashMap_add(this->pChunkMap, sKey, pChunk);
+
+  pChunk->pNext = this->pChunks;
+  this->pChunks = pChunk;
+  this->dChunkCount++;
+
+  return pChunk;
+}
+
+/**
+ * Computes the numbers of a chunk.
+ * This is the same bit-sliced counter the regular field uses, except the rows above and below
+ *    and the bits past either side come from the neighbouring chunks (which are never created for this).
+ *
+ * @param   { Endless * }   this    The endless field.
+ * @param   { Chunk * }     pChunk  The chunk whose numbers we need.
+*/
+void Endless_setNumbers(Endless *this, Chunk *pChunk) {
+  int x, y, i, dRow, dChunkY, dLocalY;
+  uint64_t aWest[ENDLESS_CHUNK_SIZE + 2];
+  uint64_t aMid[ENDLESS_CHUNK_SIZE + 2];
+  uint64_t aEast[ENDLESS_CHUNK_SIZE + 2];
+  uint64_t aPlanes[4];
+
+  Field *pField = &pChunk->field;
+
+  if(pChunk->bHasNumbers)
+    return;
+
+  // Collect the mines from one row above to one row below the chunk, with a column on either side
+  for(y = -1; y <= ENDLESS_CHUNK_SIZE; y++) {
+    dChunkY = pChunk->dY + (y < 0 ? -1 : y >= ENDLESS_CHUNK_SIZE ? 1 : 0);
+    dLocalY = (y + ENDLESS_CHUNK_SIZE) % ENDLESS_CHUNK_SIZE;
+
+    aWest[y + 1] = Endless_getMineRow(this, pChunk->dX - 1, dChunkY, dLocalY);
+    aEast[y + 1] = Endless_getMineRow(this, pChunk->dX + 1, dChunkY, dLocalY);
+    aMid[y + 1] = dChunkY == pChunk->dY ?
+      Grid_getRow(pField->pMineGrid, dLocalY)[0] :
+      Endless_getMineRow(this, pChunk->dX, dChunkY, dLocalY);
+  }
+
+  for(y = 0; y < ENDLESS_CHUNK_SIZE; y++) {
+    aPlanes[0] = aPlanes[1] = aPlanes[2] = aPlanes[3] = 0;
+
+    // Add the rows above, at and below the current one
+    for(dRow = y; dRow <= y + 2; dRow++) {
+      Field_addToPlanes(aPlanes, (aMid[dRow] << 1) | (aWest[dRow] >> GRID_WORD_MASK));
+      Field_addToPlanes(aPlanes, (aMid[dRow] >> 1) | (aEast[dRow] << GRID_WORD_MASK));
+
+      if(dRow != y + 1)
+        Field_addToPlanes(aPlanes, aMid[dRow]);
+    }
+
+    // The zero tiles are what cascades spread through
+    Grid_getRow(pField->pZeroGrid, y)[0] = ~(aMid[y + 1] | aPlanes[0] | aPlanes[1] | aPlanes[2] | aPlanes[3]);
+
+    // Unpack the numbers
+    for(x = 0; x < ENDLESS_CHUNK_SIZE; x++) {
+      if((aMid[y + 1] >> x) & 1) {
+        pField->aNumbers[y][x] = -1;
+      } else {
+        for(i = 0, pField->aNumbers[y][x] = 0; i < 4; i++)
+          pField->aNumbers[y][x] |= ((aPlanes[i] >> x) & 1) << i;
+      }
+    }
+  }
+
+  pChunk->bHasNumbers = 1;
+}
+
+/**
+ * Asks a chunk to inspect some tiles of one of its rows, queueing it if it isn't yet.
+ * Nothing happens if all those tiles are already inspected.
+ *
+ * @param   { Endless * }   this    The endless field.
+ * @param   { int }         dX      The x-coordinate of the chunk.
+ * @param   { int }         dY      The y-coordinate of the chunk.
+ * @param   { int }         y       The row within the chunk.
+ * @param   { uint64_t }    dMask   The tiles of the row to inspect.
+ * @param   { Queue * }     pQueue  The chunks waiting to resolve their pending tiles.
+*/
+void Endless_addPending(Endless *this, int dX, int dY, int y, uint64_t dMask, Queue *pQueue) {
+  Chunk *pChunk;
+
+  if(!dMask)
+    return;
+
+  pChunk = Endless_getChunk(this, dX, dY);
+  dMask &= ~Grid_getRow(pChunk->field.pInspectGrid, y)[0];
+
+  if(!dMask)
+    return;
+
+  Grid_getRow(pChunk->pPending, y)[0] |= dMask;
+
+  if(!pChunk->bIsQueued) {
+    pChunk->bIsQueued = 1;
+    Queue_push(pQueue, pChunk);
+  }
+}
+
+/**
+ * Inspects a word of tiles of a chunk, removing flags and keeping count.
+ *
+ * @param   { Endless * }   this    The endless field.
+ * @param   { Chunk * }     pChunk  The chunk to modify.
+ * @param   { int }         y       The row within the chunk.
+ * @param   { uint64_t }    dMask   The tiles to inspect.
+*/
+void Endless_inspectWord(Endless *this, Chunk *pChunk, int y, uint64_t dMask) {
+  Field *pField = &pChunk->field;
+
+  this->dInspected += __builtin_popcountll(dMask & ~Grid_getRow(pField->pInspectGrid, y)[0]);
+
+  Grid_getRow(pField->pFlagGrid, y)[0] &= ~dMask;
+  Field_inspectWord(pField, y, 0, dMask);
+}
+
+/**
+ * Inspects the pending tiles of a chunk and cascades from the zero tiles among them.
+ * The cascade is flooded within the chunk; whatever it touches along the edges is handed
+ *    to the neighbouring chunks as their own pending tiles.
+ *
+ * @param   { Endless * }   this    The endless field.
+ * @param   { Chunk * }     pChunk  The chunk to resolve.
+ * @param   { Queue * }     pQueue  The chunks waiting to resolve their pending tiles.
+*/
+void Endless_resolveChunk(Endless *this, Chunk *pChunk, Queue *pQueue) {
+  int y, dRow, bHasSeeds = 0;
+  int dFloodTop = 0, dFloodBottom = ENDLESS_CHUNK_SIZE - 1;
+  uint64_t dMask, dTop, dBottom;
+  uint64_t *pRegionRow;
+  Grid *pRegion;
+
+  Field *pField = &pChunk->field;
+  int dLast = ENDLESS_CHUNK_SIZE - 1;
+
+  Endless_setNumbers(this, pChunk);
+
+  // The new zero tiles seed the flood
+  pRegion = Grid_create(ENDLESS_CHUNK_SIZE, ENDLESS_CHUNK_SIZE);
+
+  for(y = 0; y < ENDLESS_CHUNK_SIZE; y++) {
+    dMask = Grid_getRow(pChunk->pPending, y)[0] & ~Grid_getRow(pField->pInspectGrid, y)[0];
+    Grid_getRow(pChunk->pPending, y)[0] = 0;
+
+    Grid_getRow(pRegion, y)[0] = dMask & Grid_getRow(pField->pZeroGrid, y)[0];
+    bHasSeeds |= Grid_getRow(pRegion, y)[0] != 0;
+
+    Endless_inspectWord(this, pChunk, y, dMask);
+  }
+
+  // No cascade
+  if(!bHasSeeds) {
+    Grid_kill(pRegion);
+    return;
+  }
+
+  Field_floodZeros(pField, pRegion, &dFloodTop, &dFloodBottom);
+
+  // Inspect the flood and its border within the chunk
+  for(y = 0; y < ENDLESS_CHUNK_SIZE; y++) {
+    for(dRow = y - 1, dMask = 0; dRow <= y + 1; dRow++)
+      if(dRow >= 0 && dRow < ENDLESS_CHUNK_SIZE)
+        dMask |= Grid_getRow(pRegion, dRow)[0] |
+          Grid_getWordWest(pRegion, dRow, 0) |
+          Grid_getWordEast(pRegion, dRow, 0);
+
+    Endless_inspectWord(this, pChunk, y, dMask);
+  }
+
+  // Hand the border past the top and bottom edges to the chunks there
+  dTop = Grid_getRow(pRegion, 0)[0];
+  dBottom = Grid_getRow(pRegion, dLast)[0];
+
+  Endless_addPending(this, pChunk->dX, pChunk->dY - 1, dLast, dTop | (dTop << 1) | (dTop >> 1), pQueue);
+  Endless_addPending(this, pChunk->dX, pChunk->dY + 1, 0, dBottom | (dBottom << 1) | (dBottom >> 1), pQueue);
+
+  // And the corners
+  Endless_addPending(this, pChunk->dX - 1, pChunk->dY - 1, dLast, (dTop & 1) << dLast, pQueue);
+  Endless_addPending(this, pChunk->dX + 1, pChunk->dY - 1, dLast, dTop >> dLast, pQueue);
+  Endless_addPending(this, pChunk->dX - 1, pChunk->dY + 1, 0, (dBottom & 1) << dLast, pQueue);
+  Endless_addPending(this, pChunk->dX + 1, pChunk->dY + 1, 0, dBottom >> dLast, pQueue);
+
+  // The left and right edges spill over into the rows beside them
+  for(y = 0; y < ENDLESS_CHUNK_SIZE; y++) {
+    pRegionRow = Grid_getRow(pRegion, y);
+
+    for(dRow = y - 1; dRow <= y + 1; dRow++) {
+      if(dRow < 0 || dRow > dLast)
+        continue;
+
+      Endless_addPending(this, pChunk->dX - 1, pChunk->dY, dRow, (*pRegionRow & 1) << dLast, pQueue);
+      Endless_addPending(this, pChunk->dX + 1, pChunk->dY, dRow, *pRegionRow >> dLast, pQueue);
+    }
+  }
+
+  Grid_kill(pRegion);
+}
+
+/**
+ * Returns the number on a tile, computing its chunk's numbers if needed.
+ *
+ * @param   { Endless * }   this  The endless field.
+ * @param   { int }         x     The x-coordinate of the tile.
+ * @param   { int }         y     The y-coordinate of the tile.
+ * @return  { int }               The number of adjacent mines, or -1 if the tile is a mine.
+*/
+int Endless_getNumber(Endless *this, int x, int y) {
+  Chunk *pChunk = Endless_getChunk(this, Endless_getChunkCoord(x), Endless_getChunkCoord(y));
+
+  Endless_setNumbers(this, pChunk);
+
+  return pChunk->field.aNumbers[Endless_getLocalCoord(y)][Endless_getLocalCoord(x)];
+}
+
+/**
+ * Checks whether a tile has been inspected.
+ * This never creates chunks; untouched chunks have nothing inspected.
+ *
+ * @param   { Endless * }   this  The endless field.
+ * @param   { int }         x     The x-coordinate of the tile.
+ * @param   { int }         y     The y-coordinate of the tile.
+ * @return  { int }               Whether or not the tile has been inspected.
+*/
+int Endless_isInspected(Endless *this, int x, int y) {
+  Chunk *pChunk = Endless_findChunk(this, Endless_getChunkCoord(x), Endless_getChunkCoord(y));
+
+  return pChunk != NULL &&
+    Grid_getBit(pChunk->field.pInspectGrid, Endless_getLocalCoord(x), Endless_getLocalCoord(y));
+}
+
+/**
+ * Checks whether a tile has been flagged.
+ * This never creates chunks; untouched chunks have no flags.
+ *
+ * @param   { Endless * }   this  The endless field.
+ * @param   { int }         x     The x-coordinate of the tile.
+ * @param   { int }         y     The y-coordinate of the tile.
+ * @return  { int }               Whether or not the tile has a flag.
+*/
+int Endless_isFlagged(Endless *this, int x, int y) {
+  Chunk *pChunk = Endless_findChunk(this, Endless_getChunkCoord(x), Endless_getChunkCoord(y));
+
+  return pChunk != NULL &&
+    Grid_getBit(pChunk->field.pFlagGrid, Endless_getLocalCoord(x), Endless_getLocalCoord(y));
+}
+
+/**
+ * Places or removes a flag on a tile that hasn't been inspected.
+ *
+ * @param   { Endless * }   this  The endless field.
+ * @param   { int }         x     The x-coordinate of the tile.
+ * @param   { int }         y     The y-coordinate of the tile.
+*/
+void Endless_toggleFlag(Endless *this, int x, int y) {
+  Chunk *pChunk = Endless_getChunk(this, Endless_getChunkCoord(x), Endless_getChunkCoord(y));
+  int dLocalX = Endless_getLocalCoord(x);
+  int dLocalY = Endless_getLocalCoord(y);
+
+  if(!Grid_getBit(pChunk->field.pInspectGrid, dLocalX, dLocalY))
+    Grid_setBit(pChunk->field.pFlagGrid, dLocalX, dLocalY,
+      !Grid_getBit(pChunk->field.pFlagGrid, dLocalX, dLocalY));
+}
+
+/**
+ * Inspects a tile, cascading through as many chunks as the empty area spans.
+ *
+ * @param   { Endless * }   this  The endless field.
+ * @param   { int }         x     The x-coordinate of the tile.
+ * @param   { int }         y     The y-coordinate of the tile.
+ * @return  { int }               1 if the tile was a mine, 0 otherwise.
+*/
+int Endless_inspect(Endless *this, int x, int y) {
+  Chunk *pChunk = Endless_getChunk(this, Endless_getChunkCoord(x), Endless_getChunkCoord(y));
+  Queue *pQueue;
+  int dLocalX = Endless_getLocalCoord(x);
+  int dLocalY = Endless_getLocalCoord(y);
+
+  // Flags protect the tile
+  if(Grid_getBit(pChunk->field.pFlagGrid, dLocalX, dLocalY))
+    return 0;
+
+  // Boom
+  if(Grid_getBit(pChunk->field.pMineGrid, dLocalX, dLocalY))
+    return 1;
+
+  // Resolve chunks until the cascade stops spreading
+  pQueue = Queue_create();
+  Endless_addPending(this, pChunk->dX, pChunk->dY, dLocalY, (uint64_t) 1 << dLocalX, pQueue);
+
+  while((pChunk = (Chunk *) Queue_getHead(pQueue)) != NULL) {
+    Queue_pop(pQueue);
+    pChunk->bIsQueued = 0;
+
+    Endless_resolveChunk(this, pChunk, pQueue);
+  }
+
+  Queue_kill(pQueue);
+
+  return 0;
+}
+
+#endif
@@ -12,26 +12,33 @@
 #define GAME_FIELD_
 
 #include "../utils/utils.grid.h"
+#include "../utils/utils.random.h"
 
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
 #include <string.h>
 
-#define FIELD_MAX_ROWS    10
-#define FIELD_MAX_COLUMNS 15
+#define FIELD_GRID_COUNT 4
 
 typedef struct Field Field;
 
 /**
  * The field object.
  * This is not a class (because it doesn't need to be instantiated for the game).
+ * Everything the field points to lives in a single block it owns:
+ * 
+ *    [ the 5 grid headers | the row pointers of aNumbers | the scratch words | the words of the 4 grids | the numbers ]
+ * 
+ * The grid words and the numbers come last, so copying the contents of a field is one memcpy.
+ * The scratch grid sits before them, so it's never part of a copy or a snapshot.
 */
 struct Field {
 
   int dWidth;       // The width of the grid
   int dHeight;      // The height of the grid
   int dMines;       // The total number of mines
+  int dSafeLeft;    // The number of safe tiles that haven't been inspected yet
 
   Grid *pMineGrid;  // Where we store the mines
   Grid *pFlagGrid;  // Where we store the flags
@@ -39,68 +46,172 @@ struct Field {
   // Determines which specific tiles have been inspected
   Grid *pInspectGrid; 
 
-  // Determines the number of mines adjacent to each tile without a mine
-  int aNumbers[FIELD_MAX_ROWS][FIELD_MAX_COLUMNS];
+  // The safe tiles with no adjacent mines; inspecting these cascades
+  Grid *pZeroGrid;
+
+  // Where cascades are flooded; it's kept clear between them
+  Grid *pScratchGrid;
+
+  // Determines the number of mines adjacent to each tile without a mine (-1 for mines)
+  // These are row pointers into the block, so aNumbers[y][x] still works
+  int8_t **aNumbers;
+
+  char *pBlock;         // The one allocation behind everything above
+  size_t dBlockSize;    // The size of the block in bytes
+  size_t dDataOffset;   // Where the grid words start; everything from here on is the board itself
 };
 
 /**
  * Initializes the field object.
- * We give the field object a new instance of the grid class.
+ * The grids and the numbers are all carved out of one zeroed block.
  * Note that this time the return type is void since we're not treating this 
  *    construct as a class.
+ * Whatever the field held before is freed, so a field should start out zeroed (like 
+ *    any struct from calloc()) and can then be re-initialized as often as we want.
  * 
  * @param   { Field * }   this      The field object to modify.
  * @param   { int }       dWidth    The width of the field.
  * @param   { int }       dHeight   The height of the field.
 */
 void Field_init(Field *this, int dWidth, int dHeight) {
-  int i, j;
+  int i;
+  size_t dWords;
+  size_t dScratchOffset;
+  Grid *aGrids;
+  uint64_t *pWords;
+  int8_t *pNumbers;
+
+  // Let go of the previous board
+  free(this->pBlock);
+
+  dWidth = dWidth > 0 ? dWidth : 0;
+  dHeight = dHeight > 0 ? dHeight : 0;
 
   this->dWidth = dWidth;
   this->dHeight = dHeight;
   this->dMines = 0;
+  this->dSafeLeft = dWidth * dHeight;
+
+  // The headers go first; the words after them have to stay aligned
+  dWords = Grid_getWordCount(dWidth, dHeight);
+  dScratchOffset = (FIELD_GRID_COUNT + 1) * sizeof(Grid) + (size_t) dHeight * sizeof(*this->aNumbers);
+  dScratchOffset = (dScratchOffset + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+  this->dDataOffset = dScratchOffset + dWords * sizeof(uint64_t);
+  this->dBlockSize = this->dDataOffset + 
+    FIELD_GRID_COUNT * dWords * sizeof(uint64_t) + 
+    (size_t) dWidth * dHeight + 1;
+
+  this->pBlock = calloc(1, this->dBlockSize);
+
+  aGrids = (Grid *) this->pBlock;
+  pWords = (uint64_t *) (this->pBlock + this->dDataOffset);
+  pNumbers = (int8_t *) (pWords + FIELD_GRID_COUNT * dWords);
 
-  this->pMineGrid = Grid_create(dWidth, dHeight);
-  this->pFlagGrid = Grid_create(dWidth, dHeight);
-  this->pInspectGrid = Grid_create(dWidth, dHeight);
+  this->pMineGrid = Grid_wrap(&aGrids[0], dWidth, dHeight, pWords);
+  this->pFlagGrid = Grid_wrap(&aGrids[1], dWidth, dHeight, pWords + dWords);
+  this->pInspectGrid = Grid_wrap(&aGrids[2], dWidth, dHeight, pWords + 2 * dWords);
+  this->pZeroGrid = Grid_wrap(&aGrids[3], dWidth, dHeight, pWords + 3 * dWords);
+  this->pScratchGrid = Grid_wrap(&aGrids[4], dWidth, dHeight, (uint64_t *) (this->pBlock + dScratchOffset));
+
+  // A pointer to the start of each row of numbers
+  this->aNumbers = (int8_t **) (aGrids + FIELD_GRID_COUNT + 1);
 
   for(i = 0; i < dHeight; i++)
-    for(j = 0; j < dWidth; j++)
-      this->aNumbers[i][j] = 0;
+    this->aNumbers[i] = pNumbers + (size_t) i * dWidth;
 }
 
 /**
- * Populates the mine grid with random mines.
+ * Frees the block of the field.
+ * The field itself isn't freed, since it usually lives inside another struct.
+ * It's safe to call this on a zeroed field or on one that was already cleaned up.
  * 
- * @param   { Field * }   this    The field object to modify.
- * @param   { int }       dMines  The number of mines to create
+ * @param   { Field * }   this      The field object to clean up.
+*/
+void Field_exit(Field *this) {
+  free(this->pBlock);
+
+  this->pBlock = NULL;
+  this->dBlockSize = 0;
+  this->dDataOffset = 0;
+
+  this->pMineGrid = NULL;
+  this->pFlagGrid = NULL;
+  this->pInspectGrid = NULL;
+  this->pZeroGrid = NULL;
+  this->pScratchGrid = NULL;
+  this->aNumbers = NULL;
+}
+
+/**
+ * Copies a whole board onto another field: mines, flags, inspections and numbers.
+ * The field is only re-initialized if its size doesn't match; otherwise, it's a single memcpy.
+ * This is what we use to take (and restore) snapshots of a board.
+ * 
+ * @param   { Field * }   this      The field to overwrite.
+ * @param   { Field * }   pSource   The field to copy.
+*/
+void Field_copy(Field *this, Field *pSource) {
+  if(this == pSource)
+    return;
+
+  if(this->pBlock == NULL || 
+    this->dWidth != pSource->dWidth || 
+    this->dHeight != pSource->dHeight)
+    Field_init(this, pSource->dWidth, pSource->dHeight);
+
+  memcpy(this->pBlock + this->dDataOffset, 
+    pSource->pBlock + pSource->dDataOffset, 
+    pSource->dBlockSize - pSource->dDataOffset);
+
+  this->dMines = pSource->dMines;
+  this->dSafeLeft = pSource->dSafeLeft;
+}
+
+/**
+ * Places random mines everywhere except on a given set of cells.
+ * The mines are sampled with Floyd's algorithm: for each of the last dMines indices j, 
+ *    we pick a random index in [0, j] and take j itself instead if that index is already taken.
+ * The indices skip over the excluded cells (which have to be sorted), so every arrangement 
+ *    of the allowed cells is equally likely, and it takes exactly dMines draws no matter the density.
+ * 
+ * @param   { Field * }   this        The field object to modify.
+ * @param   { int }       dMines      The number of mines to create.
+ * @param   { int[] }     aExcluded   The sorted cell indices (y * width + x) that can't have mines.
+ * @param   { int }       nExcluded   How many cells are excluded.
+ * @param   { Random * }  pRandom     The generator to draw from; the same state gives the same board.
 */
-void Field_populateRandom(Field *this, int dMines) {
+void Field_sampleMines(Field *this, int dMines, int *aExcluded, int nExcluded, Random *pRandom) {
+  int dCells = this->dWidth * this->dHeight - nExcluded;
+  int dIndex, dLocation, i;
 
   // If there's too many mines to fit the grid, we won't allow that
-  if(dMines >= this->dWidth * this->dHeight)
+  if(dMines >= dCells)
     return;
 
-  // Set the current number of mines to 0
+  // Start from an empty grid
+  Grid_clear(this->pMineGrid, 0);
   this->dMines = 0;
 
-  // We will use a clock to seed our RNG
-  srand((unsigned) time(NULL));
-
   // Produce the given number of mines
-  while(dMines--) {
+  for(dIndex = dCells - dMines; dIndex < dCells; dIndex++) {
 
     // Choose a location to plant a mine
-    int dLocation = rand() % (this->dWidth * this->dHeight);
+    dLocation = (int) Random_range(pRandom, (uint32_t) dIndex + 1);
 
-    // While the selected bit already has a mine
-    while(Grid_getBit(this->pMineGrid, 
+    // Skip over the excluded cells
+    for(i = 0; i < nExcluded; i++)
+      if(aExcluded[i] <= dLocation) 
+        dLocation++;
+
+    // If it's already taken, the current index can't be, so use that instead
+    if(Grid_getBit(this->pMineGrid, 
       dLocation % this->dWidth,       // The x-value of the bit 
       dLocation / this->dWidth)) {    // The y-value of the bit
-      
-      // Move to another cell and loop start if end is reached
-      dLocation++;
-      dLocation %= (this->dWidth * this->dHeight);
+      dLocation = dIndex;
+
+      for(i = 0; i < nExcluded; i++)
+        if(aExcluded[i] <= dLocation) 
+          dLocation++;
     }
 
     // Set the chosen bit
@@ -113,6 +224,47 @@ void Field_populateRandom(Field *this, int dMines) {
   }
 }
 
+/**
+ * Populates the mine grid with random mines.
+ * 
+ * @param   { Field * }   this      The field object to modify.
+ * @param   { int }       dMines    The number of mines to create
+ * @param   { Random * }  pRandom   The generator to draw from; the same state gives the same board.
+*/
+void Field_populateRandom(Field *this, int dMines, Random *pRandom) {
+  Field_sampleMines(this, dMines, NULL, 0, pRandom);
+}
+
+/**
+ * Populates the mine grid with random mines, keeping the 3x3 area around a tile clear.
+ * This is what makes the first click of a game safe (and always open up a bit of the board).
+ * If there isn't enough room for that, only the tile itself is kept clear.
+ * 
+ * @param   { Field * }   this      The field object to modify.
+ * @param   { int }       dMines    The number of mines to create
+ * @param   { int }       x         The x-coordinate of the tile to keep clear.
+ * @param   { int }       y         The y-coordinate of the tile to keep clear.
+ * @param   { Random * }  pRandom   The generator to draw from; the same state gives the same board.
+*/
+void Field_populateSafe(Field *this, int dMines, int x, int y, Random *pRandom) {
+  int aExcluded[9], nExcluded = 0;
+  int i, j;
+
+  // Rows go first so the indices come out sorted
+  for(j = y - 1; j <= y + 1; j++)
+    for(i = x - 1; i <= x + 1; i++)
+      if(i >= 0 && i < this->dWidth && j >= 0 && j < this->dHeight)
+        aExcluded[nExcluded++] = j * this->dWidth + i;
+
+  // Not enough room for the whole area
+  if(dMines >= this->dWidth * this->dHeight - nExcluded) {
+    aExcluded[0] = y * this->dWidth + x;
+    nExcluded = 1;
+  }
+
+  Field_sampleMines(this, dMines, aExcluded, nExcluded, pRandom);
+}
+
 /**
  * Populates the mine grid with mines from a custom level.
  * 
@@ -159,52 +311,176 @@ void Field_populateCustom(Field *this, char *sPath) {
 }
 
 /**
- * Specifies the number of mines adjacent to each tile.
+ * Recounts the safe tiles that haven't been inspected yet.
+ * This only needs to happen whenever the mines change; inspections keep the count up to date after.
+ * Each word of a row contributes popcount(~mine & ~inspect), with the padding bits masked off.
  * 
  * @param   { Field * }   this    The field object to modify.
 */
-void Field_setNumbers(Field *this) {
-  int i, j, k, l;
-  int dMines; // Number of mines adjacent to the tile
+void Field_countSafeLeft(Field *this) {
+  int y, w;
+  uint64_t *pMineRow, *pInspectRow;
+  uint64_t dWord;
 
-  // Loops through each tile
-  for(i = 0; i < this->dWidth; i++) {
-    for(j = 0; j < this->dHeight; j++) {
+  this->dSafeLeft = 0;
 
-      // Sets the initial count to 0
-      dMines = 0;
+  for(y = 0; y < this->dHeight; y++) {
+    pMineRow = Grid_getRow(this->pMineGrid, y);
+    pInspectRow = Grid_getRow(this->pInspectGrid, y);
 
-      // Sets dMines to -1 if a mine has been found
-      if(Grid_getBit(this->pMineGrid, i, j))
-        dMines = -1;
+    for(w = 0; w < this->pMineGrid->dStride; w++) {
+      dWord = ~(pMineRow[w] | pInspectRow[w]);
 
-      // Executes the following code if a mine has not been found
-      else {
+      // Don't count the padding past the width
+      if(w == this->pMineGrid->dStride - 1)
+        dWord &= Grid_getTailMask(this->pMineGrid);
 
-        // The following loops checks each adjacent tile
+      this->dSafeLeft += __builtin_popcountll(dWord);
+    }
+  }
+}
 
-        // Loops through each row (top, middle, bottom)
-        for(k = i - 1; k <= i + 1; k++) {
-          if(k >= 0 && k <= this->dWidth - 1) {  // Checks if the tile is within bounds (row)
+/**
+ * Adds a word of bits to a bit-sliced counter.
+ * Each of the 64 lanes keeps its own 4-bit count, stored across the four planes
+ *    (aPlanes[0] holds the 1s, aPlanes[1] the 2s, aPlanes[2] the 4s and aPlanes[3] the 8s).
+ * This is just a ripple-carry adder done on all 64 lanes at once.
+ * 
+ * @param   { uint64_t[] }  aPlanes   The four bitplanes of the counter.
+ * @param   { uint64_t }    dBits     The bits to add to each lane.
+*/
+void Field_addToPlanes(uint64_t aPlanes[4], uint64_t dBits) {
+  uint64_t dCarry;
 
-            // Loops through each column (left, middle, right)
-            for(l = j - 1; l <= j + 1; l++) {
-                if(j >= 0 && j <= this->dHeight - 1) {  // Checks if the tile is within bounds (col)
+  dCarry = aPlanes[0] & dBits;  aPlanes[0] ^= dBits;
+  dBits = dCarry;
+  dCarry = aPlanes[1] & dBits;  aPlanes[1] ^= dBits;
+  dBits = dCarry;
+  dCarry = aPlanes[2] & dBits;  aPlanes[2] ^= dBits;
 
-                  // Increments dMines if an adjacent mine has been found
-                  if(Grid_getBit(this->pMineGrid, k, l))
-                    dMines++;
-                }
-            }
-          }
-        }
+  // There are only ever 8 neighbours, so nothing carries out of the last plane
+  aPlanes[3] |= dCarry;
+}
 
+/**
+ * Computes the adjacent-mine counts of 64 cells of a row at once.
+ * The counts are returned in bit-sliced form, so the number of cell x = w * 64 + i is
+ *    the 4-bit value formed by bit i of each of the four planes.
+ * Note that this counts mines around mine cells too; callers check the mine grid for those.
+ * 
+ * @param   { Field * }     this      The field object to read.
+ * @param   { int }         y         The row we want the numbers of.
+ * @param   { int }         w         Which word of the row we want.
+ * @param   { uint64_t[] }  aPlanes   Where to store the four bitplanes.
+*/
+void Field_getNumberPlanes(Field *this, int y, int w, uint64_t aPlanes[4]) {
+  int dRow;
+
+  aPlanes[0] = aPlanes[1] = aPlanes[2] = aPlanes[3] = 0;
+
+  // Add the rows above, at and below the current one
+  for(dRow = y - 1; dRow <= y + 1; dRow++) {
+    if(dRow < 0 || dRow >= this->dHeight)
+      continue;
+
+    // The western and eastern neighbours
+    Field_addToPlanes(aPlanes, Grid_getWordWest(this->pMineGrid, dRow, w));
+    Field_addToPlanes(aPlanes, Grid_getWordEast(this->pMineGrid, dRow, w));
+
+    // The neighbour directly above or below (a cell isn't its own neighbour)
+    if(dRow != y)
+      Field_addToPlanes(aPlanes, Grid_getRow(this->pMineGrid, dRow)[w]);
+  }
+}
+
+/**
+ * Specifies the number of mines adjacent to each tile.
+ * The counts are built 64 cells at a time with a bit-sliced adder, then unpacked into aNumbers.
+ * 
+ * @param   { Field * }   this    The field object to modify.
+*/
+void Field_setNumbers(Field *this) {
+  int x, y, w, i;
+  uint64_t dMines;        // The mines within the current word
+  uint64_t aPlanes[4];    // The bit-sliced counts of the current word
+
+  // Loops through each word of each row
+  for(y = 0; y < this->dHeight; y++) {
+    for(w = 0; w < this->pMineGrid->dStride; w++) {
+      Field_getNumberPlanes(this, y, w, aPlanes);
+      dMines = Grid_getRow(this->pMineGrid, y)[w];
+
+      // Safe tiles whose count is all zeroes (the padding stays clear)
+      Grid_getRow(this->pZeroGrid, y)[w] = ~(dMines | aPlanes[0] | aPlanes[1] | aPlanes[2] | aPlanes[3]) &
+        (w == this->pZeroGrid->dStride - 1 ? Grid_getTailMask(this->pZeroGrid) : ~(uint64_t) 0);
+
+      // Unpack each lane into the numbers array
+      for(i = 0, x = w << GRID_WORD_SHIFT; i < GRID_WORD_SIZE && x < this->dWidth; i++, x++) {
+
+        // Sets the number to -1 if a mine has been found
+        if((dMines >> i) & 1) {
+          this->aNumbers[y][x] = -1;
+        
+        // Otherwise, read the 4 bits of the count
+        } else {
+          this->aNumbers[y][x] = 
+            ((aPlanes[0] >> i) & 1) | 
+            ((aPlanes[1] >> i) & 1) << 1 | 
+            ((aPlanes[2] >> i) & 1) << 2 | 
+            ((aPlanes[3] >> i) & 1) << 3;
+        }
       }
+    }
+  }
 
-      // Sets the number of adjacent mines
-      this->aNumbers[j][i] = dMines;
+  // The mines might have changed, so the safe tiles have to be recounted
+  Field_countSafeLeft(this);
+}
+
+/**
+ * Places or removes a single mine, keeping the numbers and the counts up to date.
+ * Only the tile and its eight neighbours change, so this doesn't need a call to Field_setNumbers().
+ * 
+ * @param   { Field * }   this    The field object to modify.
+ * @param   { int }       x       The x-coordinate of the tile.
+ * @param   { int }       y       The y-coordinate of the tile.
+ * @param   { int }       bMine   Whether the tile should have a mine or not.
+*/
+void Field_setMine(Field *this, int x, int y, int bMine) {
+  int i, j, dDelta, dCount = 0;
+
+  bMine = bMine ? 1 : 0;
+
+  // Nothing to change
+  if(Grid_getBit(this->pMineGrid, x, y) == bMine)
+    return;
+
+  dDelta = bMine ? 1 : -1;
+  Grid_setBit(this->pMineGrid, x, y, bMine);
+  this->dMines += dDelta;
+
+  // An uninspected tile was counted as safe
+  if(!Grid_getBit(this->pInspectGrid, x, y))
+    this->dSafeLeft -= dDelta;
+
+  // Adjust the neighbours, and count the mines around the tile while we're at it
+  for(j = y - 1; j <= y + 1; j++) {
+    for(i = x - 1; i <= x + 1; i++) {
+      if(i < 0 || i >= this->dWidth || j < 0 || j >= this->dHeight || (i == x && j == y))
+        continue;
+
+      if(Grid_getBit(this->pMineGrid, i, j)) {
+        dCount++;
+      } else {
+        this->aNumbers[j][i] += dDelta;
+        Grid_setBit(this->pZeroGrid, i, j, !this->aNumbers[j][i]);
+      }
     }
   }
+
+  // The tile itself
+  this->aNumbers[y][x] = bMine ? -1 : dCount;
+  Grid_setBit(this->pZeroGrid, x, y, !bMine && !dCount);
 }
 
 /**
@@ -226,6 +502,38 @@ void Field_clearFlags(Field *this) {
   Grid_clear(this->pFlagGrid, 0);
 }
 
+/**
+ * Clears the flags and inspections so the field can be played again.
+ * The mines and numbers are left as they are.
+ * 
+ * @param   { Field * }   this  The field object to modify.
+*/
+void Field_reset(Field *this) {
+  Grid_clear(this->pFlagGrid, 0);
+  Grid_clear(this->pInspectGrid, 0);
+  Field_countSafeLeft(this);
+}
+
+/**
+ * Fills a batch of fields with fresh random boards.
+ * The fields have to be initialized beforehand; they're reused, so nothing gets allocated here.
+ * This is what bots should use when they need a lot of boards quickly.
+ * 
+ * @param   { Field * }   aFields   The fields to fill.
+ * @param   { int }       nFields   How many fields there are.
+ * @param   { int }       dMines    The number of mines on each board.
+ * @param   { Random * }  pRandom   The generator to draw from.
+*/
+void Field_populateBatch(Field *aFields, int nFields, int dMines, Random *pRandom) {
+  int i;
+
+  for(i = 0; i < nFields; i++) {
+    Field_populateRandom(&aFields[i], dMines, pRandom);
+    Field_setNumbers(&aFields[i]);
+    Field_reset(&aFields[i]);
+  }
+}
+
 /**
  * Considers a tile inspected.
  * 
@@ -234,7 +542,186 @@ void Field_clearFlags(Field *this) {
  * @param   { int }       y       The y-coordinate of the tile to be inspected.
 */
 void Field_inspect(Field *pField, int x, int y) {
+
+  // Already inspected, nothing changes
+  if(Grid_getBit(pField->pInspectGrid, x, y))
+    return;
+
   Grid_setBit(pField->pInspectGrid, x, y, 1);
+
+  // One less safe tile to go
+  if(!Grid_getBit(pField->pMineGrid, x, y))
+    pField->dSafeLeft--;
+}
+
+/**
+ * Considers a whole word of tiles inspected at once.
+ * 
+ * @param   { Field * }   this    The field object to modify.
+ * @param   { int }       y       The row of the word.
+ * @param   { int }       w       The index of the word within the row.
+ * @param   { uint64_t }  dMask   The tiles within the word to inspect.
+*/
+void Field_inspectWord(Field *this, int y, int w, uint64_t dMask) {
+  uint64_t *pInspectWord = &Grid_getRow(this->pInspectGrid, y)[w];
+
+  // Only the safe tiles that weren't inspected yet bring the count down
+  this->dSafeLeft -= __builtin_popcountll(dMask & ~*pInspectWord & ~Grid_getRow(this->pMineGrid, y)[w]);
+
+  *pInspectWord |= dMask;
+}
+
+/**
+ * Floods a region through the tiles with no adjacent mines.
+ * The region starts with whatever bits are set on pRegion, and is grown row by row:
+ *    each row takes in the dilation of its neighbouring rows, then spreads along its own runs.
+ * Rows are swept downwards then upwards until a full round changes nothing.
+ * Only the rows near the region are visited, so small openings stay cheap.
+ * The seeds are only looked for between *pTop and *pBottom (the rest of pRegion has to be clear).
+ * Afterwards, *pTop and *pBottom hold the rows the sweeps covered: the flood and the rows 
+ *    right next to it. If nothing was flooded, *pBottom ends up above *pTop.
+ * 
+ * @param   { Field * }   this      The field object to read.
+ * @param   { Grid * }    pRegion   The seeds of the flood, which becomes the flooded region.
+ * @param   { int * }     pTop      The first row that may have seeds; the first row covered.
+ * @param   { int * }     pBottom   The last row that may have seeds; the last row covered.
+*/
+void Field_floodZeros(Field *this, Grid *pRegion, int *pTop, int *pBottom) {
+  int y, w, dDir, bChanged;
+  int dTop = this->dHeight, dBottom = -1;
+  uint64_t dWord, dGrow;
+  uint64_t *pRow, *pZeroRow;
+
+  // Find the rows that have seeds
+  for(y = *pTop > 0 ? *pTop : 0; y <= *pBottom && y < this->dHeight; y++) {
+    pRow = Grid_getRow(pRegion, y);
+
+    for(w = 0; w < pRegion->dStride; w++)
+      pRow[w] &= Grid_getRow(this->pZeroGrid, y)[w];
+
+    for(w = 0; w < pRegion->dStride; w++) {
+      if(pRow[w]) {
+        if(y < dTop) dTop = y;
+        dBottom = y;
+        break;
+      }
+    }
+  }
+
+  *pTop = dTop;
+  *pBottom = dBottom;
+
+  // Nothing to flood
+  if(dBottom < 0)
+    return;
+
+  // The sweeps always cover one row past the region on either side
+  if(dTop > 0) dTop--;
+  if(dBottom < this->dHeight - 1) dBottom++;
+
+  do {
+    bChanged = 0;
+
+    // Sweep down, then up
+    for(dDir = 1; dDir >= -1; dDir -= 2) {
+      for(y = dDir > 0 ? dTop : dBottom; dDir > 0 ? y <= dBottom : y >= dTop; y += dDir) {
+        pRow = Grid_getRow(pRegion, y);
+        pZeroRow = Grid_getRow(this->pZeroGrid, y);
+        dGrow = 0;
+
+        // Take in the dilation of the rows above and below
+        for(w = 0; w < pRegion->dStride; w++) {
+          dWord = 0;
+
+          if(y > 0) dWord |= 
+            Grid_getRow(pRegion, y - 1)[w] | Grid_getWordWest(pRegion, y - 1, w) | Grid_getWordEast(pRegion, y - 1, w);
+          if(y < this->dHeight - 1) dWord |= 
+            Grid_getRow(pRegion, y + 1)[w] | Grid_getWordWest(pRegion, y + 1, w) | Grid_getWordEast(pRegion, y + 1, w);
+
+          dWord &= pZeroRow[w] & ~pRow[w];
+          pRow[w] |= dWord;
+          dGrow |= dWord;
+        }
+
+        // Spread along the row itself
+        if(Grid_fillRow(pRegion, this->pZeroGrid, y))
+          dGrow = 1;
+
+        if(dGrow) {
+          bChanged = 1;
+
+          // The region reached a new row, so the sweeps have to cover its neighbours too
+          if(y == dTop && dTop > 0) dTop--;
+          if(y == dBottom && dBottom < this->dHeight - 1) dBottom++;
+        }
+      }
+    }
+  } while(bChanged);
+
+  *pTop = dTop;
+  *pBottom = dBottom;
+}
+
+/**
+ * Inspects a tile and cascades the inspection through tiles with no adjacent mines.
+ * The cascade is done on the bitboards: the zero tiles reachable from the tile are flooded, 
+ *    and then the flood along with its border is inspected (and unflagged) a word at a time.
+ * The flood happens on the scratch grid of the field, and only the rows it reached are visited.
+ * 
+ * @param   { Field * }     this        The field object to modify.
+ * @param   { int }         x           The tile's x-coordinate in index notation.
+ * @param   { int }         y           The tile's y-coordinate in index notation.
+*/
+void Field_cascade(Field *this, int x, int y) {
+  int w, dRow, dTop, dBottom;
+  uint64_t dMask;
+  Grid *pRegion = this->pScratchGrid;
+
+  // Tiles with adjacent mines don't cascade
+  if(this->aNumbers[y][x] != 0) {
+    Field_inspect(this, x, y);
+    return;
+  }
+
+  // Flood the zero tiles connected to this one
+  dTop = dBottom = y;
+  Grid_setBit(pRegion, x, y, 1);
+  Field_floodZeros(this, pRegion, &dTop, &dBottom);
+
+  // The flood and everything around it gets inspected
+  for(y = dTop; y <= dBottom; y++) {
+    for(w = 0; w < pRegion->dStride; w++) {
+      dMask = 0;
+
+      for(dRow = y - 1; dRow <= y + 1; dRow++)
+        if(dRow >= 0 && dRow < this->dHeight)
+          dMask |= Grid_getRow(pRegion, dRow)[w] | 
+            Grid_getWordWest(pRegion, dRow, w) | 
+            Grid_getWordEast(pRegion, dRow, w);
+
+      // The padding past the width stays clear
+      if(w == pRegion->dStride - 1)
+        dMask &= Grid_getTailMask(pRegion);
+
+      // Remove flags obliterated by inspection
+      Grid_getRow(this->pFlagGrid, y)[w] &= ~dMask;
+      Field_inspectWord(this, y, w, dMask);
+    }
+  }
+
+  // Leave the scratch grid clear for the next cascade
+  for(y = dTop; y <= dBottom; y++)
+    memset(Grid_getRow(pRegion, y), 0, pRegion->dStride * sizeof(uint64_t));
+}
+
+/**
+ * Checks whether or not every safe tile has been inspected.
+ * 
+ * @param   { Field * }   this    The field object to read.
+ * @return  { int }               Whether or not the field has been cleared.
+*/
+int Field_isCleared(Field *this) {
+  return this->dSafeLeft <= 0;
 }
 
 #endif
\ No newline at end of file
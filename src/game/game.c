@@ -11,9 +11,15 @@
 #define GAME_
 
 #include "./field.obj.h"
+#include "./generator.game.c"
+#include "./history.obj.h"
+#include "./movelog.obj.h"
+#include "./probability.game.c"
 #include "./profile.game.c"
 
+#include "../utils/utils.buffer.h"
 #include "../utils/utils.grid.h"
+#include "../utils/utils.random.h"
 #include "../utils/utils.types.h"
 #include "../utils/utils.string.h"
 
@@ -88,12 +94,24 @@ struct Game {
   char sSaveName[LEVELS_MAX_NAME_LENGTH + 1];   // Used when editing a grid
   char sTimestamp[32];                          // Timestamp of last finished game
   
-  int dPauseOffset;                             // How many seconds paused in total
+  int dPauseOffset;                             // How many seconds the clock skips (pauses and undone moves)
   int dCursorX, dCursorY;                       // The cursor of the player
   int dLastX, dLastY;                           // Indicator for exploded mine
   int dFrameCount, dLastFPS;                    // FPS counter
   int dTimeTaken;
   int bIsSaved;                                 // Has the game been saved (not for editing)
+  GameOutcome eSavedOutcome;                    // The ending that went into the stats, once it's saved
+  uint64_t dSeed;                               // The seed of the board, so it can be generated again
+  int bIsGenerated;                             // Classic boards are only made on the first inspect
+  int bIsGenerating;                            // The first inspect is waiting on a no-guess board from the pool
+  int dFirstX, dFirstY;                         // Where that first inspect goes
+  int bNoGuess;                                 // Whether the board should be solvable without guessing
+  Generator *pGenerator;                        // Keeps no-guess boards ready; this may be NULL
+  Probability *pProbability;                    // Works out the chance of a mine under the cursor; this may be NULL
+  int bChancesStale;                            // Whether the field changed since the chances were posted
+  int bChancesPending;                          // Whether the page is showing chances that have since gone stale
+  History history;                              // Every move made so far, so they can be undone
+  MoveLog log;                                  // Every action of the game, so it can be replayed
   
   time_t startTime, endTime;                    // Used for computing the time
   time_t pauseStartTime, pauseEndTime;          // Used for accounting for pauses
@@ -135,40 +153,235 @@ void Game_setup(Game *this, GameType eGameType, GameDifficulty eGameDifficulty)
   this->dPauseOffset = 0;
   this->dTimeTaken = 0;
   this->bIsSaved = 0;
+  this->eSavedOutcome = GAME_OUTCOME_PENDING;
+
+  // Every new game gets its own board
+  this->dSeed = Random_makeSeed();
+  this->bIsGenerated = 0;
+  this->bIsGenerating = 0;
+  this->bChancesPending = 0;
+  this->bNoGuess = 0;
 
   // CLear the save name first
   String_clear(LEVELS_MAX_NAME_LENGTH + 1, this->sSaveName);
   String_clear(32, this->sTimestamp);
 }
 
+/**
+ * Overrides the seed of the board.
+ * Call this between Game_setup() and Game_init() to replay a specific board.
+ * 
+ * @param   { Game * }    this    The game object.
+ * @param   { uint64_t }  dSeed   The seed to use.
+*/
+void Game_setSeed(Game *this, uint64_t dSeed) {
+  this->dSeed = dSeed;
+}
+
+/**
+ * Makes the board of a classic game solvable without guessing.
+ * Call this between Game_setup() and Game_init().
+ * 
+ * @param   { Game * }  this        The game object.
+ * @param   { int }     bNoGuess    Whether or not to guarantee a no-guess board.
+*/
+void Game_setNoGuess(Game *this, int bNoGuess) {
+  this->bNoGuess = bNoGuess;
+}
+
+/**
+ * Reads the parts of the game the history keeps track of.
+ * 
+ * @param   { Game * }            this      The game object.
+ * @param   { HistoryState * }    pState    Where to store the state.
+*/
+void Game_getState(Game *this, HistoryState *pState) {
+  time_t now;
+
+  time(&now);
+
+  pState->dCursorX = this->dCursorX;
+  pState->dCursorY = this->dCursorY;
+  pState->dLastX = this->dLastX;
+  pState->dLastY = this->dLastY;
+  pState->dSafeLeft = this->field.dSafeLeft;
+  pState->dTime = round(difftime(now, this->startTime)) - this->dPauseOffset;
+  pState->dOutcome = this->eOutcome;
+  pState->bIsGenerated = this->bIsGenerated;
+}
+
+/**
+ * Adds the last move to the history of the game.
+ * Moves that didn't change anything aren't kept.
+ * 
+ * @param   { Game * }  this  The game object.
+*/
+void Game_record(Game *this) {
+  HistoryState state;
+
+  Game_getState(this, &state);
+  History_commit(&this->history, &this->field, &state);
+}
+
+/**
+ * Puts the game back to the way it was after a move in its history.
+ * The clock goes back to when the move was made, so the time spent on undone moves doesn't count.
+ * The save state stays too, since only the first ending of a game goes into the stats (see Game_save()).
+ * 
+ * @param   { Game * }            this    The game object.
+ * @param   { HistoryState * }    pState  The state to go back to. If NULL, nothing happens.
+ * @return  { int }                       Whether or not the game changed.
+*/
+int Game_restore(Game *this, HistoryState *pState) {
+  if(pState == NULL)
+    return 0;
+
+  // Wind the clock back by skipping the seconds since the move
+  time(&this->endTime);
+  this->dPauseOffset = round(difftime(this->endTime, this->startTime)) - pState->dTime;
+
+  this->dCursorX = pState->dCursorX;
+  this->dCursorY = pState->dCursorY;
+  this->dLastX = pState->dLastX;
+  this->dLastY = pState->dLastY;
+  this->eOutcome = pState->dOutcome;
+  this->bIsGenerated = pState->bIsGenerated;
+  this->bChancesStale = 1;
+
+  return 1;
+}
+
+/**
+ * Takes back the last move.
+ * 
+ * @param   { Game * }  this  The game object.
+ * @return  { int }           Whether or not there was a move to take back.
+*/
+int Game_undo(Game *this) {
+  if(!Game_restore(this, History_undo(&this->history, &this->field)))
+    return 0;
+
+  MoveLog_add(&this->log, MOVELOG_ACTION_UNDO);
+  return 1;
+}
+
+/**
+ * Makes the last move that was taken back again.
+ * 
+ * @param   { Game * }  this  The game object.
+ * @return  { int }           Whether or not there was a move to make again.
+*/
+int Game_redo(Game *this) {
+  if(!Game_restore(this, History_redo(&this->history, &this->field)))
+    return 0;
+
+  MoveLog_add(&this->log, MOVELOG_ACTION_REDO);
+  return 1;
+}
+
 /**
  * Sets up the field of the game based on the type and the difficulty.
  * 
  * @param   { Game * }  this  The game object to set up.
 */
 void Game_init(Game *this) {
+  HistoryState state;
 
   // Classic mode
+  // The mines aren't placed until the first inspect, so that it can never be a mine
   if(this->eType == GAME_TYPE_CLASSIC) {
+    this->bIsGenerated = 0;
 
     // For easy mode
     if(this->eDifficulty == GAME_DIFFICULTY_EASY) {
         
-      // Sets up the field's width and height and populate with mines
+      // Sets up the field's width and height
       Field_init(&this->field, GAME_EASY_COLUMNS, GAME_EASY_ROWS);
-      Field_populateRandom(&this->field, GAME_EASY_MINES);
+      this->field.dMines = GAME_EASY_MINES;
     
     // For difficult mode
     } else {
 
-      // Sets up the field's width and height and populate with mines
+      // Sets up the field's width and height
       Field_init(&this->field, GAME_DIFFICULT_COLUMNS, GAME_DIFFICULT_ROWS);
-      Field_populateRandom(&this->field, GAME_DIFFICULT_MINES);
+      this->field.dMines = GAME_DIFFICULT_MINES;
     }
+
+  // Custom levels come with their mines
+  } else {
+    this->bIsGenerated = 1;
   }
 
   // Compute the numbers for the field
   Field_setNumbers(&this->field);
+  this->bChancesStale = 1;
+
+  // Moves are recorded from here on
+  Game_getState(this, &state);
+  History_start(&this->history, &this->field, &state);
+  MoveLog_start(&this->log, this->eType, this->eDifficulty, &this->field, 
+    this->eType == GAME_TYPE_CLASSIC, this->dSeed);
+}
+
+/**
+ * Places the mines of a classic game around its first inspect.
+ * The tile and its neighbours never get mines. In no-guess mode, the board also has to be 
+ *    solvable from that tile, so we take a seed from the generator's pool. If the pool for that 
+ *    tile is empty, we ask the workers for one and leave the board for later, so the caller never 
+ *    waits on a search. Without a pool (like in the simulator), we search for one here, and if the 
+ *    search runs out, the game stops being a no-guess game.
+ * 
+ * @param   { Game * }  this  The game object.
+ * @param   { int }     x     The x-coordinate of the first inspect.
+ * @param   { int }     y     The y-coordinate of the first inspect.
+ * @return  { int }           Whether or not the board was made; if not, the workers are looking for it.
+*/
+int Game_generate(Game *this, int x, int y) {
+  Field *pField = &this->field;
+  Grid *pFlags;
+  uint64_t dSeed = 0, dLastSeed = this->dSeed;
+  int dMines = pField->dMines, dKind = -1;
+
+  if(this->bNoGuess && this->pGenerator != NULL)
+    dKind = Generator_findKind(this->pGenerator, pField->dWidth, pField->dHeight, dMines);
+
+  // The pool should almost always have one; if not, the page checks back once the workers find it
+  if(this->bNoGuess && dKind >= 0) {
+    dSeed = Generator_take(this->pGenerator, dKind, x, y);
+
+    if(!dSeed) {
+      Generator_request(this->pGenerator, dKind, x, y);
+      return 0;
+    }
+  }
+
+  // Building boards wipes the flags, so keep the ones placed before the first inspect
+  pFlags = Grid_create(pField->dWidth, pField->dHeight);
+  Grid_copy(pFlags, pField->pFlagGrid);
+
+  // Nothing keeps a pool for this board, so find one ourselves
+  if(this->bNoGuess && dKind < 0) {
+    dSeed = Generator_search(pField, this->dSeed, dMines, x, y);
+
+    // Don't call it a no-guess game when it isn't one
+    if(!dSeed)
+      this->bNoGuess = 0;
+  }
+
+  if(dSeed)
+    this->dSeed = dSeed;
+
+  // Replays don't search, so they have to be told which board was found
+  if(this->dSeed != dLastSeed)
+    MoveLog_addSeed(&this->log, this->dSeed);
+
+  // The board only depends on the seed and the first inspect
+  Generator_build(pField, this->dSeed, dMines, x, y);
+  Grid_copy(pField->pFlagGrid, pFlags);
+  Grid_kill(pFlags);
+
+  this->bIsGenerated = 1;
+  return 1;
 }
 
 /**
@@ -203,31 +416,22 @@ void Game_clear(Game *this) {
  * @return  { int }           Whether or not the player has finished the game.
 */
 int Game_hasWon(Game *this) {
-  int x, y;
+  int y, w;
+  uint64_t *pFlagRow, *pMineRow;
 
   // Check if all non-mine cells have been inspected
-  // OR if there are flags that aren't mines
-  for(x = 0; x < this->field.dWidth; x++) {
-    for(y = 0; y < this->field.dHeight; y++) {
-      
-      // If it hasn't been inspected, and it doesn't have a mine
-      if(!Grid_getBit(this->field.pInspectGrid, x, y) &&
-        !Grid_getBit(this->field.pMineGrid, x, y)) {
-        
-        // User hasn't won
-        return 0;
-      }
-    } 
-  }
+  // The field keeps a running count of these, so there's no need to scan
+  if(!Field_isCleared(&this->field))
+    return 0;
 
   // The user has already won, so place flags on all mines
-  for(x = 0; x < this->field.dWidth; x++) {
-    for(y = 0; y < this->field.dHeight; y++) {
-      
-      // Place a flag if it has a mine
-      if(Grid_getBit(this->field.pMineGrid, x, y))
-        Grid_setBit(this->field.pFlagGrid, x, y, 1);
-    } 
+  for(y = 0; y < this->field.dHeight; y++) {
+    pFlagRow = Grid_getRow(this->field.pFlagGrid, y);
+    pMineRow = Grid_getRow(this->field.pMineGrid, y);
+
+    // Place a flag wherever there's a mine, a word at a time
+    for(w = 0; w < this->field.pFlagGrid->dStride; w++)
+      pFlagRow[w] |= pMineRow[w];
   }
 
   // All checks were passed
@@ -245,114 +449,146 @@ int Game_isWon(Game *this) {
 }
 
 /**
- * Creates a display of the grid as a text asset.
+ * Copies a glyph to where the cursor is, then moves the cursor past it.
  * 
- * @param   { Game * }   this   The field object to display.
- * @return  { char * }          The text asset representing the grid.
+ * @param   { char * }  sCursor   Where to write the glyph.
+ * @param   { char * }  sGlyph    The glyph to write (box-drawing characters take up more than one byte).
+ * @return  { char * }            Where the next glyph goes.
 */
-void Game_displayGrid(Game *this, char *sOutputBuffer) {
-  int x, y, i, dNumber;
+char *Game_writeGlyph(char *sCursor, char *sGlyph) {
+  while(*sGlyph)
+    *(sCursor++) = *(sGlyph++);
+
+  return sCursor;
+}
 
-  // The actual field
-  // Don't mind why this is a pointer, it didn't have to be LMAO
+/**
+ * Picks the glyph at one spot of a tile, so the text display and the tiles drawn on screen always agree.
+ * Each tile owns its top and left borders; the column past the last tile and the row past the last row close off the grid.
+ * 
+ * @param   { Game * }  this      The game to display.
+ * @param   { int }     dTileX    The column of the tile, up to the width of the field.
+ * @param   { int }     dTileY    The row of the tile, up to the height of the field.
+ * @param   { int }     dColumn   The spot within the tile, from 0 to GAME_CELL_WIDTH - 1.
+ * @param   { int }     dLine     The spot within the tile, from 0 to GAME_CELL_HEIGHT - 1.
+ * @return  { char * }            The glyph to put there (box-drawing characters take up more than one byte).
+*/
+char *Game_getTileGlyph(Game *this, int dTileX, int dTileY, int dColumn, int dLine) {
   Field *pField = &this->field;
+  char *aNumbers[] = { "X", ".", "1", "2", "3", "4", "5", "6", "7", "8" };
+  int bIsLeft = !dTileX, bIsRight = dTileX == pField->dWidth;
 
-  // Some important consts
-  int dWidth = pField->dWidth;
-  int dHeight = pField->dHeight;
-  char *sNumberText = calloc(4, 1);
-
-  // For each row
-  for(y = 0; y < dHeight; y++) {
-    for(i = 0; i < 2; i++) {
-      
-      // For each cell in the row
-      for(x = 0; x < dWidth; x++) {
-
-        // The number to be shown
-        dNumber = this->field.aNumbers[y][x];
-        dNumber = dNumber < 0 ? 'X' : dNumber + 48;   // X for mines
-        dNumber = dNumber == 48 ? '.' : dNumber;      // Add a dot for 0's
-
-        // If the cell hasn't been inspected, turn it into a space
-        if(!Grid_getBit(this->field.pInspectGrid, x, y))
-          dNumber = 32;
-
-        // Create the text displaying the number
-        sprintf(sNumberText, "| %c ", dNumber);
-
-        // If upper left corner
-        if(!y && !x) {
-          switch(i) {
-            case 0: strcat(sOutputBuffer, "╔───"); break;
-            case 1: strcat(sOutputBuffer, sNumberText); break;
-          }
-        
-        // Top edge
-        } else if(!y && x) {
-          switch(i) {
-            case 0: strcat(sOutputBuffer, "╦───"); break;
-            case 1: strcat(sOutputBuffer, sNumberText); break;
-          }
-
-        // Center pieces
-        } else if(y && x) {
-          switch(i) {
-            case 0: strcat(sOutputBuffer, "╬───"); break;
-            case 1: strcat(sOutputBuffer, sNumberText); break;
-          }
-          
-        // Left edge
-        } else {
-          switch(i) {
-            case 0: strcat(sOutputBuffer, "╠───"); break;
-            case 1: strcat(sOutputBuffer, sNumberText); break;
-          }
-        }
-      } 
-
-      // Upper right corner
-      if(!y) {
-        switch(i) {
-          case 0: strcat(sOutputBuffer, "╗"); break;
-          case 1: strcat(sOutputBuffer, "│"); break;
-        }
-
-      // Right edge
-      } else {
-        switch(i) {
-          case 0: strcat(sOutputBuffer, "╣"); break;
-          case 1: strcat(sOutputBuffer, "│"); break;
-        }
-      }
+  // The corners and the borders between them
+  if(!dLine) {
+    if(dColumn)
+      return "─";
 
-      strcat(sOutputBuffer, "\n");
-    }
+    if(!dTileY)
+      return bIsLeft ? "╔" : bIsRight ? "╗" : "╦";
+    if(dTileY == pField->dHeight)
+      return bIsLeft ? "╚" : bIsRight ? "╝" : "╩";
+
+    return bIsLeft ? "╠" : bIsRight ? "╣" : "╬";
+  }
+
+  // The walls between the numbers
+  if(!dColumn)
+    return bIsRight ? "│" : "|";
+
+  // X for mines, a dot for 0's, and nothing for tiles that haven't been inspected
+  if(dColumn == GAME_CELL_WIDTH / 2 && Grid_getBit(pField->pInspectGrid, dTileX, dTileY))
+    return aNumbers[pField->aNumbers[dTileY][dTileX] < 0 ? 0 : pField->aNumbers[dTileY][dTileX] + 1];
+
+  return " ";
+}
+
+/**
+ * Writes a single line of the grid display, without a newline or a null terminator.
+ * Even lines are the borders above each row of tiles, odd lines hold the numbers, and the last line is the bottom edge.
+ * 
+ * @param   { Game * }  this      The game to display.
+ * @param   { char * }  sCursor   Where to start writing the line.
+ * @param   { int }     dLine     The line to write, from 0 to Game_getCharHeight() - 1.
+ * @return  { char * }            Where the line ends.
+*/
+char *Game_writeGridLine(Game *this, char *sCursor, int dLine) {
+  Field *pField = &this->field;
+  int x, i, y = dLine / GAME_CELL_HEIGHT;
+
+  for(x = 0; x < pField->dWidth; x++)
+    for(i = 0; i < GAME_CELL_WIDTH; i++)
+      sCursor = Game_writeGlyph(sCursor, Game_getTileGlyph(this, x, y, i, dLine % GAME_CELL_HEIGHT));
+
+  // The right edge
+  return Game_writeGlyph(sCursor, Game_getTileGlyph(this, x, y, 0, dLine % GAME_CELL_HEIGHT));
+}
+
+/**
+ * Creates a display of the grid as text, with a newline after each line.
+ * This is done in a single pass; the buffer has to fit Game_getCharWidth() * Game_getCharHeight() * 4 bytes.
+ * Whatever was in the buffer is overwritten.
+ * 
+ * @param   { Game * }  this            The game to display.
+ * @param   { char * }  sOutputBuffer   Where to write the display.
+*/
+void Game_displayGrid(Game *this, char *sOutputBuffer) {
+  int i, dHeight = this->field.dHeight * GAME_CELL_HEIGHT + 1;
+
+  for(i = 0; i < dHeight; i++) {
+    sOutputBuffer = Game_writeGridLine(this, sOutputBuffer, i);
+    *(sOutputBuffer++) = '\n';
   }
 
-  // Bottom edge
-  for(x = 0; x < dWidth; x++) {
-    for(i = 0; i < 4; i++) {
-
-      // Bottom right corner
-      if(x == dWidth - 1 && i == 3) strcat(sOutputBuffer, "─╝");
-
-      // Bottom left corner
-      else if(!x && !i) strcat(sOutputBuffer, "╚");
-      
-      // Bottom edge
-      else if(!i) strcat(sOutputBuffer, "╩");
-      
-      // Everything else
-      else strcat(sOutputBuffer, "─");
+  *sOutputBuffer = 0;
+}
+
+/**
+ * Draws the borders and the number of a single tile onto a buffer.
+ * Each tile draws its top and left borders, so the last column and row also close off the grid.
+ * The glyphs go straight into the cells of the buffer; blank parts of the tile are left alone, like when writing an asset.
+ * 
+ * @param   { Game * }    this      The game to display.
+ * @param   { Buffer * }  pBuffer   The buffer to draw on.
+ * @param   { int }       x         Where the top left corner of the tile goes in the buffer.
+ * @param   { int }       y         Where the top left corner of the tile goes in the buffer.
+ * @param   { int }       dTileX    The column of the tile.
+ * @param   { int }       dTileY    The row of the tile.
+*/
+void Game_drawTile(Game *this, Buffer *pBuffer, int x, int y, int dTileX, int dTileY) {
+  Field *pField = &this->field;
+  int i, j, k, dWidth, dHeight;
+  char *sGlyph, *cCell;
+
+  // Only the last column and row close off the grid
+  dWidth = dTileX == pField->dWidth - 1 ? GAME_CELL_WIDTH + 1 : GAME_CELL_WIDTH;
+  dHeight = dTileY == pField->dHeight - 1 ? GAME_CELL_HEIGHT + 1 : GAME_CELL_HEIGHT;
+
+  for(i = 0; i < dHeight; i++) {
+
+    // Tiles may hang off the edges of the buffer
+    if(y + i < 0 || y + i >= pBuffer->dHeight)
+      continue;
+
+    for(j = 0; j < dWidth; j++) {
+      if(x + j < 0 || x + j >= pBuffer->dWidth)
+        continue;
+
+      sGlyph = Game_getTileGlyph(this, 
+        dTileX + j / GAME_CELL_WIDTH, dTileY + i / GAME_CELL_HEIGHT, j % GAME_CELL_WIDTH, i % GAME_CELL_HEIGHT);
+      cCell = pBuffer->cContentArray[y + i][x + j];
+
+      // Single byte glyphs only take the first byte of the cell, the same way Buffer_write() does it
+      if(String_isChar(*sGlyph)) {
+        if(*sGlyph != 32)
+          cCell[0] = *sGlyph;
+
+      // Box-drawing characters fill the cell, with zeroes after the last byte
+      } else {
+        for(k = 0; k < 4; k++)
+          cCell[k] = *sGlyph ? *(sGlyph++) : 0;
+      }
     }
   }
-  
-  // Last newline
-  strcat(sOutputBuffer, "\n");
-  
-  // Free the text
-  free(sNumberText);
 }
 
 /**
@@ -363,14 +599,25 @@ void Game_displayGrid(Game *this, char *sOutputBuffer) {
  * @param   { int }         y           The tile's y-coordinate in index notation.
 */
 void Game_inspect(Game *this, int x, int y) {
-  int i, j;
-
   Field *pField = &this->field;
 
   // If there is a flag there, don't inspect it
   if(Grid_getBit(pField->pFlagGrid, x, y))
     return;
 
+  // The board is made on the first inspect; no-guess boards might have to be waited on
+  if(this->bIsGenerating)
+    return;
+
+  if(!this->bIsGenerated && !Game_generate(this, x, y)) {
+    this->bIsGenerating = 1;
+    this->dFirstX = x;
+    this->dFirstY = y;
+    return;
+  }
+
+  MoveLog_addTile(&this->log, MOVELOG_ACTION_INSPECT, x, y);
+
   // Checks if a mine has been inspected
   if(Grid_getBit(pField->pMineGrid, x, y)) {
 
@@ -380,47 +627,69 @@ void Game_inspect(Game *this, int x, int y) {
 
     // Ends the game
     Game_end(this, GAME_OUTCOME_LOSS);
+    Game_record(this);
 
     return;
   }
   
-  // Considers the specific tile inspected
-  Field_inspect(pField, x, y);
-
-  // Cascades the inspection if the number on the tile is 0
-  if(pField->aNumbers[y][x] == 0) {
-
-    // The following loops check each adjacent tile within bounds of the field
-    // Loops through each row
-    for(i = x - 1; i <= x + 1; i++) {
-      if(i >= 0 && i <= pField->dWidth - 1) {
-
-        // Loops through each column
-        for(j = y - 1; j <= y + 1; j++) {
-          if(j >= 0 && j <= pField->dHeight - 1) {
-            
-            // Remove flags obliterated by inspection
-            Grid_setBit(this->field.pFlagGrid, i, j, 0);
-
-            // Recurses the function if the number on the tile is 0
-            // only when it hasn't been inspected
-            if(!pField->aNumbers[j][i] && 
-              !Grid_getBit(pField->pInspectGrid, i, j))
-              Game_inspect(this, i, j);
-
-            // Marks the tile as inspected
-            if(pField->aNumbers[j][i] >= 0)
-              Field_inspect(pField, i, j);
-
-          }
-        }
-      }
-    }
-  }
+  // Inspect the tile and everything it opens up
+  Field_cascade(pField, x, y);
+  this->bChancesStale = 1;
 
   // The user has cleared the board
   if(Game_hasWon(this))
     this->eOutcome = GAME_OUTCOME_WIN;
+
+  Game_record(this);
+}
+
+/**
+ * Makes the first inspect once the no-guess board it was waiting on is ready.
+ * Pages call this whenever they draw a frame; it never waits on the workers.
+ * 
+ * @param   { Game * }  this  The game object.
+ * @return  { int }           Whether or not the game stopped waiting just now.
+*/
+int Game_resume(Game *this) {
+  if(!this->bIsGenerating)
+    return 0;
+
+  this->bIsGenerating = 0;
+  Game_inspect(this, this->dFirstX, this->dFirstY);
+
+  return !this->bIsGenerating;
+}
+
+/**
+ * Returns whether the first inspect is still waiting on a no-guess board.
+ * 
+ * @param   { Game * }  this  The game object.
+ * @return  { int }           Whether or not the board is still being looked for.
+*/
+int Game_isGenerating(Game *this) {
+  return this->bIsGenerating;
+}
+
+/**
+ * Checks whether something the game was waiting on came in from the background, so the page 
+ *    only has to be drawn again when there's actually something new to show.
+ * 
+ * @param   { Game * }  this  The game object.
+ * @return  { int }           Whether or not the page should be drawn again.
+*/
+int Game_hasNews(Game *this) {
+  Field *pField = &this->field;
+
+  if(this->bIsGenerating)
+    return Generator_isReady(this->pGenerator, 
+      Generator_findKind(this->pGenerator, pField->dWidth, pField->dHeight, pField->dMines), 
+      this->dFirstX, this->dFirstY);
+
+  // The chances on screen are stale, and the new ones are in
+  if(this->bChancesPending)
+    return Probability_isDone(this->pProbability);
+
+  return 0;
 }
 
 /**
@@ -429,8 +698,13 @@ void Game_inspect(Game *this, int x, int y) {
  * @param   { Game * }     this     The game object to be modified.
 */
 void Game_addFlag (Game *this) {
-  if(!Grid_getBit(this->field.pInspectGrid, this->dCursorX, this->dCursorY))
+  if(!Grid_getBit(this->field.pInspectGrid, this->dCursorX, this->dCursorY)) {
     Grid_setBit(this->field.pFlagGrid, this->dCursorX, this->dCursorY, 1);
+    MoveLog_addTile(&this->log, MOVELOG_ACTION_FLAG, this->dCursorX, this->dCursorY);
+  }
+
+  this->bChancesStale = 1;
+  Game_record(this);
 }
 
 /**
@@ -439,8 +713,13 @@ void Game_addFlag (Game *this) {
  * @param   { Game * }      this      The game object to be modified.
 */
 void Game_removeFlag(Game *this) {
-  if(Grid_getBit(this->field.pFlagGrid, this->dCursorX, this->dCursorY))
+  if(Grid_getBit(this->field.pFlagGrid, this->dCursorX, this->dCursorY)) {
     Grid_setBit(this->field.pFlagGrid, this->dCursorX, this->dCursorY, 0);
+    MoveLog_addTile(&this->log, MOVELOG_ACTION_UNFLAG, this->dCursorX, this->dCursorY);
+  }
+
+  this->bChancesStale = 1;
+  Game_record(this);
 }
 
 /**
@@ -450,6 +729,7 @@ void Game_removeFlag(Game *this) {
 */
 void Game_pause(Game *this) {
   time(&this->pauseStartTime);
+  MoveLog_add(&this->log, MOVELOG_ACTION_PAUSE);
 }
 
 /**
@@ -459,6 +739,7 @@ void Game_pause(Game *this) {
 */
 void Game_unpause(Game *this) {
   time(&this->pauseEndTime);
+  MoveLog_add(&this->log, MOVELOG_ACTION_PAUSE);
 
   this->dPauseOffset += difftime(this->pauseEndTime, this->pauseStartTime);
 }
@@ -570,12 +851,12 @@ int Game_isDone(Game *this) {
 }
 
 /**
- * Returns the time elapsed since the game started.
+ * Returns the number of seconds elapsed since the game started, without the pauses.
  * 
  * @param   { Game * }   this   The game object to read.
- * @return  { char * }          A string describing the time elapsed.
+ * @return  { int }             The seconds elapsed.
 */
-char *Game_getTime(Game *this) {
+int Game_getTimeTaken(Game *this) {
 
   // Update the timer ONLY if not done
   if(!Game_isDone(this))
@@ -584,8 +865,19 @@ char *Game_getTime(Game *this) {
   // Get the difference between the times
   this->dTimeTaken = round(difftime(this->endTime, this->startTime)) - this->dPauseOffset;
 
+  return this->dTimeTaken;
+}
+
+/**
+ * Returns the time elapsed since the game started.
+ * 
+ * @param   { Game * }   this   The game object to read.
+ * @return  { char * }          A string describing the time elapsed.
+*/
+char *Game_getTime(Game *this) {
+
   // Return the formatted string
-  return String_formatSecs(this->dTimeTaken);
+  return String_formatSecs(Game_getTimeTaken(this));
 }
 
 /**
@@ -604,6 +896,62 @@ char *Game_getMinesLeft(Game *this) {
   return sMineString;
 }
 
+/**
+ * Returns the chance that the tile under the cursor hides a mine, going only by what the player can see.
+ * The chances are only worked out again after the field changes, and that happens in the background;
+ *    until the new ones are in, the last ones are shown and marked as stale.
+ * 
+ * @param   { Game * }   this   The game object to read.
+ * @return  { char * }          A string describing the chance.
+*/
+char *Game_getChance(Game *this) {
+  char *sChanceString = String_alloc(16);
+  double dChance;
+  int bIsStale;
+
+  this->bChancesPending = 0;
+
+  // Nothing to go by yet, or nothing left to guess
+  if(this->pProbability == NULL || !this->bIsGenerated || Game_isDone(this)) {
+    sprintf(sChanceString, "-");
+    return sChanceString;
+  }
+
+  if(this->bChancesStale) {
+    Probability_post(this->pProbability, &this->field);
+    this->bChancesStale = 0;
+  }
+
+  dChance = Probability_read(this->pProbability, this->dCursorX, this->dCursorY, &bIsStale);
+
+  // The page gets drawn again once the new chances are in
+  this->bChancesPending = bIsStale;
+
+  // Inspected and flagged tiles don't have one
+  if(dChance < 0)
+    sprintf(sChanceString, bIsStale ? "..." : "-");
+  else
+    sprintf(sChanceString, bIsStale ? "%.1f%% (stale)" : "%.1f%%", dChance * 100);
+
+  return sChanceString;
+}
+
+/**
+ * Describes the board being played, including whether it's still being looked for.
+ * 
+ * @param   { Game * }   this   The game object to read.
+ * @return  { char * }          A string describing the board.
+*/
+char *Game_getMode(Game *this) {
+  if(this->bIsGenerating)
+    return "generating...";
+
+  if(this->eType == GAME_TYPE_CUSTOM)
+    return "custom";
+
+  return this->bNoGuess ? "no-guess" : "classic";
+}
+
 /**
  * Returns how many fps the game is running at.
  * Default is 32.
@@ -646,17 +994,33 @@ void Game_quit(Game *this) {
   this->eOutcome = GAME_OUTCOME_QUIT;
 }
 
+/**
+ * Ends the move log of the game with its outcome and time.
+ * Call this once the game is over, before saving the log.
+ * 
+ * @param   { Game * }  this  The game object.
+*/
+void Game_closeLog(Game *this) {
+  MoveLog_end(&this->log, this->eOutcome, Game_getTimeTaken(this));
+}
+
 /**
  * "Saves" the current game.
  * Sets the save state to 1.
  * Also updates the timestamp.
+ * A game is only saved once: the first ending it reaches is the one that counts, even if it's undone later on.
  * 
  * @param   { Game * }  this  The game object.
+ * @return  { int }           Whether or not the game had already been saved.
 */
 int Game_save(Game *this) {
   int dLastState = this->bIsSaved;
   time_t timestamp;
 
+  // The timestamp belongs to the ending that was saved
+  if(dLastState)
+    return dLastState;
+
   // Update timestamp
   time(&timestamp);
   sprintf(this->sTimestamp, "%s", ctime(&timestamp));
@@ -666,9 +1030,21 @@ int Game_save(Game *this) {
 
   // Saved
   this->bIsSaved = 1;
+  this->eSavedOutcome = this->eOutcome;
   return dLastState;
 }
 
+/**
+ * Checks whether the way the game ended is the one in the stats.
+ * It isn't when the player undoes a saved ending and finishes the game some other way.
+ * 
+ * @param   { Game * }  this  The game object.
+ * @return  { int }           Whether or not the current ending was recorded.
+*/
+int Game_isRecorded(Game *this) {
+  return this->bIsSaved && this->eSavedOutcome == this->eOutcome;
+}
+
 /**
  * Returns a description of how the game ended.
  * 
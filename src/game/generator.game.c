@@ -0,0 +1,491 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 11:58:02
+ * @ Modified time: 2026-10-16 11:58:02
+ * @ Description:
+ *
+ * Generates boards that can be cleared without guessing.
+ * Finding one takes a lot of tries, so worker threads keep a pool of them ready in the background.
+ * A board is fully described by its seed and its first click, so the pool only ever stores seeds:
+ *    for every kind of board and every tile of it, we keep a few seeds that are solvable from that tile.
+ * When a game needs a tile whose pool ran dry, it asks for it with Generator_request() instead of waiting;
+ *    the workers put that tile first and raise the ready signal once there's a seed for it.
+ */
+
+#ifndef GAME_GENERATOR_
+#define GAME_GENERATOR_
+
+#include "./field.obj.h"
+#include "./solver.game.c"
+
+#include "../utils/utils.random.h"
+#include "../utils/utils.thread.h"
+#include "../utils/utils.types.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define GENERATOR_MAX_KINDS 4                     // The number of board sizes we can keep pools for
+#define GENERATOR_WORKERS 2                       // The number of threads filling the pools
+#define GENERATOR_POOL_DEPTH 2                    // How many seeds we keep ready for each first click
+#define GENERATOR_ATTEMPTS_PER_TICK (1 << 6)      // How many boards a worker tries before letting go of the cpu
+#define GENERATOR_ATTEMPTS_BLOCKING (1 << 9)      // How many boards we try when the pool doesn't have one
+#define GENERATOR_SLEEP 1000                      // How long a worker sleeps once the pools are full (in ms)
+
+#define GENERATOR_POOL_MUTEX "generator-pool-mutex"
+#define GENERATOR_WORKER_MUTEX "generator-worker-mutex"
+#define GENERATOR_WORKER_THREAD "generator-worker-thread"
+#define GENERATOR_WORKER_SIGNAL "generator-worker-signal"
+
+typedef struct GeneratorKind GeneratorKind;
+typedef struct Generator Generator;
+
+/**
+ * //
+ * ////
+ * //////    Generator struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * A kind of board we keep a pool for.
+ *
+ * @struct
+*/
+struct GeneratorKind {
+  int dWidth;                                     // The width of the board
+  int dHeight;                                    // The height of the board
+  int dMines;                                     // The number of mines on the board
+
+  uint64_t *aSeeds;                               // GENERATOR_POOL_DEPTH seeds for every first click
+  int *aCounts;                                   // How many seeds each first click has ready
+  int dWanted;                                    // The first click a game is waiting on, or -1
+};
+
+/**
+ * The generator keeps the pools and the state of its workers.
+ *
+ * @struct
+*/
+struct Generator {
+  ThreadManager *pThreadManager;                  // Where the worker threads and the pool mutex live
+
+  GeneratorKind aKinds[GENERATOR_MAX_KINDS];      // The boards we keep pools for
+  int nKinds;
+
+  Random aRandoms[GENERATOR_WORKERS];             // Each worker draws its own seeds
+  Field aScratch[GENERATOR_WORKERS][GENERATOR_MAX_KINDS];   // Where each worker tries out boards
+
+  Signal *aWakeSignals[GENERATOR_WORKERS];        // Wakes each worker up when a seed is taken from the pools
+  long aSleeps[GENERATOR_WORKERS];                // How long each worker currently sleeps between ticks (in ms)
+  Signal *pReadySignal;                           // Raised when a requested seed comes in; this may be NULL
+
+  int bIsRunning;                                 // Whether or not the workers have been started
+};
+
+/**
+ * Initializes the generator.
+ * The workers don't start until Generator_start() is called.
+ *
+ * @param   { Generator * }       this              The generator to initialize.
+ * @param   { ThreadManager * }   pThreadManager    The thread manager to create the workers with.
+*/
+void Generator_init(Generator *this, ThreadManager *pThreadManager) {
+  int i;
+
+  this->pThreadManager = pThreadManager;
+  this->nKinds = 0;
+  this->bIsRunning = 0;
+  this->pReadySignal = NULL;
+
+  for(i = 0; i < GENERATOR_WORKERS; i++) {
+    Random_seed(&this->aRandoms[i], Random_makeSeed());
+    this->aWakeSignals[i] = NULL;
+    this->aSleeps[i] = THREAD_TIMEOUT;
+  }
+}
+
+/**
+ * Stops the workers and frees the pools.
+ * This has to be called before the thread manager exits, since it waits on the workers' mutexes.
+ * The signals are left alone, since the workers don't wait for each other before they finish.
+ *
+ * @param   { Generator * }   this    The generator to clean up.
+*/
+void Generator_exit(Generator *this) {
+  int i, j;
+  char sMutexKey[STRING_KEY_MAX_LENGTH];
+
+  // The workers don't start another tick after this, so we only have to wait for the ones in progress
+  if(this->bIsRunning) {
+    this->bIsRunning = 0;
+
+    for(i = 0; i < GENERATOR_WORKERS; i++) {
+      sprintf(sMutexKey, "%s-%d", GENERATOR_WORKER_MUTEX, i);
+      ThreadManager_lockMutex(this->pThreadManager, sMutexKey);
+      ThreadManager_unlockMutex(this->pThreadManager, sMutexKey);
+    }
+  }
+
+  for(i = 0; i < this->nKinds; i++) {
+    free(this->aKinds[i].aSeeds);
+    free(this->aKinds[i].aCounts);
+
+    for(j = 0; j < GENERATOR_WORKERS; j++)
+      Field_exit(&this->aScratch[j][i]);
+  }
+
+  this->nKinds = 0;
+}
+
+/**
+ * Registers a kind of board to keep a pool for.
+ * Kinds have to be added before the workers are started.
+ *
+ * @param   { Generator * }   this      The generator to modify.
+ * @param   { int }           dWidth    The width of the board.
+ * @param   { int }           dHeight   The height of the board.
+ * @param   { int }           dMines    The number of mines on the board.
+*/
+void Generator_addKind(Generator *this, int dWidth, int dHeight, int dMines) {
+  int i;
+  GeneratorKind *pKind;
+
+  if(this->nKinds >= GENERATOR_MAX_KINDS || this->bIsRunning)
+    return;
+
+  pKind = &this->aKinds[this->nKinds];
+  pKind->dWidth = dWidth;
+  pKind->dHeight = dHeight;
+  pKind->dMines = dMines;
+  pKind->aSeeds = calloc(dWidth * dHeight * GENERATOR_POOL_DEPTH, sizeof(*pKind->aSeeds));
+  pKind->aCounts = calloc(dWidth * dHeight, sizeof(*pKind->aCounts));
+  pKind->dWanted = -1;
+
+  // Every worker gets a field of that size to try boards on
+  for(i = 0; i < GENERATOR_WORKERS; i++)
+    Field_init(&this->aScratch[i][this->nKinds], dWidth, dHeight);
+
+  this->nKinds++;
+}
+
+/**
+ * Finds the kind of board with the given parameters.
+ *
+ * @param   { Generator * }   this      The generator to read.
+ * @param   { int }           dWidth    The width of the board.
+ * @param   { int }           dHeight   The height of the board.
+ * @param   { int }           dMines    The number of mines on the board.
+ * @return  { int }                     The index of the kind, or -1 if there's no pool for it.
+*/
+int Generator_findKind(Generator *this, int dWidth, int dHeight, int dMines) {
+  int i;
+
+  for(i = 0; i < this->nKinds; i++)
+    if(this->aKinds[i].dWidth == dWidth &&
+      this->aKinds[i].dHeight == dHeight &&
+      this->aKinds[i].dMines == dMines)
+      return i;
+
+  return -1;
+}
+
+/**
+ * Builds the board described by a seed and a first click.
+ * The first click and its surroundings are kept clear of mines.
+ *
+ * @param   { Field * }   pField    The field to build the board on; its dimensions are kept.
+ * @param   { uint64_t }  dSeed     The seed of the board.
+ * @param   { int }       dMines    The number of mines.
+ * @param   { int }       x         The x-coordinate of the first click.
+ * @param   { int }       y         The y-coordinate of the first click.
+*/
+void Generator_build(Field *pField, uint64_t dSeed, int dMines, int x, int y) {
+  Random random;
+
+  Random_seed(&random, dSeed);
+  Field_populateSafe(pField, dMines, x, y, &random);
+  Field_setNumbers(pField);
+  Field_reset(pField);
+}
+
+/**
+ * Checks whether the board described by a seed and a first click needs no guesses.
+ *
+ * @param   { Field * }   pField    A field of the right size to try the board on.
+ * @param   { uint64_t }  dSeed     The seed of the board.
+ * @param   { int }       dMines    The number of mines.
+ * @param   { int }       x         The x-coordinate of the first click.
+ * @param   { int }       y         The y-coordinate of the first click.
+ * @return  { int }                 Whether or not the board can be solved without guessing.
+*/
+int Generator_isNoGuess(Field *pField, uint64_t dSeed, int dMines, int x, int y) {
+  Generator_build(pField, dSeed, dMines, x, y);
+
+  return Solver_isSolvable(pField, x, y);
+}
+
+/**
+ * Looks for a no-guess seed without the pool.
+ * This runs on the caller's thread, so it only tries a limited number of seeds.
+ * The seeds tried come from dSeed, so the result is still reproducible.
+ *
+ * @param   { Field * }   pField    A field of the right size to try boards on.
+ * @param   { uint64_t }  dSeed     Where to start drawing seeds from.
+ * @param   { int }       dMines    The number of mines.
+ * @param   { int }       x         The x-coordinate of the first click.
+ * @param   { int }       y         The y-coordinate of the first click.
+ * @return  { uint64_t }            A no-guess seed, or 0 if none was found.
+*/
+uint64_t Generator_search(Field *pField, uint64_t dSeed, int dMines, int x, int y) {
+  int i;
+  uint64_t dCandidate;
+
+  for(i = 0; i < GENERATOR_ATTEMPTS_BLOCKING; i++) {
+    dCandidate = Random_splitMix(&dSeed);
+
+    if(dCandidate && Generator_isNoGuess(pField, dCandidate, dMines, x, y))
+      return dCandidate;
+  }
+
+  return 0;
+}
+
+/**
+ * Takes a ready seed from the pool.
+ * This never waits on the workers; if the pool is empty for that tile, it just returns 0.
+ *
+ * @param   { Generator * }   this    The generator to take from.
+ * @param   { int }           dKind   The kind of board we want.
+ * @param   { int }           x       The x-coordinate of the first click.
+ * @param   { int }           y       The y-coordinate of the first click.
+ * @return  { uint64_t }              A seed that needs no guesses from (x, y), or 0 if there's none yet.
+*/
+uint64_t Generator_take(Generator *this, int dKind, int x, int y) {
+  GeneratorKind *pKind;
+  uint64_t dSeed = 0;
+  int i, dCell;
+
+  if(dKind < 0 || dKind >= this->nKinds)
+    return 0;
+
+  pKind = &this->aKinds[dKind];
+  dCell = y * pKind->dWidth + x;
+
+  ThreadManager_lockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+  if(pKind->aCounts[dCell])
+    dSeed = pKind->aSeeds[dCell * GENERATOR_POOL_DEPTH + --pKind->aCounts[dCell]];
+
+  ThreadManager_unlockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+  // The workers have a tile to fill again
+  if(dSeed && this->bIsRunning)
+    for(i = 0; i < GENERATOR_WORKERS; i++)
+      Signal_raise(this->aWakeSignals[i]);
+
+  return dSeed;
+}
+
+/**
+ * Checks whether the pool has a seed ready for a tile, without taking it.
+ *
+ * @param   { Generator * }   this    The generator to read.
+ * @param   { int }           dKind   The kind of board we want.
+ * @param   { int }           x       The x-coordinate of the first click.
+ * @param   { int }           y       The y-coordinate of the first click.
+ * @return  { int }                   Whether or not Generator_take() would give a seed.
+*/
+int Generator_isReady(Generator *this, int dKind, int x, int y) {
+  int bIsReady;
+
+  if(dKind < 0 || dKind >= this->nKinds)
+    return 0;
+
+  ThreadManager_lockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+  bIsReady = this->aKinds[dKind].aCounts[y * this->aKinds[dKind].dWidth + x] > 0;
+  ThreadManager_unlockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+  return bIsReady;
+}
+
+/**
+ * Asks the workers for a seed for a tile whose pool is empty.
+ * This doesn't wait either; the workers work on that tile before any other, and raise the
+ *    ready signal once it has a seed. Only the latest request of each kind is kept.
+ *
+ * @param   { Generator * }   this    The generator to ask.
+ * @param   { int }           dKind   The kind of board we want.
+ * @param   { int }           x       The x-coordinate of the first click.
+ * @param   { int }           y       The y-coordinate of the first click.
+*/
+void Generator_request(Generator *this, int dKind, int x, int y) {
+  int i;
+
+  if(dKind < 0 || dKind >= this->nKinds)
+    return;
+
+  ThreadManager_lockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+  this->aKinds[dKind].dWanted = y * this->aKinds[dKind].dWidth + x;
+  ThreadManager_unlockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+  if(this->bIsRunning)
+    for(i = 0; i < GENERATOR_WORKERS; i++)
+      Signal_raise(this->aWakeSignals[i]);
+}
+
+/**
+ * Sets the signal to raise whenever a requested seed is ready.
+ *
+ * @param   { Generator * }   this          The generator to modify.
+ * @param   { Signal * }      pReadySignal  The signal to raise.
+*/
+void Generator_setReadySignal(Generator *this, Signal *pReadySignal) {
+  this->pReadySignal = pReadySignal;
+}
+
+/**
+ * Changes how long a worker sleeps between ticks.
+ * This is called from the worker itself, and only touches the thread when the sleep actually changes.
+ *
+ * @param   { Generator * }   this      The generator.
+ * @param   { int }           dWorker   Which worker this is.
+ * @param   { long }          dSleep    How long to sleep (in ms).
+*/
+void Generator_setSleep(Generator *this, int dWorker, long dSleep) {
+  char sThreadKey[STRING_KEY_MAX_LENGTH];
+
+  if(this->aSleeps[dWorker] == dSleep)
+    return;
+
+  this->aSleeps[dWorker] = dSleep;
+
+  sprintf(sThreadKey, "%s-%d", GENERATOR_WORKER_THREAD, dWorker);
+  ThreadManager_setThreadSleep(this->pThreadManager, sThreadKey, dSleep);
+}
+
+/**
+ * The routine of a worker thread.
+ * Every tick, it finds the first click with the fewest ready seeds and tries a batch of boards for it.
+ * First clicks a game is waiting on come before everything else.
+ * The pool mutex is only held while reading the counts and storing a seed, never while solving.
+ * Once the pools are full, the worker sleeps until Generator_take() wakes it up.
+ *
+ * @param   { p_obj }   pArgs_Generator   The generator.
+ * @param   { int }     tArg_Worker       Which worker this is.
+*/
+void Generator_work(p_obj pArgs_Generator, int tArg_Worker) {
+  Generator *this = (Generator *) pArgs_Generator;
+  GeneratorKind *pKind;
+  int i, j, dKind = -1, dCell = -1, dFewest = GENERATOR_POOL_DEPTH;
+  int dCells, dTile, x, y, bIsWanted;
+  uint64_t dSeed;
+
+  // We're shutting down
+  if(!this->bIsRunning)
+    return;
+
+  // Find where we're needed the most
+  ThreadManager_lockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+  // Someone's waiting on these
+  for(i = 0; i < this->nKinds && dKind < 0; i++) {
+    if(this->aKinds[i].dWanted >= 0 && !this->aKinds[i].aCounts[this->aKinds[i].dWanted]) {
+      dFewest = 0;
+      dKind = i;
+      dCell = this->aKinds[i].dWanted;
+    }
+  }
+
+  // Otherwise, the tile with the fewest seeds
+  for(i = 0; i < this->nKinds && dFewest; i++) {
+    dCells = this->aKinds[i].dWidth * this->aKinds[i].dHeight;
+
+    // Start at a different tile for each worker so they don't all work on the same one
+    for(j = 0; j < dCells; j++) {
+      dTile = (j + tArg_Worker * dCells / GENERATOR_WORKERS) % dCells;
+
+      if(this->aKinds[i].aCounts[dTile] < dFewest) {
+        dFewest = this->aKinds[i].aCounts[dTile];
+        dKind = i;
+        dCell = dTile;
+      }
+    }
+  }
+
+  ThreadManager_unlockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+  // All the pools are full
+  if(dKind < 0) {
+    Generator_setSleep(this, tArg_Worker, GENERATOR_SLEEP);
+    return;
+  }
+
+  Generator_setSleep(this, tArg_Worker, THREAD_TIMEOUT);
+
+  pKind = &this->aKinds[dKind];
+  x = dCell % pKind->dWidth;
+  y = dCell / pKind->dWidth;
+
+  for(i = 0; i < GENERATOR_ATTEMPTS_PER_TICK; i++) {
+    dSeed = Random_next(&this->aRandoms[tArg_Worker]);
+
+    if(!dSeed || !Generator_isNoGuess(&this->aScratch[tArg_Worker][dKind], dSeed, pKind->dMines, x, y))
+      continue;
+
+    // Store the seed if there's still room for it
+    ThreadManager_lockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+    if(pKind->aCounts[dCell] < GENERATOR_POOL_DEPTH)
+      pKind->aSeeds[dCell * GENERATOR_POOL_DEPTH + pKind->aCounts[dCell]++] = dSeed;
+
+    // The game waiting on it can take it now
+    bIsWanted = pKind->dWanted == dCell;
+    if(bIsWanted)
+      pKind->dWanted = -1;
+
+    ThreadManager_unlockMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+    if(bIsWanted && this->pReadySignal != NULL)
+      Signal_raise(this->pReadySignal);
+
+    return;
+  }
+}
+
+/**
+ * Starts the worker threads.
+ * Each worker gets its own data mutex so they don't wait on each other.
+ *
+ * @param   { Generator * }   this    The generator to start.
+*/
+void Generator_start(Generator *this) {
+  int i;
+  char sThreadKey[STRING_KEY_MAX_LENGTH];
+  char sMutexKey[STRING_KEY_MAX_LENGTH];
+  char sSignalKey[STRING_KEY_MAX_LENGTH];
+
+  if(this->bIsRunning)
+    return;
+
+  ThreadManager_createMutex(this->pThreadManager, GENERATOR_POOL_MUTEX);
+
+  // The workers check this as soon as they start
+  this->bIsRunning = 1;
+
+  for(i = 0; i < GENERATOR_WORKERS; i++) {
+    sprintf(sThreadKey, "%s-%d", GENERATOR_WORKER_THREAD, i);
+    sprintf(sMutexKey, "%s-%d", GENERATOR_WORKER_MUTEX, i);
+    sprintf(sSignalKey, "%s-%d", GENERATOR_WORKER_SIGNAL, i);
+
+    // A signal only wakes one thread up, so each worker gets its own
+    this->aWakeSignals[i] = Signal_create(sSignalKey);
+
+    ThreadManager_createMutex(this->pThreadManager, sMutexKey);
+    ThreadManager_createThread(this->pThreadManager, sThreadKey, sMutexKey, Generator_work, this, i);
+    ThreadManager_setThreadSignal(this->pThreadManager, sThreadKey, this->aWakeSignals[i]);
+  }
+}
+
+#endif
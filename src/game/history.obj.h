@@ -0,0 +1,322 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 16:12:08
+ * @ Modified time: 2026-10-16 16:12:08
+ * @ Description:
+ *
+ * The history keeps every move of a game so it can be undone, redone or replayed.
+ * Boards are never copied: each move only stores the words of the mine, flag and inspect
+ *    planes it changed, as XOR masks, along with a few numbers about the game (cursor, timing).
+ * Every state of the board is then the starting board with some prefix of these masks applied,
+ *    so the snapshots share everything they didn't change. A flag costs one word, and a
+ *    cascade costs only the words it opened up, no matter how big the board is.
+ */
+
+#ifndef GAME_HISTORY_
+#define GAME_HISTORY_
+
+#include "./field.obj.h"
+
+#include "../utils/utils.grid.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HISTORY_PLANE_COUNT 3             // The mine, flag and inspect planes, which come first in the field's block
+#define HISTORY_MIN_CAPACITY 64
+
+typedef struct HistoryState HistoryState;
+typedef struct History History;
+
+/**
+ * //
+ * ////
+ * //////    HistoryState struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * Whatever the game needs on top of the planes to go back to a move.
+ *
+ * @struct
+*/
+struct HistoryState {
+  int dCursorX, dCursorY;   // Where the player was
+  int dLastX, dLastY;       // The exploded mine, if any
+  int dSafeLeft;            // Saves us from recounting the field
+  int dTime;                // How many seconds into the game the move was made
+  int dOutcome;             // The outcome of the game after the move
+  int bIsGenerated;         // Undoing the first inspect of a classic game takes its mines away too
+  int dChangeEnd;           // The changes of the move end here (they start where the last move's end)
+};
+
+/**
+ * //
+ * ////
+ * //////    History struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * The history of a game.
+ * This is not a class; it lives inside the game.
+ * aStates[0] is the board before any move, and aStates[i] the board after move i.
+ *
+ * @struct
+*/
+struct History {
+  uint64_t *pShadow;        // The planes as of the current move, so we can tell what a move changed
+  size_t nWords;            // The number of words in a single plane
+
+  uint32_t *aIndices;       // Which word each change touches (counting across all the planes)
+  uint64_t *aMasks;         // What to XOR into that word to apply or undo the change
+  int nChanges;
+  int dChangeCapacity;
+
+  HistoryState *aStates;    // The state after each move
+  int nMoves;               // The moves made, including the ones that were undone and can be redone
+  int dStateCapacity;
+
+  int dCurrent;             // The move the board is at right now
+};
+
+/**
+ * Initializes the history.
+ *
+ * @param   { History * }   this    The history to initialize.
+*/
+void History_init(History *this) {
+  this->pShadow = NULL;
+  this->nWords = 0;
+
+  this->aIndices = NULL;
+  this->aMasks = NULL;
+  this->nChanges = 0;
+  this->dChangeCapacity = 0;
+
+  this->aStates = NULL;
+  this->nMoves = 0;
+  this->dStateCapacity = 0;
+
+  this->dCurrent = 0;
+}
+
+/**
+ * Frees the buffers of the history.
+ * It's safe to call this on a zeroed history.
+ *
+ * @param   { History * }   this    The history to clean up.
+*/
+void History_exit(History *this) {
+  free(this->pShadow);
+  free(this->aIndices);
+  free(this->aMasks);
+  free(this->aStates);
+
+  History_init(this);
+}
+
+/**
+ * Returns where the planes of a field start.
+ *
+ * @param   { Field * }       pField  The field to read.
+ * @return  { uint64_t * }            The first word of the mine plane; the other two follow it.
+*/
+uint64_t *History_getPlanes(Field *pField) {
+  return pField->pMineGrid->dBitArray;
+}
+
+/**
+ * Makes sure the history can hold a number of changes and moves.
+ *
+ * @param   { History * }   this        The history to modify.
+ * @param   { int }         nChanges    How many changes we need room for.
+ * @param   { int }         nStates     How many states we need room for.
+*/
+void History_reserve(History *this, int nChanges, int nStates) {
+  if(nChanges > this->dChangeCapacity) {
+    this->dChangeCapacity = nChanges > this->dChangeCapacity * 2 ? nChanges : this->dChangeCapacity * 2;
+    this->aIndices = realloc(this->aIndices, this->dChangeCapacity * sizeof(*this->aIndices));
+    this->aMasks = realloc(this->aMasks, this->dChangeCapacity * sizeof(*this->aMasks));
+  }
+
+  if(nStates > this->dStateCapacity) {
+    this->dStateCapacity = nStates > this->dStateCapacity * 2 ? nStates : this->dStateCapacity * 2;
+    this->aStates = realloc(this->aStates, this->dStateCapacity * sizeof(*this->aStates));
+  }
+}
+
+/**
+ * Starts a new history from the current board.
+ * Anything recorded before is dropped, but the buffers are kept for the next game.
+ *
+ * @param   { History * }         this      The history to start.
+ * @param   { Field * }           pField    The board the game starts with.
+ * @param   { HistoryState * }    pState    The state of the game at the start.
+*/
+void History_start(History *this, Field *pField, HistoryState *pState) {
+  size_t nWords = Grid_getWordCount(pField->dWidth, pField->dHeight);
+
+  // The shadow only has to change with the size of the board
+  if(this->pShadow == NULL || nWords != this->nWords) {
+    free(this->pShadow);
+    this->pShadow = calloc(HISTORY_PLANE_COUNT * nWords, sizeof(*this->pShadow));
+    this->nWords = nWords;
+  }
+
+  memcpy(this->pShadow, History_getPlanes(pField), HISTORY_PLANE_COUNT * nWords * sizeof(*this->pShadow));
+
+  History_reserve(this, HISTORY_MIN_CAPACITY, HISTORY_MIN_CAPACITY);
+
+  this->nChanges = 0;
+  this->nMoves = 0;
+  this->dCurrent = 0;
+
+  this->aStates[0] = *pState;
+  this->aStates[0].dChangeEnd = 0;
+}
+
+/**
+ * Records a move, if it changed anything.
+ * The planes are compared against the shadow a word at a time, and only the words that differ are kept.
+ * Moves that were undone are forgotten once a new move is made.
+ * The cursor and the time don't count as changes on their own.
+ *
+ * @param   { History * }         this      The history to add to.
+ * @param   { Field * }           pField    The board after the move.
+ * @param   { HistoryState * }    pState    The state of the game after the move.
+ * @return  { int }                         Whether or not the move was recorded.
+*/
+int History_commit(History *this, Field *pField, HistoryState *pState) {
+  size_t i, nTotal = HISTORY_PLANE_COUNT * this->nWords;
+  uint64_t *pPlanes = History_getPlanes(pField);
+  HistoryState *pLast;
+  int dChange;
+
+  // The history was never started for this board
+  if(this->pShadow == NULL || Grid_getWordCount(pField->dWidth, pField->dHeight) != this->nWords)
+    return 0;
+
+  // The new changes go right after the current move's, over whatever could have been redone
+  pLast = &this->aStates[this->dCurrent];
+  dChange = pLast->dChangeEnd;
+
+  for(i = 0; i < nTotal; i++) {
+    if(pPlanes[i] == this->pShadow[i])
+      continue;
+
+    History_reserve(this, dChange + 1, 0);
+    this->aIndices[dChange] = (uint32_t) i;
+    this->aMasks[dChange] = pPlanes[i] ^ this->pShadow[i];
+    dChange++;
+
+    this->pShadow[i] = pPlanes[i];
+  }
+
+  // Nothing happened, so the moves that were undone can still be redone
+  if(dChange == pLast->dChangeEnd &&
+    pState->dOutcome == pLast->dOutcome &&
+    pState->bIsGenerated == pLast->bIsGenerated)
+    return 0;
+
+  // Otherwise they're gone
+  History_reserve(this, 0, this->dCurrent + 2);
+
+  this->nChanges = dChange;
+  this->nMoves = this->dCurrent + 1;
+  this->dCurrent++;
+  this->aStates[this->dCurrent] = *pState;
+  this->aStates[this->dCurrent].dChangeEnd = this->nChanges;
+
+  return 1;
+}
+
+/**
+ * Applies or takes back the changes of a single move.
+ * Since the changes are XOR masks, doing this twice leaves the board as it was.
+ * The numbers are only worked out again when the mines changed.
+ *
+ * @param   { History * }   this      The history to read.
+ * @param   { Field * }     pField    The board to modify.
+ * @param   { int }         dMove     The move to toggle (from 1 to nMoves).
+*/
+void History_toggle(History *this, Field *pField, int dMove) {
+  int i, bMinesChanged = 0;
+  uint64_t *pPlanes = History_getPlanes(pField);
+
+  for(i = this->aStates[dMove - 1].dChangeEnd; i < this->aStates[dMove].dChangeEnd; i++) {
+    pPlanes[this->aIndices[i]] ^= this->aMasks[i];
+    this->pShadow[this->aIndices[i]] ^= this->aMasks[i];
+
+    // The mine plane comes first
+    if(this->aIndices[i] < this->nWords)
+      bMinesChanged = 1;
+  }
+
+  if(bMinesChanged)
+    Field_setNumbers(pField);
+}
+
+/**
+ * Moves the board to the state after a given move.
+ * This walks one move at a time, so it costs as much as the moves in between changed.
+ *
+ * @param   { History * }         this      The history to read.
+ * @param   { Field * }           pField    The board to modify.
+ * @param   { int }               dMove     The move to go to (0 is the start of the game).
+ * @return  { HistoryState * }              The state after that move, or NULL if there's no such move.
+*/
+HistoryState *History_seek(History *this, Field *pField, int dMove) {
+  if(this->pShadow == NULL || dMove < 0 || dMove > this->nMoves)
+    return NULL;
+
+  while(this->dCurrent > dMove)
+    History_toggle(this, pField, this->dCurrent--);
+
+  while(this->dCurrent < dMove)
+    History_toggle(this, pField, ++this->dCurrent);
+
+  // The counts were saved, so there's no need to recount them
+  pField->dSafeLeft = this->aStates[dMove].dSafeLeft;
+
+  return &this->aStates[dMove];
+}
+
+/**
+ * Takes back the last move.
+ *
+ * @param   { History * }         this      The history to read.
+ * @param   { Field * }           pField    The board to modify.
+ * @return  { HistoryState * }              The state before the move, or NULL if there's nothing to undo.
+*/
+HistoryState *History_undo(History *this, Field *pField) {
+  return History_seek(this, pField, this->dCurrent - 1);
+}
+
+/**
+ * Makes the last move that was taken back again.
+ *
+ * @param   { History * }         this      The history to read.
+ * @param   { Field * }           pField    The board to modify.
+ * @return  { HistoryState * }              The state after the move, or NULL if there's nothing to redo.
+*/
+HistoryState *History_redo(History *this, Field *pField) {
+  return History_seek(this, pField, this->dCurrent + 1);
+}
+
+/**
+ * Returns how many bytes the moves take up.
+ * The shadow isn't counted, since it's the same size whatever the number of moves.
+ *
+ * @param   { History * }   this    The history to read.
+ * @return  { size_t }              The bytes taken up by the changes and the states.
+*/
+size_t History_getSize(History *this) {
+  return (size_t) this->nChanges * (sizeof(*this->aIndices) + sizeof(*this->aMasks)) +
+    (size_t) (this->nMoves + 1) * sizeof(*this->aStates);
+}
+
+#endif
@@ -0,0 +1,445 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 17:02:41
+ * @ Modified time: 2026-10-16 17:02:41
+ * @ Description:
+ *
+ * The move log is a compact binary record of a game, good enough to play the game again exactly.
+ * It starts with a header describing the board, and then has one entry per action:
+ *
+ *    header:   "MSWL" | version | type | difficulty | width | height | mines | board
+ *    board:    0 | seed                      (classic boards, which are built from the seed)
+ *              1 | a bit per tile            (custom boards, row by row, packed into bytes)
+ *    entry:    (milliseconds since the last entry << 3 | action) | payload
+ *
+ * Every number is a varint: 7 bits per byte, lowest first, with the top bit set on all but the last byte.
+ * So most moves take 3 bytes: the time and action in one, and the coordinates in one each.
+ * Logs are stored one after the other, each preceded by its length as a varint.
+ */
+
+#ifndef GAME_MOVELOG_
+#define GAME_MOVELOG_
+
+#include "./field.obj.h"
+
+#include "../utils/utils.file.h"
+#include "../utils/utils.grid.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MOVELOG_MAGIC "MSWL"
+#define MOVELOG_MAGIC_LENGTH 4
+#define MOVELOG_VERSION 1
+#define MOVELOG_ACTION_BITS 3
+#define MOVELOG_MIN_CAPACITY 256
+#define MOVELOG_VARINT_MAX_BYTES 10
+
+typedef enum MoveLogAction MoveLogAction;
+typedef enum MoveLogBoard MoveLogBoard;
+
+typedef struct MoveLog MoveLog;
+typedef struct MoveLogReader MoveLogReader;
+
+enum MoveLogAction {
+  MOVELOG_ACTION_INSPECT,       // Payload: x, y
+  MOVELOG_ACTION_FLAG,          // Payload: x, y
+  MOVELOG_ACTION_UNFLAG,        // Payload: x, y
+  MOVELOG_ACTION_UNDO,
+  MOVELOG_ACTION_REDO,
+  MOVELOG_ACTION_PAUSE,         // Pauses or unpauses the game
+  MOVELOG_ACTION_SEED,          // Payload: the seed the next board is built from (no-guess boards get a new one)
+  MOVELOG_ACTION_END,           // Payload: the outcome, the seconds the game took
+};
+
+enum MoveLogBoard {
+  MOVELOG_BOARD_SEED,
+  MOVELOG_BOARD_MINES,
+};
+
+/**
+ * //
+ * ////
+ * //////    MoveLog struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * A log being written.
+ * This is not a class; it lives inside the game.
+ * The same struct also holds a whole file of logs, since that's just bytes too.
+ *
+ * @struct
+*/
+struct MoveLog {
+  uint8_t *aBytes;
+  size_t dLength;
+  size_t dCapacity;
+
+  int64_t dLastTime;        // When the last entry was added, in milliseconds
+  int bIsOpen;              // Whether a game is being recorded (it has a header but no end yet)
+};
+
+/**
+ * Initializes the log.
+ *
+ * @param   { MoveLog * }   this    The log to initialize.
+*/
+void MoveLog_init(MoveLog *this) {
+  this->aBytes = NULL;
+  this->dLength = 0;
+  this->dCapacity = 0;
+
+  this->dLastTime = 0;
+  this->bIsOpen = 0;
+}
+
+/**
+ * Frees the bytes of the log.
+ * It's safe to call this on a zeroed log.
+ *
+ * @param   { MoveLog * }   this    The log to clean up.
+*/
+void MoveLog_exit(MoveLog *this) {
+  free(this->aBytes);
+
+  MoveLog_init(this);
+}
+
+/**
+ * Returns a reading of a steady clock, in milliseconds.
+ *
+ * @return  { int64_t }   The reading.
+*/
+int64_t MoveLog_getTime() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (int64_t) time.tv_sec * 1000 + time.tv_nsec / 1000000;
+}
+
+/**
+ * Makes sure the log has room for some more bytes.
+ *
+ * @param   { MoveLog * }   this    The log to modify.
+ * @param   { size_t }      n       How many more bytes we need.
+*/
+void MoveLog_reserve(MoveLog *this, size_t n) {
+  if(this->dLength + n <= this->dCapacity)
+    return;
+
+  this->dCapacity = this->dCapacity < MOVELOG_MIN_CAPACITY ? MOVELOG_MIN_CAPACITY : this->dCapacity * 2;
+
+  if(this->dCapacity < this->dLength + n)
+    this->dCapacity = this->dLength + n;
+
+  this->aBytes = realloc(this->aBytes, this->dCapacity);
+}
+
+/**
+ * Adds raw bytes to the log.
+ *
+ * @param   { MoveLog * }   this      The log to modify.
+ * @param   { uint8_t * }   pBytes    The bytes to add.
+ * @param   { size_t }      n         How many there are.
+*/
+void MoveLog_writeBytes(MoveLog *this, uint8_t *pBytes, size_t n) {
+  MoveLog_reserve(this, n);
+  memcpy(this->aBytes + this->dLength, pBytes, n);
+  this->dLength += n;
+}
+
+/**
+ * Adds a number to the log, taking as few bytes as it needs.
+ *
+ * @param   { MoveLog * }   this      The log to modify.
+ * @param   { uint64_t }    dValue    The number to add.
+*/
+void MoveLog_writeVarint(MoveLog *this, uint64_t dValue) {
+  MoveLog_reserve(this, MOVELOG_VARINT_MAX_BYTES);
+
+  while(dValue >= 0x80) {
+    this->aBytes[this->dLength++] = (uint8_t) (dValue | 0x80);
+    dValue >>= 7;
+  }
+
+  this->aBytes[this->dLength++] = (uint8_t) dValue;
+}
+
+/**
+ * Starts recording a new game, dropping whatever was recorded before.
+ * Classic boards are described by their seed, since the seed and the first inspect are all it takes
+ *    to build them again. Custom boards don't have one, so their mines are stored instead.
+ *
+ * @param   { MoveLog * }   this          The log to write to.
+ * @param   { int }         dType         The type of the game.
+ * @param   { int }         dDifficulty   The difficulty of the game.
+ * @param   { Field * }     pField        The board, with its mines if they're already placed.
+ * @param   { int }         bHasSeed      Whether the board is made from a seed.
+ * @param   { uint64_t }    dSeed         The seed.
+*/
+void MoveLog_start(MoveLog *this, int dType, int dDifficulty, Field *pField, int bHasSeed, uint64_t dSeed) {
+  int x, y, i;
+  uint8_t dByte = 0;
+
+  this->dLength = 0;
+  this->dLastTime = MoveLog_getTime();
+  this->bIsOpen = 1;
+
+  MoveLog_writeBytes(this, (uint8_t *) MOVELOG_MAGIC, MOVELOG_MAGIC_LENGTH);
+  MoveLog_writeVarint(this, MOVELOG_VERSION);
+  MoveLog_writeVarint(this, dType);
+  MoveLog_writeVarint(this, dDifficulty);
+  MoveLog_writeVarint(this, pField->dWidth);
+  MoveLog_writeVarint(this, pField->dHeight);
+  MoveLog_writeVarint(this, pField->dMines);
+
+  if(bHasSeed) {
+    MoveLog_writeVarint(this, MOVELOG_BOARD_SEED);
+    MoveLog_writeVarint(this, dSeed);
+    return;
+  }
+
+  MoveLog_writeVarint(this, MOVELOG_BOARD_MINES);
+
+  // Eight tiles to a byte
+  for(y = 0, i = 0; y < pField->dHeight; y++) {
+    for(x = 0; x < pField->dWidth; x++, i++) {
+      dByte |= Grid_getBit(pField->pMineGrid, x, y) << (i & 7);
+
+      if((i & 7) == 7) {
+        MoveLog_writeBytes(this, &dByte, 1);
+        dByte = 0;
+      }
+    }
+  }
+
+  if(i & 7)
+    MoveLog_writeBytes(this, &dByte, 1);
+}
+
+/**
+ * Adds an entry to the log, along with the time since the last one.
+ * Nothing is added unless a game is being recorded.
+ *
+ * @param   { MoveLog * }       this      The log to write to.
+ * @param   { MoveLogAction }   eAction   What happened.
+ * @return  { int }                       Whether or not the entry was added; the payload should follow it.
+*/
+int MoveLog_add(MoveLog *this, MoveLogAction eAction) {
+  int64_t dTime;
+
+  if(!this->bIsOpen)
+    return 0;
+
+  dTime = MoveLog_getTime();
+  MoveLog_writeVarint(this, (uint64_t) (dTime - this->dLastTime) << MOVELOG_ACTION_BITS | eAction);
+  this->dLastTime = dTime;
+
+  return 1;
+}
+
+/**
+ * Adds an action on a tile to the log.
+ *
+ * @param   { MoveLog * }       this      The log to write to.
+ * @param   { MoveLogAction }   eAction   What happened.
+ * @param   { int }             x         The x-coordinate of the tile.
+ * @param   { int }             y         The y-coordinate of the tile.
+*/
+void MoveLog_addTile(MoveLog *this, MoveLogAction eAction, int x, int y) {
+  if(!MoveLog_add(this, eAction))
+    return;
+
+  MoveLog_writeVarint(this, x);
+  MoveLog_writeVarint(this, y);
+}
+
+/**
+ * Adds the seed of the next board to the log.
+ *
+ * @param   { MoveLog * }   this      The log to write to.
+ * @param   { uint64_t }    dSeed     The seed.
+*/
+void MoveLog_addSeed(MoveLog *this, uint64_t dSeed) {
+  if(MoveLog_add(this, MOVELOG_ACTION_SEED))
+    MoveLog_writeVarint(this, dSeed);
+}
+
+/**
+ * Ends the log with how the game went.
+ * Nothing can be added after this.
+ *
+ * @param   { MoveLog * }   this        The log to write to.
+ * @param   { int }         dOutcome    How the game ended.
+ * @param   { int }         dSeconds    How long the game took, as the player was told.
+*/
+void MoveLog_end(MoveLog *this, int dOutcome, int dSeconds) {
+  if(!MoveLog_add(this, MOVELOG_ACTION_END))
+    return;
+
+  MoveLog_writeVarint(this, dOutcome);
+  MoveLog_writeVarint(this, dSeconds < 0 ? 0 : dSeconds);
+
+  this->bIsOpen = 0;
+}
+
+/**
+ * Adds a finished log to a collection of logs, preceded by its length.
+ *
+ * @param   { MoveLog * }   this        The log to add.
+ * @param   { MoveLog * }   pArchive    The collection to add it to.
+*/
+void MoveLog_pack(MoveLog *this, MoveLog *pArchive) {
+  MoveLog_writeVarint(pArchive, this->dLength);
+  MoveLog_writeBytes(pArchive, this->aBytes, this->dLength);
+}
+
+/**
+ * Appends the bytes of the log to a file.
+ *
+ * @param   { MoveLog * }   this      The log to write.
+ * @param   { char * }      sPath     The file to write to.
+ * @return  { int }                   Whether or not the operation was successful.
+*/
+int MoveLog_write(MoveLog *this, char *sPath) {
+  File *pFile = File_create(sPath);
+  int bIsWritten = File_writeBin(pFile, this->dLength, this->aBytes) >= 0;
+
+  File_kill(pFile);
+
+  return bIsWritten;
+}
+
+/**
+ * Appends a finished log to a file of logs.
+ *
+ * @param   { MoveLog * }   this      The log to save.
+ * @param   { char * }      sPath     The file to write to.
+ * @return  { int }                   Whether or not the operation was successful.
+*/
+int MoveLog_save(MoveLog *this, char *sPath) {
+  MoveLog archive;
+  int bIsSaved;
+
+  MoveLog_init(&archive);
+  MoveLog_pack(this, &archive);
+  bIsSaved = MoveLog_write(&archive, sPath);
+  MoveLog_exit(&archive);
+
+  return bIsSaved;
+}
+
+/**
+ * //
+ * ////
+ * //////    MoveLogReader struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * Goes through the bytes of a log.
+ * Reading past the end, or a number that doesn't fit, marks the reader as broken instead of
+ *    crashing, so bad logs can be told apart from good ones.
+ *
+ * @struct
+*/
+struct MoveLogReader {
+  uint8_t *pBytes;
+  size_t dLength;
+  size_t dOffset;
+  int bIsBroken;
+};
+
+/**
+ * Initializes the reader.
+ *
+ * @param   { MoveLogReader * }   this      The reader to initialize.
+ * @param   { uint8_t * }         pBytes    The bytes to read. They aren't copied.
+ * @param   { size_t }            dLength   How many there are.
+*/
+void MoveLogReader_init(MoveLogReader *this, uint8_t *pBytes, size_t dLength) {
+  this->pBytes = pBytes;
+  this->dLength = dLength;
+  this->dOffset = 0;
+  this->bIsBroken = 0;
+}
+
+/**
+ * Returns whether or not everything has been read.
+ *
+ * @param   { MoveLogReader * }   this    The reader.
+ * @return  { int }                       Whether the reader is at the end.
+*/
+int MoveLogReader_isDone(MoveLogReader *this) {
+  return this->dOffset >= this->dLength;
+}
+
+/**
+ * Reads raw bytes.
+ *
+ * @param   { MoveLogReader * }   this      The reader.
+ * @param   { size_t }            n         How many bytes to read.
+ * @return  { uint8_t * }                   Where the bytes are, or NULL if there aren't that many left.
+*/
+uint8_t *MoveLogReader_readBytes(MoveLogReader *this, size_t n) {
+  uint8_t *pBytes = this->pBytes + this->dOffset;
+
+  if(n > this->dLength - this->dOffset) {
+    this->bIsBroken = 1;
+    this->dOffset = this->dLength;
+    return NULL;
+  }
+
+  this->dOffset += n;
+
+  return pBytes;
+}
+
+/**
+ * Reads a number.
+ *
+ * @param   { MoveLogReader * }   this    The reader.
+ * @return  { uint64_t }                  The number, or 0 if there wasn't a whole one.
+*/
+uint64_t MoveLogReader_readVarint(MoveLogReader *this) {
+  uint64_t dValue = 0;
+  int i;
+
+  for(i = 0; i < MOVELOG_VARINT_MAX_BYTES && this->dOffset < this->dLength; i++) {
+    dValue |= (uint64_t) (this->pBytes[this->dOffset] & 0x7f) << (7 * i);
+
+    if(!(this->pBytes[this->dOffset++] & 0x80))
+      return dValue;
+  }
+
+  this->bIsBroken = 1;
+
+  return 0;
+}
+
+/**
+ * Reads the next log out of a collection of logs.
+ *
+ * @param   { MoveLogReader * }   this      The reader of the collection.
+ * @param   { MoveLogReader * }   pLog      Where to put a reader for the log.
+ * @return  { int }                         Whether or not there was a whole log left.
+*/
+int MoveLogReader_readLog(MoveLogReader *this, MoveLogReader *pLog) {
+  uint64_t dLength = MoveLogReader_readVarint(this);
+  uint8_t *pBytes = MoveLogReader_readBytes(this, dLength);
+
+  if(this->bIsBroken)
+    return 0;
+
+  MoveLogReader_init(pLog, pBytes, dLength);
+
+  return 1;
+}
+
+#endif
@@ -0,0 +1,923 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 14:40:12
+ * @ Modified time: 2026-10-16 14:40:12
+ * @ Description:
+ *
+ * Computes the exact chance that each unknown tile of a field is a mine.
+ * Whatever the solver's cheap rules can prove is settled first. The unknowns left next to visible
+ *    numbers (the frontier) are split into groups that share no numbers, and every arrangement of
+ *    each group is counted by how many mines it uses.
+ * The rest of the unknowns (the interior) can hold the remaining mines in any way, so they only
+ *    contribute a binomial coefficient, which we keep as a logarithm so big boards don't overflow.
+ * The groups are independent, so worker threads can count them at the same time.
+ * Games don't wait for any of this: they post the board to a job thread and show the last chances
+ *    it finished, marked as stale, until the new ones come in.
+ */
+
+#ifndef GAME_PROBABILITY_
+#define GAME_PROBABILITY_
+
+#include "./field.obj.h"
+#include "./solver.game.c"
+
+#include "../utils/utils.grid.h"
+#include "../utils/utils.thread.h"
+#include "../utils/utils.types.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROBABILITY_WORKERS 2                     // The number of threads helping out with the groups
+#define PROBABILITY_BUDGET (1 << 22)              // How many steps a single group can take before we give up
+#define PROBABILITY_SLEEP 1000                    // How long an idle worker sleeps before checking whether it should stop (in ms)
+
+#define PROBABILITY_POOL_MUTEX "probability-pool-mutex"
+#define PROBABILITY_WORKER_MUTEX "probability-worker-mutex"
+#define PROBABILITY_WORKER_THREAD "probability-worker-thread"
+#define PROBABILITY_WORKER_SIGNAL "probability-worker-signal"
+#define PROBABILITY_DONE_SIGNAL "probability-done-signal"
+#define PROBABILITY_JOB_MUTEX "probability-job-mutex"
+#define PROBABILITY_JOB_THREAD "probability-job-thread"
+#define PROBABILITY_JOB_SIGNAL "probability-job-signal"
+
+typedef struct ProbabilityTask ProbabilityTask;
+typedef struct Probability Probability;
+
+/**
+ * //
+ * ////
+ * //////    Probability struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * A group of the frontier, and what counting its arrangements found.
+ *
+ * @struct
+*/
+struct ProbabilityTask {
+  int *aGroup;                                    // The frontier ids of the cells in the group
+  int nGroup;                                     // How many cells there are
+
+  double *aWays;                                  // How many arrangements use k mines (nGroup + 1 entries)
+  double *aCellWays;                              // The same, but only those where the cell is a mine
+                                                  //    (nGroup + 1 entries for each cell)
+
+  int dLeast;                                     // The fewest mines any arrangement uses
+  int dMost;                                      // The most mines any arrangement uses
+
+  int dBudget;                                    // How many more steps the search can take
+  int bIsExact;                                   // Whether the search finished
+};
+
+/**
+ * The calculator and its worker pool.
+ * This is not a class; keep one around and call Probability_compute() whenever the field changes,
+ *    or Probability_post() to have it done in the background.
+ *
+ * @struct
+*/
+struct Probability {
+  ThreadManager *pThreadManager;                  // Where the workers live; this may be NULL
+  int bIsRunning;                                 // Whether the workers have been started
+
+  Field *pField;                                  // The field the solver was set up for
+  Solver solver;                                  // Finds the frontier and its groups
+
+  ProbabilityTask *aTasks;                        // One task per group
+  int nGroups;                                    // How many groups the frontier has
+  int nTasks;
+  int dNextTask;                                  // The next task nobody has taken yet
+  int dTasksDone;                                 // How many tasks have been finished
+
+  Signal *aWorkSignals[PROBABILITY_WORKERS];      // Wakes each worker up when there are tasks to take
+  Signal *pDoneSignal;                            // Raised when the last task is finished
+
+  double *aWays;                                  // The block the tasks write their counts to
+
+  double *aChances;                               // The chance of each tile (y * width + x) being a mine
+                                                  //    This is -1 for inspected or flagged tiles.
+  int bIsExact;                                   // Whether the chances could be worked out
+
+  Field postField;                                // The latest board posted for the job thread
+  Field jobField;                                 // The job thread's own copy, which it works the chances out on
+  int dPosted;                                    // How many boards have been posted
+  int dTaken;                                     // The last board the job thread took
+  int dFinished;                                  // The last board whose chances were published
+
+  double *aPublished;                             // The chances of that board, laid out like aChances
+  int dPublishedWidth, dPublishedHeight;          // The size of that board
+  int bIsPublishedExact;                          // Whether they could be worked out
+
+  Signal *pJobSignal;                             // Wakes the job thread up when a board is posted
+  Signal *pReadySignal;                           // Raised when new chances are published; this may be NULL
+};
+
+/**
+ * Initializes the calculator.
+ * The workers don't start until Probability_start() is called; without them, everything runs on the caller.
+ *
+ * @param   { Probability * }     this              The calculator to initialize.
+ * @param   { ThreadManager * }   pThreadManager    The thread manager to create the workers with, or NULL.
+*/
+void Probability_init(Probability *this, ThreadManager *pThreadManager) {
+  int i;
+
+  this->pThreadManager = pThreadManager;
+  this->bIsRunning = 0;
+
+  this->pField = NULL;
+  this->aTasks = NULL;
+  this->nGroups = 0;
+  this->nTasks = 0;
+  this->dNextTask = 0;
+  this->dTasksDone = 0;
+
+  for(i = 0; i < PROBABILITY_WORKERS; i++)
+    this->aWorkSignals[i] = NULL;
+
+  this->pDoneSignal = NULL;
+
+  this->aWays = NULL;
+  this->aChances = NULL;
+  this->bIsExact = 0;
+
+  // The fields free whatever they held when they're first copied to
+  memset(&this->postField, 0, sizeof(this->postField));
+  memset(&this->jobField, 0, sizeof(this->jobField));
+  this->dPosted = 0;
+  this->dTaken = 0;
+  this->dFinished = 0;
+
+  this->aPublished = NULL;
+  this->dPublishedWidth = 0;
+  this->dPublishedHeight = 0;
+  this->bIsPublishedExact = 0;
+
+  this->pJobSignal = NULL;
+  this->pReadySignal = NULL;
+}
+
+/**
+ * Frees the buffers of the calculator.
+ * The workers have to be stopped by their thread manager first.
+ * The signals are left alone, since the workers don't wait for each other before they finish.
+ *
+ * @param   { Probability * }   this    The calculator to clean up.
+*/
+void Probability_exit(Probability *this) {
+  if(this->pField != NULL)
+    Solver_exit(&this->solver);
+
+  free(this->aTasks);
+  free(this->aWays);
+  free(this->aChances);
+  free(this->aPublished);
+
+  Field_exit(&this->postField);
+  Field_exit(&this->jobField);
+
+  this->pField = NULL;
+  this->aTasks = NULL;
+  this->aWays = NULL;
+  this->aChances = NULL;
+  this->aPublished = NULL;
+}
+
+/**
+ * Locks the task list, if there's anyone else who could touch it.
+ *
+ * @param   { Probability * }   this    The calculator.
+*/
+void Probability_lock(Probability *this) {
+  if(this->bIsRunning)
+    ThreadManager_lockMutex(this->pThreadManager, PROBABILITY_POOL_MUTEX);
+}
+
+/**
+ * Unlocks the task list.
+ *
+ * @param   { Probability * }   this    The calculator.
+*/
+void Probability_unlock(Probability *this) {
+  if(this->bIsRunning)
+    ThreadManager_unlockMutex(this->pThreadManager, PROBABILITY_POOL_MUTEX);
+}
+
+/**
+ * //
+ * ////
+ * //////    Counting
+ * ////////
+ * //////////
+*/
+
+/**
+ * Counts every arrangement of mines on a group that meets all its constraints, by how many mines it uses.
+ * This uses the solver's decisions, which only touch the cells and constraints of the group,
+ *    so different groups can be searched at the same time.
+ *
+ * @param   { Solver * }            pSolver   The solver holding the frontier.
+ * @param   { ProbabilityTask * }   pTask     The group to count.
+ * @param   { int }                 dDepth    How many cells have been decided so far.
+ * @param   { int }                 dMines    How many of those are mines.
+ * @return  { int }                           Whether the search finished within the budget.
+*/
+int Probability_search(Solver *pSolver, ProbabilityTask *pTask, int dDepth, int dMines) {
+  int k, dCell, bMine, bFeasible;
+
+  if(--pTask->dBudget < 0)
+    return 0;
+
+  // A complete arrangement
+  if(dDepth == pTask->nGroup) {
+    pTask->aWays[dMines] += 1;
+
+    for(k = 0; k < pTask->nGroup; k++)
+      if(pSolver->aValues[pTask->aGroup[k]] == 1)
+        pTask->aCellWays[k * (pTask->nGroup + 1) + dMines] += 1;
+
+    return 1;
+  }
+
+  dCell = pTask->aGroup[dDepth];
+
+  for(bMine = 0; bMine <= 1; bMine++) {
+    bFeasible = Solver_decide(pSolver, dCell, bMine);
+
+    if(bFeasible && !Probability_search(pSolver, pTask, dDepth + 1, dMines + bMine)) {
+      Solver_undecide(pSolver, dCell);
+      return 0;
+    }
+
+    Solver_undecide(pSolver, dCell);
+  }
+
+  return 1;
+}
+
+/**
+ * Puts the cells of a group in breadth-first order, going from each cell to the numbers it touches.
+ * Neighbouring cells end up next to each other, so the search finishes off each number soon after starting it,
+ *    and a dead end gets noticed a few cells in instead of a whole row later.
+ *
+ * @param   { Solver * }  pSolver   The solver holding the frontier.
+ * @param   { int * }     aGroup    The cells of the group; these get reordered.
+ * @param   { int }       nGroup    How many cells the group has.
+ * @param   { int * }     aQueue    Space for nGroup cells.
+*/
+void Probability_orderGroup(Solver *pSolver, int *aGroup, int nGroup, int *aQueue) {
+  int dHead, dTail, l, m, dCell;
+  SolverConstraint *pConstraint;
+
+  // aValues marks the cells already queued
+  aQueue[0] = aGroup[0];
+  pSolver->aValues[aGroup[0]] = 1;
+
+  for(dHead = 0, dTail = 1; dHead < dTail; dHead++) {
+    dCell = aQueue[dHead];
+
+    for(l = 0; l < pSolver->aLinkCounts[dCell]; l++) {
+      pConstraint = &pSolver->aConstraints[pSolver->aLinks[dCell * SOLVER_MAX_NEIGHBORS + l]];
+
+      for(m = 0; m < pConstraint->nCells; m++) {
+        if(pSolver->aValues[pConstraint->aCells[m]] != 1) {
+          pSolver->aValues[pConstraint->aCells[m]] = 1;
+          aQueue[dTail++] = pConstraint->aCells[m];
+        }
+      }
+    }
+  }
+
+  for(l = 0; l < nGroup; l++)
+    aGroup[l] = aQueue[l];
+}
+
+/**
+ * Takes the next task nobody is working on.
+ *
+ * @param   { Probability * }   this    The calculator.
+ * @return  { int }                     The index of the task, or -1 if they've all been taken.
+*/
+int Probability_takeTask(Probability *this) {
+  int dTask;
+
+  Probability_lock(this);
+  dTask = this->dNextTask < this->nTasks ? this->dNextTask++ : -1;
+  Probability_unlock(this);
+
+  return dTask;
+}
+
+/**
+ * Counts the arrangements of a task's group.
+ *
+ * @param   { Probability * }   this    The calculator.
+ * @param   { int }             dTask   The index of the task.
+*/
+void Probability_runTask(Probability *this, int dTask) {
+  ProbabilityTask *pTask = &this->aTasks[dTask];
+
+  pTask->dBudget = PROBABILITY_BUDGET;
+  pTask->bIsExact = Probability_search(&this->solver, pTask, 0, 0);
+
+  Probability_lock(this);
+  this->dTasksDone++;
+
+  // Whoever handed the tasks out is waiting for this
+  if(this->dTasksDone == this->nTasks && this->pDoneSignal != NULL)
+    Signal_raise(this->pDoneSignal);
+
+  Probability_unlock(this);
+}
+
+/**
+ * The routine of a worker thread: it helps with whatever tasks are left.
+ * The worker sleeps on its signal in between, so it only runs when tasks are handed out.
+ *
+ * @param   { p_obj }   pArgs_Probability   The calculator.
+ * @param   { int }     tArg_Worker         Which worker this is.
+*/
+void Probability_work(p_obj pArgs_Probability, int tArg_Worker) {
+  Probability *this = (Probability *) pArgs_Probability;
+  int dTask;
+
+  while((dTask = Probability_takeTask(this)) >= 0)
+    Probability_runTask(this, dTask);
+}
+
+// The job thread works the chances out with Probability_compute(), which comes later on
+void Probability_job(p_obj pArgs_Probability, int tArg_NULL);
+
+/**
+ * Starts the worker threads, and the job thread that handles posted boards.
+ *
+ * @param   { Probability * }   this    The calculator.
+*/
+void Probability_start(Probability *this) {
+  int i;
+  char sThreadKey[STRING_KEY_MAX_LENGTH];
+  char sMutexKey[STRING_KEY_MAX_LENGTH];
+  char sSignalKey[STRING_KEY_MAX_LENGTH];
+
+  if(this->bIsRunning || this->pThreadManager == NULL)
+    return;
+
+  // The workers lock the task list as soon as they start, so this has to be set first
+  ThreadManager_createMutex(this->pThreadManager, PROBABILITY_POOL_MUTEX);
+  this->pDoneSignal = Signal_create(PROBABILITY_DONE_SIGNAL);
+  this->bIsRunning = 1;
+
+  for(i = 0; i < PROBABILITY_WORKERS; i++) {
+    sprintf(sThreadKey, "%s-%d", PROBABILITY_WORKER_THREAD, i);
+    sprintf(sMutexKey, "%s-%d", PROBABILITY_WORKER_MUTEX, i);
+    sprintf(sSignalKey, "%s-%d", PROBABILITY_WORKER_SIGNAL, i);
+
+    // A signal only wakes one thread up, so each worker gets its own
+    this->aWorkSignals[i] = Signal_create(sSignalKey);
+
+    ThreadManager_createMutex(this->pThreadManager, sMutexKey);
+    ThreadManager_createThread(this->pThreadManager, sThreadKey, sMutexKey, Probability_work, this, i);
+    ThreadManager_setThreadSignal(this->pThreadManager, sThreadKey, this->aWorkSignals[i]);
+    ThreadManager_setThreadSleep(this->pThreadManager, sThreadKey, PROBABILITY_SLEEP);
+  }
+
+  // The job thread hands the groups out, so the workers above have to exist first
+  this->pJobSignal = Signal_create(PROBABILITY_JOB_SIGNAL);
+
+  ThreadManager_createMutex(this->pThreadManager, PROBABILITY_JOB_MUTEX);
+  ThreadManager_createThread(this->pThreadManager, PROBABILITY_JOB_THREAD, PROBABILITY_JOB_MUTEX, Probability_job, this, 0);
+  ThreadManager_setThreadSignal(this->pThreadManager, PROBABILITY_JOB_THREAD, this->pJobSignal);
+  ThreadManager_setThreadSleep(this->pThreadManager, PROBABILITY_JOB_THREAD, PROBABILITY_SLEEP);
+}
+
+/**
+ * Orders the tasks from the biggest group down, so the slowest ones get started first.
+ *
+ * @param   { const void * }  pA  The first task.
+ * @param   { const void * }  pB  The second task.
+ * @return  { int }               Which one goes first.
+*/
+int Probability_compareTasks(const void *pA, const void *pB) {
+  return ((ProbabilityTask *) pB)->nGroup - ((ProbabilityTask *) pA)->nGroup;
+}
+
+/**
+ * Splits the frontier into tasks and gets them all counted.
+ * The caller works on the tasks too, so this never has to wait for a sleeping worker to wake up.
+ *
+ * @param   { Probability * }   this    The calculator.
+ * @return  { int }                     Whether every group could be counted.
+*/
+int Probability_countGroups(Probability *this) {
+  Solver *pSolver = &this->solver;
+  ProbabilityTask *pTask;
+  int g, k, nGroups, dTask, bIsDone;
+  size_t dWays = 0;
+  double *pWays;
+
+  nGroups = this->nGroups = Solver_group(pSolver);
+
+  for(k = 0; k < pSolver->nCells; k++)
+    pSolver->aValues[k] = 0;
+
+  // The groups are laid out now, so aParents is free to use as the queue
+  for(g = 0; g < nGroups; g++)
+    Probability_orderGroup(pSolver, pSolver->aOrder + pSolver->aStarts[g],
+      pSolver->aStarts[g + 1] - pSolver->aStarts[g], pSolver->aParents);
+
+  for(k = 0; k < pSolver->nCells; k++)
+    pSolver->aValues[k] = -1;
+
+  for(k = 0; k < pSolver->nConstraints; k++) {
+    pSolver->aConstraints[k].dAssigned = 0;
+    pSolver->aConstraints[k].dUnassigned = pSolver->aConstraints[k].nCells;
+  }
+
+  // Lay out the tasks and the space for their counts
+  free(this->aTasks);
+  free(this->aWays);
+  this->aTasks = calloc(nGroups + 1, sizeof(*this->aTasks));
+
+  for(g = 0; g < nGroups; g++) {
+    pTask = &this->aTasks[g];
+    pTask->aGroup = pSolver->aOrder + pSolver->aStarts[g];
+    pTask->nGroup = pSolver->aStarts[g + 1] - pSolver->aStarts[g];
+    dWays += (size_t) (pTask->nGroup + 1) * (pTask->nGroup + 1);
+  }
+
+  qsort(this->aTasks, nGroups, sizeof(*this->aTasks), Probability_compareTasks);
+
+  this->aWays = calloc(dWays + 1, sizeof(*this->aWays));
+
+  for(g = 0, pWays = this->aWays; g < nGroups; g++) {
+    pTask = &this->aTasks[g];
+    pTask->aWays = pWays;
+    pTask->aCellWays = pWays + pTask->nGroup + 1;
+    pWays += (size_t) (pTask->nGroup + 1) * (pTask->nGroup + 1);
+  }
+
+  // Hand the tasks out
+  Probability_lock(this);
+  this->nTasks = nGroups;
+  this->dNextTask = 0;
+  this->dTasksDone = 0;
+  Probability_unlock(this);
+
+  // Only wake the workers if there's more than we'd finish on our own
+  if(this->bIsRunning && nGroups > 1)
+    for(g = 0; g < PROBABILITY_WORKERS; g++)
+      Signal_raise(this->aWorkSignals[g]);
+
+  while((dTask = Probability_takeTask(this)) >= 0)
+    Probability_runTask(this, dTask);
+
+  // Wait for the ones the workers took
+  while(1) {
+    Probability_lock(this);
+    bIsDone = this->dTasksDone == this->nTasks;
+    Probability_unlock(this);
+
+    if(bIsDone)
+      break;
+
+    Signal_wait(this->pDoneSignal, PROBABILITY_SLEEP);
+  }
+
+  Probability_lock(this);
+  this->nTasks = 0;
+  Probability_unlock(this);
+
+  for(g = 0; g < nGroups; g++)
+    if(!this->aTasks[g].bIsExact)
+      return 0;
+
+  return 1;
+}
+
+/**
+ * //
+ * ////
+ * //////    Combining
+ * ////////
+ * //////////
+*/
+
+/**
+ * Scales an array so its biggest entry is 1.
+ * Only the ratios between arrangements matter, so this just keeps the numbers within range.
+ *
+ * @param   { double * }  aValues   The array to scale.
+ * @param   { int }       nValues   Its length.
+*/
+void Probability_normalize(double *aValues, int nValues) {
+  int i;
+  double dMax = 0;
+
+  for(i = 0; i < nValues; i++)
+    if(aValues[i] > dMax)
+      dMax = aValues[i];
+
+  if(dMax > 0)
+    for(i = 0; i < nValues; i++)
+      aValues[i] /= dMax;
+}
+
+/**
+ * Multiplies the counts of a group by x^k, where k is the number of mines, then scales them back into range.
+ * See Probability_combine() for why.
+ *
+ * @param   { ProbabilityTask * }   pTask       The group to modify.
+ * @param   { double }              dLogTilt    The logarithm of x.
+*/
+void Probability_tilt(ProbabilityTask *pTask, double dLogTilt) {
+  int k, c, n = pTask->nGroup + 1;
+  double dLogMax = -INFINITY, dScale;
+
+  for(c = 0; c < n; c++)
+    if(pTask->aWays[c] > 0 && log(pTask->aWays[c]) + c * dLogTilt > dLogMax)
+      dLogMax = log(pTask->aWays[c]) + c * dLogTilt;
+
+  for(c = 0; c < n; c++) {
+    dScale = exp(c * dLogTilt - dLogMax);
+    pTask->aWays[c] *= dScale;
+
+    for(k = 0; k < pTask->nGroup; k++)
+      pTask->aCellWays[k * n + c] *= dScale;
+  }
+}
+
+/**
+ * Works out the chance of every unknown tile being a mine.
+ *
+ * Say the groups are g = 0, 1, ..., G - 1, and the frontier holds j mines in total. Then the
+ *    interior can hold the other (M - j) mines in C(I, M - j) ways, where I is the size of the interior.
+ * Let Before_g be the ways the groups before g can hold each number of mines (a running convolution),
+ *    and After_g(j) be the ways the groups from g on can be arranged, times the interior's ways,
+ *    given that j mines are already used up before them. That gives
+ *
+ *    After_g(j) = sum over c of Ways_g(c) * After_(g + 1)(j + c),    After_G(j) = C(I, M - j)
+ *
+ *    and the weight of group g holding k mines is the sum over j of Before_g(j) * After_(g + 1)(j + k).
+ * Each array only ever gets scaled by a constant, which cancels out in the chances.
+ *
+ * On big boards, C(I, M - j) falls off by a near constant factor x for every extra mine j, so the
+ *    entries the last groups need would underflow long before we got to them. Counting each
+ *    arrangement of k mines as x^k times its ways, and C(I, M - j) as x^-j times its value, cancels
+ *    that out without changing any of the products above.
+ *
+ * @param   { Probability * }   this        The calculator.
+ * @param   { int }             dMines      The mines hidden among the unknowns.
+ * @param   { int }             dInterior   How many unknowns are off the frontier.
+ * @return  { int }                         Whether the field was consistent.
+*/
+int Probability_combine(Probability *this, int dMines, int dInterior) {
+  Solver *pSolver = &this->solver;
+  Field *pField = pSolver->pField;
+  ProbabilityTask *pTask;
+  int g, j, k, c, dCell, nGroups = this->nGroups;
+  int *aLeast, *aMost;
+  double **aAfter, *aBefore, *aNext, *aWeights;
+  double dLogBinomial, dLogMax = -INFINITY, dLogTilt = 0, dTotal = 0, dChance, dInteriorMines = 0;
+
+  // The fewest and most mines the groups before each one can hold; nothing outside that is ever needed
+  aLeast = calloc(nGroups + 1, sizeof(*aLeast));
+  aMost = calloc(nGroups + 1, sizeof(*aMost));
+
+  for(g = 0; g < nGroups; g++) {
+    pTask = &this->aTasks[g];
+
+    for(pTask->dLeast = 0; pTask->dLeast < pTask->nGroup && !pTask->aWays[pTask->dLeast]; pTask->dLeast++);
+    for(pTask->dMost = pTask->nGroup; pTask->dMost > 0 && !pTask->aWays[pTask->dMost]; pTask->dMost--);
+
+    aLeast[g + 1] = aLeast[g] + pTask->dLeast;
+    aMost[g + 1] = aMost[g] + pTask->dMost;
+
+    // A group that can't be arranged at all
+    if(!pTask->aWays[pTask->dLeast]) {
+      free(aLeast);
+      free(aMost);
+      return 0;
+    }
+  }
+
+  // How fast C(I, M - j) shrinks per mine, taken where the mines would be if they were spread evenly
+  j = (int) ((double) dMines * pSolver->nCells / (pSolver->nCells + dInterior));
+
+  if(j < dMines && dMines - j <= dInterior)
+    dLogTilt = log((double) (dMines - j) / (dInterior - dMines + j + 1));
+
+  for(g = 0; g < nGroups; g++)
+    Probability_tilt(&this->aTasks[g], dLogTilt);
+
+  // The interior's ways, as logarithms first so they can be scaled before leaving them
+  // Only their ratios matter, so each one is stepped to from the last: C(I, m - 1) = C(I, m) * m / (I - m + 1)
+  //    (this also stays clear of lgamma(), which isn't safe to call from several threads)
+  aAfter = calloc(nGroups + 1, sizeof(*aAfter));
+  aAfter[nGroups] = calloc(aMost[nGroups] - aLeast[nGroups] + 1, sizeof(**aAfter));
+
+  for(j = aLeast[nGroups], dLogBinomial = NAN; j <= aMost[nGroups]; j++) {
+    if(dMines - j < 0 || dMines - j > dInterior) {
+      aAfter[nGroups][j - aLeast[nGroups]] = -INFINITY;
+    } else {
+      dLogBinomial = isnan(dLogBinomial) ? 0 : dLogBinomial + log((double) (dMines - j + 1) / (dInterior - dMines + j));
+      aAfter[nGroups][j - aLeast[nGroups]] = dLogBinomial - j * dLogTilt;
+      dLogMax = fmax(dLogMax, aAfter[nGroups][j - aLeast[nGroups]]);
+    }
+  }
+
+  for(j = aLeast[nGroups]; j <= aMost[nGroups]; j++)
+    aAfter[nGroups][j - aLeast[nGroups]] = dLogMax == -INFINITY ? 0 : exp(aAfter[nGroups][j - aLeast[nGroups]] - dLogMax);
+
+  // Work the other After arrays out from the last group back
+  for(g = nGroups - 1; g > 0; g--) {
+    pTask = &this->aTasks[g];
+    aAfter[g] = calloc(aMost[g] - aLeast[g] + 1, sizeof(**aAfter));
+
+    for(j = aLeast[g]; j <= aMost[g]; j++)
+      for(c = pTask->dLeast; c <= pTask->dMost; c++)
+        aAfter[g][j - aLeast[g]] += pTask->aWays[c] * aAfter[g + 1][j + c - aLeast[g + 1]];
+
+    Probability_normalize(aAfter[g], aMost[g] - aLeast[g] + 1);
+  }
+
+  // Then go forward, working out each group's weights as we build up Before
+  aBefore = calloc(aMost[nGroups] - aLeast[nGroups] + 1, sizeof(*aBefore));
+  aNext = calloc(aMost[nGroups] - aLeast[nGroups] + 1, sizeof(*aNext));
+  aWeights = calloc(pSolver->nCells + 1, sizeof(*aWeights));
+  aBefore[0] = 1;
+
+  for(g = 0; g < nGroups; g++) {
+    pTask = &this->aTasks[g];
+
+    for(k = pTask->dLeast, dTotal = 0; k <= pTask->dMost; k++) {
+      for(j = aLeast[g], aWeights[k] = 0; j <= aMost[g]; j++)
+        aWeights[k] += aBefore[j - aLeast[g]] * aAfter[g + 1][j + k - aLeast[g + 1]];
+
+      dTotal += pTask->aWays[k] * aWeights[k];
+    }
+
+    // Contradicting numbers (or wrong flags)
+    if(dTotal <= 0)
+      break;
+
+    for(k = 0; k < pTask->nGroup; k++) {
+      dCell = pSolver->aCells[pTask->aGroup[k]];
+
+      for(c = pTask->dLeast, dChance = 0; c <= pTask->dMost; c++)
+        dChance += pTask->aCellWays[k * (pTask->nGroup + 1) + c] * aWeights[c];
+
+      this->aChances[dCell] = dChance / dTotal;
+    }
+
+    // Before_(g + 1) = Before_g convolved with Ways_g
+    for(j = aLeast[g + 1]; j <= aMost[g + 1]; j++)
+      aNext[j - aLeast[g + 1]] = 0;
+
+    for(j = aLeast[g]; j <= aMost[g]; j++)
+      for(c = pTask->dLeast; c <= pTask->dMost; c++)
+        aNext[j + c - aLeast[g + 1]] += aBefore[j - aLeast[g]] * pTask->aWays[c];
+
+    for(j = aLeast[g + 1]; j <= aMost[g + 1]; j++)
+      aBefore[j - aLeast[g + 1]] = aNext[j - aLeast[g + 1]];
+
+    Probability_normalize(aBefore, aMost[g + 1] - aLeast[g + 1] + 1);
+  }
+
+  // The interior shares whatever the frontier leaves over
+  if(g == nGroups) {
+    for(j = aLeast[nGroups], dTotal = 0; j <= aMost[nGroups]; j++) {
+      dChance = aBefore[j - aLeast[nGroups]] * aAfter[nGroups][j - aLeast[nGroups]];
+      dTotal += dChance;
+      dInteriorMines += dChance * (dMines - j);
+    }
+  }
+
+  if(dTotal > 0 && dInterior > 0) {
+    for(dCell = 0; dCell < pField->dWidth * pField->dHeight; dCell++)
+      if(Grid_getBit(pSolver->pUnknown, dCell % pField->dWidth, dCell / pField->dWidth) &&
+        !Grid_getBit(pSolver->pFrontier, dCell % pField->dWidth, dCell / pField->dWidth))
+        this->aChances[dCell] = dInteriorMines / dTotal / dInterior;
+  }
+
+  for(g = 0; g <= nGroups; g++)
+    free(aAfter[g]);
+
+  free(aAfter);
+  free(aBefore);
+  free(aNext);
+  free(aWeights);
+  free(aLeast);
+  free(aMost);
+
+  return dTotal > 0;
+}
+
+/**
+ * //
+ * ////
+ * //////    Probability functions
+ * ////////
+ * //////////
+*/
+
+/**
+ * Works out the chance of every unknown tile of a field being a mine.
+ * Flags are taken to be correct. The results end up in aChances, which is -1 for inspected or flagged tiles.
+ *
+ * @param   { Probability * }   this      The calculator.
+ * @param   { Field * }         pField    The field to read.
+ * @return  { int }                       Whether the chances could be worked out exactly.
+*/
+int Probability_compute(Probability *this, Field *pField) {
+  int i, dCells = pField->dWidth * pField->dHeight;
+  int dMines, dInterior;
+  Solver *pSolver = &this->solver;
+
+  // The solver is tied to a field of a given size
+  if(this->pField != pField ||
+    this->solver.pSafe->dWidth != pField->dWidth ||
+    this->solver.pSafe->dHeight != pField->dHeight) {
+
+    if(this->pField != NULL)
+      Solver_exit(pSolver);
+
+    Solver_init(pSolver, pField);
+    this->pField = pField;
+  }
+
+  free(this->aChances);
+  this->aChances = calloc(dCells + 1, sizeof(*this->aChances));
+
+  for(i = 0; i < dCells; i++)
+    this->aChances[i] = -1;
+
+  // Whatever the cheap rules prove is the same in every arrangement, so it can come off the frontier first;
+  //    this splits long frontiers into much smaller groups
+  Solver_clear(pSolver);
+
+  do Solver_build(pSolver);
+  while(pSolver->nConstraints && (Solver_applySingle(pSolver) || Solver_applyPairs(pSolver)));
+
+  for(i = 0; i < dCells; i++) {
+    if(Grid_getBit(pSolver->pMines, i % pField->dWidth, i / pField->dWidth))
+      this->aChances[i] = 1;
+    else if(Grid_getBit(pSolver->pSafe, i % pField->dWidth, i / pField->dWidth))
+      this->aChances[i] = 0;
+  }
+
+  // Then count the groups of what's left
+  this->bIsExact = Probability_countGroups(this);
+
+  if(!this->bIsExact)
+    return 0;
+
+  dMines = pField->dMines - Grid_getCount(pField->pFlagGrid) - Grid_getCount(pSolver->pMines);
+  dInterior = Grid_getCount(pSolver->pUnknown) - pSolver->nCells;
+
+  this->bIsExact = Probability_combine(this, dMines, dInterior);
+
+  return this->bIsExact;
+}
+
+/**
+ * Returns the chance of a tile being a mine, as of the last Probability_compute().
+ *
+ * @param   { Probability * }   this    The calculator.
+ * @param   { int }             x       The x-coordinate of the tile.
+ * @param   { int }             y       The y-coordinate of the tile.
+ * @return  { double }                  The chance, or -1 if it's not an unknown tile or it couldn't be worked out.
+*/
+double Probability_get(Probability *this, int x, int y) {
+  if(!this->bIsExact || this->pField == NULL ||
+    x < 0 || x >= this->pField->dWidth || y < 0 || y >= this->pField->dHeight)
+    return -1;
+
+  return this->aChances[y * this->pField->dWidth + x];
+}
+
+/**
+ * //
+ * ////
+ * //////    Background jobs
+ * ////////
+ * //////////
+*/
+
+/**
+ * The routine of the job thread: it works out the chances of the latest posted board and publishes them.
+ * Boards posted while it's busy are skipped, except for the very last one.
+ *
+ * @param   { p_obj }   pArgs_Probability   The calculator.
+ * @param   { int }     tArg_NULL           A dummy value.
+*/
+void Probability_job(p_obj pArgs_Probability, int tArg_NULL) {
+  Probability *this = (Probability *) pArgs_Probability;
+  int dBoard, dCells;
+
+  // Take the latest board, if there's one we haven't done yet
+  Probability_lock(this);
+  dBoard = this->dPosted;
+
+  if(dBoard != this->dTaken)
+    Field_copy(&this->jobField, &this->postField);
+
+  Probability_unlock(this);
+
+  if(dBoard == this->dTaken)
+    return;
+
+  this->dTaken = dBoard;
+  Probability_compute(this, &this->jobField);
+
+  // Publish the chances
+  dCells = this->jobField.dWidth * this->jobField.dHeight;
+
+  Probability_lock(this);
+  free(this->aPublished);
+  this->aPublished = calloc(dCells + 1, sizeof(*this->aPublished));
+  memcpy(this->aPublished, this->aChances, dCells * sizeof(*this->aPublished));
+  this->dPublishedWidth = this->jobField.dWidth;
+  this->dPublishedHeight = this->jobField.dHeight;
+  this->bIsPublishedExact = this->bIsExact;
+  this->dFinished = dBoard;
+  Probability_unlock(this);
+
+  if(this->pReadySignal != NULL)
+    Signal_raise(this->pReadySignal);
+}
+
+/**
+ * Hands a board over to the job thread, which works out its chances in the background.
+ * The board is copied, so it can change right after. Without the threads, the chances are worked out right away.
+ *
+ * @param   { Probability * }   this      The calculator.
+ * @param   { Field * }         pField    The field to work the chances out for.
+*/
+void Probability_post(Probability *this, Field *pField) {
+  Probability_lock(this);
+  Field_copy(&this->postField, pField);
+  this->dPosted++;
+  Probability_unlock(this);
+
+  if(this->bIsRunning)
+    Signal_raise(this->pJobSignal);
+  else
+    Probability_job(this, 0);
+}
+
+/**
+ * Returns the chance of a tile being a mine, as of the last posted board the job thread finished.
+ *
+ * @param   { Probability * }   this      The calculator.
+ * @param   { int }             x         The x-coordinate of the tile.
+ * @param   { int }             y         The y-coordinate of the tile.
+ * @param   { int * }           pIsStale  Set to whether a newer board was posted since.
+ * @return  { double }                    The chance, or -1 if it's not an unknown tile or it couldn't be worked out.
+*/
+double Probability_read(Probability *this, int x, int y, int *pIsStale) {
+  double dChance = -1;
+
+  Probability_lock(this);
+  *pIsStale = this->dFinished != this->dPosted;
+
+  if(this->aPublished != NULL && this->bIsPublishedExact &&
+    x >= 0 && x < this->dPublishedWidth && y >= 0 && y < this->dPublishedHeight)
+    dChance = this->aPublished[y * this->dPublishedWidth + x];
+
+  Probability_unlock(this);
+
+  return dChance;
+}
+
+/**
+ * Checks whether the job thread has caught up with every board posted so far.
+ *
+ * @param   { Probability * }   this    The calculator.
+ * @return  { int }                     Whether or not the published chances are the latest ones.
+*/
+int Probability_isDone(Probability *this) {
+  int bIsDone;
+
+  Probability_lock(this);
+  bIsDone = this->dFinished == this->dPosted;
+  Probability_unlock(this);
+
+  return bIsDone;
+}
+
+/**
+ * Sets the signal to raise whenever new chances are published.
+ *
+ * @param   { Probability * }   this          The calculator.
+ * @param   { Signal * }        pReadySignal  The signal to raise.
+*/
+void Probability_setReadySignal(Probability *this, Signal *pReadySignal) {
+  this->pReadySignal = pReadySignal;
+}
+
+#endif
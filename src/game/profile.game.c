@@ -392,6 +392,10 @@ int Profile_delete(Profile *this, char *sUsername) {
 		return 0;
 	}
 
+	// The replays go with it, if there are any
+	sprintf(sProfilePath, "%s%s.replays.bin", PROFILE_FOLDER_PATH, sUsername);
+	File_remove(sProfilePath);
+
 	// Set the current profile to an empty string
 	strcpy(this->sCurrentProfile, "");
 
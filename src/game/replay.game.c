@@ -0,0 +1,370 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 17:40:12
+ * @ Modified time: 2026-10-16 17:40:12
+ * @ Description:
+ *
+ * Plays a move log back through the same Game_* functions the player used, as fast as it can.
+ * Every action is checked as it goes, and the outcome and time the log claims are checked at the
+ *    end, so a log that doesn't add up (edited by hand, or from an older build that behaved
+ *    differently) is reported along with the reason.
+ */
+
+#ifndef GAME_REPLAY_
+#define GAME_REPLAY_
+
+#include "./game.c"
+#include "./history.obj.h"
+#include "./movelog.obj.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define REPLAY_TIME_SLACK 2       // Game times are in whole seconds and start a bit before the log does
+#define REPLAY_MAX_SIDE (1 << 12) // Anything bigger didn't come from this game
+
+typedef struct Replay Replay;
+
+/**
+ * //
+ * ////
+ * //////    Replay struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * A log being played back.
+ * This is not a class; whoever replays a log keeps one around with the game it's played on.
+ *
+ * @struct
+*/
+struct Replay {
+  Game *pGame;                  // The game the log is played on
+  MoveLogReader reader;         // Where we are in the log
+
+  char *sError;                 // Why the log is wrong, or NULL if nothing's wrong so far
+  int bIsDone;                  // Whether the end of the log has been reached
+  int bIsPaused;
+
+  int nActions;                 // How many actions have been played
+  int64_t dTime;                // Milliseconds since the start, without the pauses
+  int64_t dEndTime;             // When the game last ended, in the same milliseconds
+
+  int dClaimedOutcome;          // What the log says happened
+  int dClaimedTime;             // In seconds
+};
+
+/**
+ * Marks the replay as failed.
+ * Only the first reason is kept.
+ *
+ * @param   { Replay * }  this      The replay.
+ * @param   { char * }    sError    Why it failed.
+ * @return  { int }                 Always 0, so callers can return it.
+*/
+int Replay_fail(Replay *this, char *sError) {
+  if(this->sError == NULL)
+    this->sError = sError;
+
+  this->bIsDone = 1;
+
+  return 0;
+}
+
+/**
+ * Reads the header of a log and sets up the game it describes.
+ * Classic boards get the seed of the log; custom boards get their mines straight from it.
+ * No-guess games don't need the no-guess search again, since any seed it found is in the log.
+ *
+ * @param   { Replay * }    this      The replay to start.
+ * @param   { Game * }      pGame     The game to play on. It should start out zeroed, like any game.
+ * @param   { uint8_t * }   pBytes    The log. It isn't copied, so it has to outlive the replay.
+ * @param   { size_t }      dLength   The length of the log.
+ * @return  { int }                   Whether or not the header made sense.
+*/
+int Replay_start(Replay *this, Game *pGame, uint8_t *pBytes, size_t dLength) {
+  MoveLogReader *pReader = &this->reader;
+  int i, dType, dDifficulty, dBoard;
+  uint64_t dWidth, dHeight, dMines, dSeed = 0;
+  uint8_t *pMagic, *pMines;
+
+  this->pGame = pGame;
+  this->sError = NULL;
+  this->bIsDone = 0;
+  this->bIsPaused = 0;
+  this->nActions = 0;
+  this->dTime = 0;
+  this->dEndTime = 0;
+  this->dClaimedOutcome = GAME_OUTCOME_PENDING;
+  this->dClaimedTime = 0;
+
+  MoveLogReader_init(pReader, pBytes, dLength);
+
+  pMagic = MoveLogReader_readBytes(pReader, MOVELOG_MAGIC_LENGTH);
+
+  if(pMagic == NULL || memcmp(pMagic, MOVELOG_MAGIC, MOVELOG_MAGIC_LENGTH))
+    return Replay_fail(this, "not a move log");
+
+  if(MoveLogReader_readVarint(pReader) != MOVELOG_VERSION)
+    return Replay_fail(this, "unknown version");
+
+  dType = MoveLogReader_readVarint(pReader);
+  dDifficulty = MoveLogReader_readVarint(pReader);
+  dWidth = MoveLogReader_readVarint(pReader);
+  dHeight = MoveLogReader_readVarint(pReader);
+  dMines = MoveLogReader_readVarint(pReader);
+  dBoard = MoveLogReader_readVarint(pReader);
+
+  if(dBoard == MOVELOG_BOARD_SEED)
+    dSeed = MoveLogReader_readVarint(pReader);
+
+  if(pReader->bIsBroken)
+    return Replay_fail(this, "header cut short");
+
+  if(dWidth < 1 || dHeight < 1 || dWidth > REPLAY_MAX_SIDE || dHeight > REPLAY_MAX_SIDE || dMines > dWidth * dHeight)
+    return Replay_fail(this, "bad board size");
+
+  if(dType != GAME_TYPE_CLASSIC && dType != GAME_TYPE_CUSTOM)
+    return Replay_fail(this, "unknown game type");
+
+  Game_setup(pGame, dType, dDifficulty);
+  Game_setNoGuess(pGame, 0);
+
+  switch(dBoard) {
+
+    // Classic boards come from the difficulty, and get their mines on the first inspect
+    case MOVELOG_BOARD_SEED:
+      if(dType != GAME_TYPE_CLASSIC)
+        return Replay_fail(this, "only classic boards have seeds");
+
+      Game_setSeed(pGame, dSeed);
+      Game_init(pGame);
+
+      if(pGame->field.dWidth != (int) dWidth || pGame->field.dHeight != (int) dHeight || pGame->field.dMines != (int) dMines)
+        return Replay_fail(this, "board doesn't match its difficulty");
+    break;
+
+    // The mines are all there
+    case MOVELOG_BOARD_MINES:
+      pMines = MoveLogReader_readBytes(pReader, ((size_t) dWidth * dHeight + 7) / 8);
+
+      if(pMines == NULL)
+        return Replay_fail(this, "mines cut short");
+
+      Field_init(&pGame->field, dWidth, dHeight);
+
+      for(i = 0; i < (int) (dWidth * dHeight); i++)
+        if(pMines[i >> 3] >> (i & 7) & 1)
+          Grid_setBit(pGame->field.pMineGrid, i % dWidth, i / dWidth, 1);
+
+      pGame->field.dMines = Grid_getCount(pGame->field.pMineGrid);
+
+      if(pGame->field.dMines != (int) dMines)
+        return Replay_fail(this, "mine count doesn't match the mines");
+
+      Game_init(pGame);
+    break;
+
+    default:
+      return Replay_fail(this, "unknown board");
+  }
+
+  return 1;
+}
+
+/**
+ * Reads the tile of an action and moves the cursor there.
+ *
+ * @param   { Replay * }  this    The replay.
+ * @param   { int * }     x       Where to put the x-coordinate.
+ * @param   { int * }     y       Where to put the y-coordinate.
+ * @return  { int }               Whether or not the tile is on the board.
+*/
+int Replay_readTile(Replay *this, int *x, int *y) {
+  uint64_t dX = MoveLogReader_readVarint(&this->reader);
+  uint64_t dY = MoveLogReader_readVarint(&this->reader);
+
+  if(this->reader.bIsBroken)
+    return Replay_fail(this, "action cut short");
+
+  if(dX >= (uint64_t) this->pGame->field.dWidth || dY >= (uint64_t) this->pGame->field.dHeight)
+    return Replay_fail(this, "tile off the board");
+
+  *x = this->pGame->dCursorX = dX;
+  *y = this->pGame->dCursorY = dY;
+
+  return 1;
+}
+
+/**
+ * Plays the next action of the log.
+ *
+ * @param   { Replay * }  this    The replay.
+ * @return  { int }               Whether there's more to play.
+*/
+int Replay_step(Replay *this) {
+  Game *pGame = this->pGame;
+  uint64_t dEntry;
+  int64_t dDelta;
+  int x, y, bWasDone;
+
+  if(this->bIsDone)
+    return 0;
+
+  if(MoveLogReader_isDone(&this->reader))
+    return Replay_fail(this, "log ends before the game does");
+
+  dEntry = MoveLogReader_readVarint(&this->reader);
+  dDelta = dEntry >> MOVELOG_ACTION_BITS;
+  bWasDone = Game_isDone(pGame);
+
+  if(this->reader.bIsBroken)
+    return Replay_fail(this, "action cut short");
+
+  if(!this->bIsPaused)
+    this->dTime += dDelta;
+
+  this->nActions++;
+
+  switch(dEntry & ((1 << MOVELOG_ACTION_BITS) - 1)) {
+
+    case MOVELOG_ACTION_INSPECT:
+      if(!Replay_readTile(this, &x, &y))
+        return 0;
+
+      if(bWasDone)
+        return Replay_fail(this, "inspect after the game ended");
+
+      if(Grid_getBit(pGame->field.pFlagGrid, x, y))
+        return Replay_fail(this, "inspect on a flag");
+
+      Game_inspect(pGame, x, y);
+    break;
+
+    case MOVELOG_ACTION_FLAG:
+      if(!Replay_readTile(this, &x, &y))
+        return 0;
+
+      if(bWasDone)
+        return Replay_fail(this, "flag after the game ended");
+
+      if(Grid_getBit(pGame->field.pInspectGrid, x, y))
+        return Replay_fail(this, "flag on an inspected tile");
+
+      Game_addFlag(pGame);
+    break;
+
+    case MOVELOG_ACTION_UNFLAG:
+      if(!Replay_readTile(this, &x, &y))
+        return 0;
+
+      if(bWasDone)
+        return Replay_fail(this, "flag after the game ended");
+
+      if(!Grid_getBit(pGame->field.pFlagGrid, x, y))
+        return Replay_fail(this, "no flag to remove");
+
+      Game_removeFlag(pGame);
+    break;
+
+    case MOVELOG_ACTION_UNDO:
+      if(!Game_undo(pGame))
+        return Replay_fail(this, "nothing to undo");
+    break;
+
+    case MOVELOG_ACTION_REDO:
+      if(!Game_redo(pGame))
+        return Replay_fail(this, "nothing to redo");
+    break;
+
+    case MOVELOG_ACTION_PAUSE:
+      this->bIsPaused = !this->bIsPaused;
+    break;
+
+    case MOVELOG_ACTION_SEED:
+      if(pGame->bIsGenerated)
+        return Replay_fail(this, "seed after the board was made");
+
+      Game_setSeed(pGame, MoveLogReader_readVarint(&this->reader));
+    break;
+
+    case MOVELOG_ACTION_END:
+      this->dClaimedOutcome = MoveLogReader_readVarint(&this->reader);
+      this->dClaimedTime = MoveLogReader_readVarint(&this->reader);
+      this->bIsDone = 1;
+
+      if(this->reader.bIsBroken)
+        return Replay_fail(this, "end cut short");
+
+      if(!MoveLogReader_isDone(&this->reader))
+        return Replay_fail(this, "actions after the end");
+
+      // Quitting is the only ending that doesn't happen on the board
+      if(this->dClaimedOutcome == GAME_OUTCOME_QUIT && !Game_isDone(pGame)) {
+        Game_quit(pGame);
+        this->dEndTime = this->dTime;
+      }
+
+      if(this->dClaimedOutcome != (int) pGame->eOutcome)
+        return Replay_fail(this, "outcome doesn't match the moves");
+
+      if((int64_t) (this->dClaimedTime + REPLAY_TIME_SLACK) * 1000 < this->dEndTime ||
+        (int64_t) (this->dClaimedTime - REPLAY_TIME_SLACK) * 1000 > this->dEndTime)
+        return Replay_fail(this, "time doesn't match the moves");
+
+      return 0;
+
+    default:
+      return Replay_fail(this, "unknown action");
+  }
+
+  if(this->reader.bIsBroken)
+    return Replay_fail(this, "action cut short");
+
+  // The clock stops whenever the game ends, even if an undo starts it again later
+  if(Game_isDone(pGame) && !bWasDone)
+    this->dEndTime = this->dTime;
+
+  return 1;
+}
+
+/**
+ * Plays a whole log.
+ *
+ * @param   { Replay * }    this      The replay.
+ * @param   { Game * }      pGame     The game to play on.
+ * @param   { uint8_t * }   pBytes    The log.
+ * @param   { size_t }      dLength   The length of the log.
+ * @return  { int }                   Whether or not the log checks out.
+*/
+int Replay_run(Replay *this, Game *pGame, uint8_t *pBytes, size_t dLength) {
+  if(!Replay_start(this, pGame, pBytes, dLength))
+    return 0;
+
+  while(Replay_step(this));
+
+  return this->sError == NULL;
+}
+
+/**
+ * Sums up the board the replay ended on, so two builds can be checked against each other.
+ *
+ * @param   { Replay * }    this    The replay.
+ * @return  { uint64_t }            A hash of the mines, flags and inspections.
+*/
+uint64_t Replay_getHash(Replay *this) {
+  Field *pField = &this->pGame->field;
+  size_t i, nWords = HISTORY_PLANE_COUNT * Grid_getWordCount(pField->dWidth, pField->dHeight);
+  uint64_t *pWords = History_getPlanes(pField);
+  uint64_t dHash = nWords, dState;
+
+  for(i = 0; i < nWords; i++) {
+    dState = dHash ^ pWords[i];
+    dHash = Random_splitMix(&dState);
+  }
+
+  return dHash;
+}
+
+#endif
@@ -0,0 +1,772 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 11:20:45
+ * @ Modified time: 2026-10-16 14:02:37
+ * @ Description:
+ *
+ * A deterministic solver that plays a field the way a careful player would: it only ever
+ *    inspects or flags tiles that the visible numbers prove are safe or mined.
+ * If it can clear the whole board from the first click, the board never needs a guess.
+ *
+ * The solver reads the grids and numbers of the field directly. Every visible number next to
+ *    unknown tiles becomes a constraint ("these tiles hide this many mines"), and the constraints
+ *    are worked through in order of cost:
+ *
+ *    (1) single constraints that are already decided (no mines left, or every tile is a mine),
+ *    (2) pairs of overlapping constraints, where one of them accounts for the difference,
+ *    (3) every arrangement of mines that satisfies a connected group of constraints.
+ *
+ * What it proves is written onto two grids of its own; the field is only changed by Solver_apply().
+ */
+
+#ifndef GAME_SOLVER_
+#define GAME_SOLVER_
+
+#include "./field.obj.h"
+
+#include "../utils/utils.grid.h"
+#include "../utils/utils.types.h"
+
+#include <stdlib.h>
+
+#define SOLVER_MAX_NEIGHBORS 8                  // The most unknown neighbours a tile can have
+#define SOLVER_MAX_COMPONENT 64                 // The most unknowns we try to enumerate together
+#define SOLVER_ENUMERATION_BUDGET (1 << 16)     // How many partial arrangements we try per group
+
+typedef struct SolverConstraint SolverConstraint;
+typedef struct Solver Solver;
+
+/**
+ * //
+ * ////
+ * //////    Solver struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * A visible number and the unknown tiles around it.
+ *
+ * @struct
+*/
+struct SolverConstraint {
+  int dMines;                                   // How many mines the unknowns still hide
+  int nCells;                                   // How many unknowns there are
+  int aCells[SOLVER_MAX_NEIGHBORS];             // The frontier ids of the unknowns
+
+  int dAssigned;                                // The mines placed on it so far while enumerating
+  int dUnassigned;                              // The unknowns not yet decided while enumerating
+};
+
+/**
+ * The state of the solver.
+ * This is not a class; the buffers are kept between calls so solving after every move doesn't allocate.
+ *
+ * @struct
+*/
+struct Solver {
+  Field *pField;                                // The field being solved
+
+  Grid *pSafe;                                  // The unknown tiles proven to be safe
+  Grid *pMines;                                 // The unknown tiles proven to be mines (flags aren't included)
+
+  Grid *pUnknown;                               // The tiles that are neither inspected, flagged nor proven
+  Grid *pFrontier;                              // The unknowns next to at least one visible number
+
+  int nCells;                                   // The unknowns on the frontier
+  int *aCells;                                  // Their cell indices (y * width + x), in increasing order
+
+  int nConstraints;
+  SolverConstraint *aConstraints;
+
+  int *aLinks;                                  // The constraints of each frontier cell, SOLVER_MAX_NEIGHBORS apiece
+  int *aLinkCounts;                             // How many constraints each frontier cell has
+
+  int *aParents;                                // Joins the frontier cells into connected groups
+  int *aOrder;                                  // The frontier cells, grouped
+  int *aStarts;                                 // Where each group starts within aOrder
+  int *aValues;                                 // The arrangement being tried (-1 for undecided)
+  uint64_t *aMineCounts;                        // In how many arrangements each cell was a mine
+
+  int dCapacity;                                // How many cells or constraints the buffers can hold
+  uint64_t nSolutions;                          // How many arrangements the current group has
+  int dBudget;                                  // How many more steps the current group can take
+};
+
+/**
+ * Initializes the solver for a field.
+ *
+ * @param   { Solver * }  this      The solver to initialize.
+ * @param   { Field * }   pField    The field to solve.
+*/
+void Solver_init(Solver *this, Field *pField) {
+  this->pField = pField;
+
+  this->pSafe = Grid_create(pField->dWidth, pField->dHeight);
+  this->pMines = Grid_create(pField->dWidth, pField->dHeight);
+  this->pUnknown = Grid_create(pField->dWidth, pField->dHeight);
+  this->pFrontier = Grid_create(pField->dWidth, pField->dHeight);
+
+  this->nCells = 0;
+  this->nConstraints = 0;
+  this->dCapacity = 0;
+
+  this->aCells = NULL;
+  this->aConstraints = NULL;
+  this->aLinks = NULL;
+  this->aLinkCounts = NULL;
+  this->aParents = NULL;
+  this->aOrder = NULL;
+  this->aStarts = NULL;
+  this->aValues = NULL;
+  this->aMineCounts = NULL;
+}
+
+/**
+ * Frees the grids and buffers of the solver.
+ *
+ * @param   { Solver * }  this    The solver to clean up.
+*/
+void Solver_exit(Solver *this) {
+  Grid_kill(this->pSafe);
+  Grid_kill(this->pMines);
+  Grid_kill(this->pUnknown);
+  Grid_kill(this->pFrontier);
+
+  free(this->aCells);
+  free(this->aConstraints);
+  free(this->aLinks);
+  free(this->aLinkCounts);
+  free(this->aParents);
+  free(this->aOrder);
+  free(this->aStarts);
+  free(this->aValues);
+  free(this->aMineCounts);
+}
+
+/**
+ * Makes sure the buffers can hold a given number of cells and constraints.
+ *
+ * @param   { Solver * }  this      The solver to modify.
+ * @param   { int }       dNeeded   How many cells or constraints we need room for.
+*/
+void Solver_reserve(Solver *this, int dNeeded) {
+  if(dNeeded <= this->dCapacity)
+    return;
+
+  // Grow geometrically so this rarely happens
+  this->dCapacity = dNeeded > this->dCapacity * 2 ? dNeeded : this->dCapacity * 2;
+
+  this->aCells = realloc(this->aCells, this->dCapacity * sizeof(*this->aCells));
+  this->aConstraints = realloc(this->aConstraints, this->dCapacity * sizeof(*this->aConstraints));
+  this->aLinks = realloc(this->aLinks, this->dCapacity * SOLVER_MAX_NEIGHBORS * sizeof(*this->aLinks));
+  this->aLinkCounts = realloc(this->aLinkCounts, this->dCapacity * sizeof(*this->aLinkCounts));
+  this->aParents = realloc(this->aParents, this->dCapacity * sizeof(*this->aParents));
+  this->aOrder = realloc(this->aOrder, this->dCapacity * sizeof(*this->aOrder));
+  this->aStarts = realloc(this->aStarts, (this->dCapacity + 1) * sizeof(*this->aStarts));
+  this->aValues = realloc(this->aValues, this->dCapacity * sizeof(*this->aValues));
+  this->aMineCounts = realloc(this->aMineCounts, this->dCapacity * sizeof(*this->aMineCounts));
+}
+
+/**
+ * //
+ * ////
+ * //////    Frontier
+ * ////////
+ * //////////
+*/
+
+/**
+ * Turns a visible number into a constraint over its unknown neighbours.
+ * The flags and proven mines around it are taken off its count.
+ *
+ * @param   { Solver * }  this    The solver to modify.
+ * @param   { int }       x       The x-coordinate of the number.
+ * @param   { int }       y       The y-coordinate of the number.
+*/
+void Solver_addConstraint(Solver *this, int x, int y) {
+  int i, j;
+  Field *pField = this->pField;
+  SolverConstraint *pConstraint;
+
+  Solver_reserve(this, this->nConstraints + 1);
+
+  pConstraint = &this->aConstraints[this->nConstraints];
+  pConstraint->dMines = pField->aNumbers[y][x];
+  pConstraint->nCells = 0;
+
+  for(j = y - 1; j <= y + 1; j++) {
+    for(i = x - 1; i <= x + 1; i++) {
+      if(i < 0 || i >= pField->dWidth || j < 0 || j >= pField->dHeight)
+        continue;
+
+      if(Grid_getBit(pField->pFlagGrid, i, j) || Grid_getBit(this->pMines, i, j)) {
+        pConstraint->dMines--;
+
+      } else if(Grid_getBit(this->pUnknown, i, j)) {
+        pConstraint->aCells[pConstraint->nCells++] = j * pField->dWidth + i;
+        Grid_setBit(this->pFrontier, i, j, 1);
+      }
+    }
+  }
+
+  if(pConstraint->nCells)
+    this->nConstraints++;
+}
+
+/**
+ * Finds the frontier id of a cell.
+ *
+ * @param   { Solver * }  this    The solver to read.
+ * @param   { int }       dCell   The cell index (y * width + x).
+ * @return  { int }               Its position in aCells.
+*/
+int Solver_findCell(Solver *this, int dCell) {
+  int dLow = 0, dHigh = this->nCells - 1, dMid;
+
+  while(dLow < dHigh) {
+    dMid = (dLow + dHigh) / 2;
+
+    if(this->aCells[dMid] < dCell) dLow = dMid + 1;
+    else dHigh = dMid;
+  }
+
+  return dLow;
+}
+
+/**
+ * Collects the constraints of the field as it currently looks.
+ * The unknowns and the numbers next to them are found a word at a time; only those numbers are visited.
+ *
+ * @param   { Solver * }  this    The solver to modify.
+*/
+void Solver_build(Solver *this) {
+  int y, w, x, k, l, dRow, dCell;
+  uint64_t dNumbers, dNear, dTail, dFrontier;
+  Field *pField = this->pField;
+  Grid *pUnknown = this->pUnknown;
+  SolverConstraint *pConstraint;
+
+  dTail = Grid_getTailMask(pUnknown);
+
+  // The tiles we know nothing about
+  for(y = 0; y < pField->dHeight; y++)
+    for(w = 0; w < pUnknown->dStride; w++)
+      Grid_getRow(pUnknown, y)[w] = ~(
+        Grid_getRow(pField->pInspectGrid, y)[w] |
+        Grid_getRow(pField->pFlagGrid, y)[w] |
+        Grid_getRow(this->pSafe, y)[w] |
+        Grid_getRow(this->pMines, y)[w]) &
+        (w == pUnknown->dStride - 1 ? dTail : ~0ULL);
+
+  Grid_clear(this->pFrontier, 0);
+  this->nConstraints = 0;
+
+  // Every visible number that touches an unknown
+  for(y = 0; y < pField->dHeight; y++) {
+    for(w = 0; w < pUnknown->dStride; w++) {
+      dNumbers = Grid_getRow(pField->pInspectGrid, y)[w] &
+        ~Grid_getRow(pField->pZeroGrid, y)[w] &
+        ~Grid_getRow(pField->pMineGrid, y)[w];
+
+      for(dRow = y - 1, dNear = 0; dRow <= y + 1; dRow++)
+        if(dRow >= 0 && dRow < pField->dHeight)
+          dNear |= Grid_getRow(pUnknown, dRow)[w] |
+            Grid_getWordWest(pUnknown, dRow, w) |
+            Grid_getWordEast(pUnknown, dRow, w);
+
+      for(dNumbers &= dNear; dNumbers; dNumbers &= dNumbers - 1) {
+        x = (w << GRID_WORD_SHIFT) + __builtin_ctzll(dNumbers);
+        Solver_addConstraint(this, x, y);
+      }
+    }
+  }
+
+  // List the frontier in order
+  this->nCells = 0;
+
+  for(y = 0; y < pField->dHeight; y++) {
+    for(w = 0; w < pUnknown->dStride; w++) {
+      for(dFrontier = Grid_getRow(this->pFrontier, y)[w]; dFrontier; dFrontier &= dFrontier - 1) {
+        Solver_reserve(this, this->nCells + 1);
+        this->aCells[this->nCells++] = y * pField->dWidth + (w << GRID_WORD_SHIFT) + __builtin_ctzll(dFrontier);
+      }
+    }
+  }
+
+  // Point the constraints at the frontier ids, and the cells back at their constraints
+  for(k = 0; k < this->nCells; k++)
+    this->aLinkCounts[k] = 0;
+
+  for(k = 0; k < this->nConstraints; k++) {
+    pConstraint = &this->aConstraints[k];
+
+    for(l = 0; l < pConstraint->nCells; l++) {
+      dCell = Solver_findCell(this, pConstraint->aCells[l]);
+      pConstraint->aCells[l] = dCell;
+      this->aLinks[dCell * SOLVER_MAX_NEIGHBORS + this->aLinkCounts[dCell]++] = k;
+    }
+  }
+}
+
+/**
+ * Records that a frontier cell is safe or a mine.
+ *
+ * @param   { Solver * }  this    The solver to modify.
+ * @param   { int }       dId     The frontier id of the cell.
+ * @param   { int }       bMine   Whether the cell is a mine.
+ * @return  { int }               Whether this was news.
+*/
+int Solver_mark(Solver *this, int dId, int bMine) {
+  int x = this->aCells[dId] % this->pField->dWidth;
+  int y = this->aCells[dId] / this->pField->dWidth;
+
+  if(Grid_getBit(this->pSafe, x, y) || Grid_getBit(this->pMines, x, y))
+    return 0;
+
+  Grid_setBit(bMine ? this->pMines : this->pSafe, x, y, 1);
+
+  return 1;
+}
+
+/**
+ * //
+ * ////
+ * //////    Rules
+ * ////////
+ * //////////
+*/
+
+/**
+ * Applies the single-constraint rule.
+ * If a number's flags already account for it, the rest of its neighbours are safe;
+ *    if it needs every unknown neighbour to be a mine, they all are.
+ *
+ * @param   { Solver * }  this    The solver to use.
+ * @return  { int }               How many cells were proven.
+*/
+int Solver_applySingle(Solver *this) {
+  int k, l, nFound = 0;
+  SolverConstraint *pConstraint;
+
+  for(k = 0; k < this->nConstraints; k++) {
+    pConstraint = &this->aConstraints[k];
+
+    if(pConstraint->dMines == 0 || pConstraint->dMines == pConstraint->nCells)
+      for(l = 0; l < pConstraint->nCells; l++)
+        nFound += Solver_mark(this, pConstraint->aCells[l], pConstraint->dMines > 0);
+  }
+
+  return nFound;
+}
+
+/**
+ * Checks whether a constraint covers a cell.
+ *
+ * @param   { SolverConstraint * }  pConstraint   The constraint to read.
+ * @param   { int }                 dId           The frontier id of the cell.
+ * @return  { int }                               Whether the cell is one of its unknowns.
+*/
+int Solver_hasCell(SolverConstraint *pConstraint, int dId) {
+  int l;
+
+  for(l = 0; l < pConstraint->nCells; l++)
+    if(pConstraint->aCells[l] == dId)
+      return 1;
+
+  return 0;
+}
+
+/**
+ * Applies the pair rule to every two constraints that share a cell.
+ * The tiles only B sees hold at least (mines of B) - (mines of A) mines; if that's all of them,
+ *    they're all mines, and A's mines all lie in the shared tiles, so the tiles only A sees are safe.
+ * When A's tiles are a subset of B's, this is the usual subset rule.
+ *
+ * @param   { Solver * }  this    The solver to use.
+ * @return  { int }               How many cells were proven.
+*/
+int Solver_applyPairs(Solver *this) {
+  int a, b, k, l, m, dCell, nFound = 0;
+  int nOnlyA, nOnlyB;
+  int aOnlyA[SOLVER_MAX_NEIGHBORS], aOnlyB[SOLVER_MAX_NEIGHBORS];
+  SolverConstraint *pA, *pB;
+
+  for(a = 0; a < this->nConstraints; a++) {
+    pA = &this->aConstraints[a];
+
+    // The constraints that share a cell with A
+    for(k = 0; k < pA->nCells; k++) {
+      dCell = pA->aCells[k];
+
+      for(l = 0; l < this->aLinkCounts[dCell]; l++) {
+        b = this->aLinks[dCell * SOLVER_MAX_NEIGHBORS + l];
+        pB = &this->aConstraints[b];
+
+        if(b == a)
+          continue;
+
+        // Split the cells up into A only and B only
+        for(m = 0, nOnlyB = 0; m < pB->nCells; m++)
+          if(!Solver_hasCell(pA, pB->aCells[m]))
+            aOnlyB[nOnlyB++] = pB->aCells[m];
+
+        for(m = 0, nOnlyA = 0; m < pA->nCells; m++)
+          if(!Solver_hasCell(pB, pA->aCells[m]))
+            aOnlyA[nOnlyA++] = pA->aCells[m];
+
+        if(pB->dMines - pA->dMines != nOnlyB || (!nOnlyA && !nOnlyB))
+          continue;
+
+        for(m = 0; m < nOnlyB; m++)
+          nFound += Solver_mark(this, aOnlyB[m], 1);
+
+        for(m = 0; m < nOnlyA; m++)
+          nFound += Solver_mark(this, aOnlyA[m], 0);
+      }
+    }
+  }
+
+  return nFound;
+}
+
+/**
+ * //
+ * ////
+ * //////    Enumeration
+ * ////////
+ * //////////
+*/
+
+/**
+ * Finds the group a frontier cell belongs to.
+ *
+ * @param   { Solver * }  this    The solver to use.
+ * @param   { int }       dId     The frontier id of the cell.
+ * @return  { int }               The frontier id that stands for its group.
+*/
+int Solver_findRoot(Solver *this, int dId) {
+  while(this->aParents[dId] != dId)
+    dId = this->aParents[dId] = this->aParents[this->aParents[dId]];
+
+  return dId;
+}
+
+/**
+ * Splits the frontier into groups of cells that share constraints.
+ * Cells from different groups can't affect each other, so each group is enumerated on its own.
+ * The groups end up next to each other in aOrder, with group g spanning aStarts[g] to aStarts[g + 1].
+ *
+ * @param   { Solver * }  this    The solver to modify.
+ * @return  { int }               How many groups there are.
+*/
+int Solver_group(Solver *this) {
+  int k, l, dRoot, nGroups = 0;
+  SolverConstraint *pConstraint;
+
+  for(k = 0; k < this->nCells; k++)
+    this->aParents[k] = k;
+
+  for(k = 0; k < this->nConstraints; k++) {
+    pConstraint = &this->aConstraints[k];
+
+    for(l = 1; l < pConstraint->nCells; l++)
+      this->aParents[Solver_findRoot(this, pConstraint->aCells[l])] =
+        Solver_findRoot(this, pConstraint->aCells[0]);
+  }
+
+  // Number the groups; aValues temporarily holds the group of each root
+  for(k = 0; k < this->nCells; k++)
+    if(Solver_findRoot(this, k) == k)
+      this->aValues[k] = nGroups++;
+
+  // Count the cells of each group, then lay them out (a counting sort keeps them in order)
+  for(k = 0; k <= nGroups; k++)
+    this->aStarts[k] = 0;
+
+  for(k = 0; k < this->nCells; k++)
+    this->aStarts[this->aValues[Solver_findRoot(this, k)] + 1]++;
+
+  for(k = 0; k < nGroups; k++)
+    this->aStarts[k + 1] += this->aStarts[k];
+
+  for(k = 0; k < this->nCells; k++) {
+    dRoot = this->aValues[Solver_findRoot(this, k)];
+    this->aOrder[this->aStarts[dRoot]++] = k;
+  }
+
+  // The counting shifted every start over by one group
+  for(k = nGroups; k > 0; k--)
+    this->aStarts[k] = this->aStarts[k - 1];
+
+  this->aStarts[0] = 0;
+
+  return nGroups;
+}
+
+/**
+ * Decides a cell while enumerating, and checks that its constraints can still be met.
+ * The cell is decided either way; Solver_undecide() has to be called to take it back.
+ *
+ * @param   { Solver * }  this    The solver to modify.
+ * @param   { int }       dId     The frontier id of the cell.
+ * @param   { int }       bMine   Whether the cell gets a mine.
+ * @return  { int }               Whether every constraint of the cell can still be met.
+*/
+int Solver_decide(Solver *this, int dId, int bMine) {
+  int l, bFeasible = 1;
+  SolverConstraint *pConstraint;
+
+  this->aValues[dId] = bMine;
+
+  for(l = 0; l < this->aLinkCounts[dId]; l++) {
+    pConstraint = &this->aConstraints[this->aLinks[dId * SOLVER_MAX_NEIGHBORS + l]];
+    pConstraint->dAssigned += bMine;
+    pConstraint->dUnassigned--;
+
+    if(pConstraint->dAssigned > pConstraint->dMines ||
+      pConstraint->dAssigned + pConstraint->dUnassigned < pConstraint->dMines)
+      bFeasible = 0;
+  }
+
+  return bFeasible;
+}
+
+/**
+ * Takes back a decision made by Solver_decide().
+ *
+ * @param   { Solver * }  this    The solver to modify.
+ * @param   { int }       dId     The frontier id of the cell.
+*/
+void Solver_undecide(Solver *this, int dId) {
+  int l;
+  SolverConstraint *pConstraint;
+
+  for(l = 0; l < this->aLinkCounts[dId]; l++) {
+    pConstraint = &this->aConstraints[this->aLinks[dId * SOLVER_MAX_NEIGHBORS + l]];
+    pConstraint->dAssigned -= this->aValues[dId];
+    pConstraint->dUnassigned++;
+  }
+
+  this->aValues[dId] = -1;
+}
+
+/**
+ * Goes through every arrangement of mines on a group that meets all its constraints.
+ * Each complete arrangement adds to nSolutions and to the mine counts of the cells it puts mines on.
+ *
+ * @param   { Solver * }  this      The solver to use.
+ * @param   { int * }     aGroup    The cells of the group.
+ * @param   { int }       nGroup    How many cells the group has.
+ * @param   { int }       dDepth    How many cells have been decided so far.
+ * @return  { int }                 Whether the search finished within the budget.
+*/
+int Solver_search(Solver *this, int *aGroup, int nGroup, int dDepth) {
+  int k, bMine, bFeasible;
+
+  if(--this->dBudget < 0)
+    return 0;
+
+  // Everything's been decided
+  if(dDepth == nGroup) {
+    this->nSolutions++;
+
+    for(k = 0; k < nGroup; k++)
+      this->aMineCounts[aGroup[k]] += this->aValues[aGroup[k]];
+
+    return 1;
+  }
+
+  for(bMine = 0; bMine <= 1; bMine++) {
+    bFeasible = Solver_decide(this, aGroup[dDepth], bMine);
+
+    if(bFeasible && !Solver_search(this, aGroup, nGroup, dDepth + 1)) {
+      Solver_undecide(this, aGroup[dDepth]);
+      return 0;
+    }
+
+    Solver_undecide(this, aGroup[dDepth]);
+  }
+
+  return 1;
+}
+
+/**
+ * Enumerates the arrangements of each group of the frontier.
+ * A cell that's never a mine in any of them is safe; one that always is, is a mine.
+ * Groups that are too big, or that take too long, are skipped.
+ *
+ * @param   { Solver * }  this    The solver to use.
+ * @return  { int }               How many cells were proven.
+*/
+int Solver_enumerate(Solver *this) {
+  int g, k, nGroups, nGroup, nFound = 0;
+  int *aGroup;
+
+  nGroups = Solver_group(this);
+
+  for(k = 0; k < this->nCells; k++) {
+    this->aValues[k] = -1;
+    this->aMineCounts[k] = 0;
+  }
+
+  for(k = 0; k < this->nConstraints; k++) {
+    this->aConstraints[k].dAssigned = 0;
+    this->aConstraints[k].dUnassigned = this->aConstraints[k].nCells;
+  }
+
+  for(g = 0; g < nGroups; g++) {
+    aGroup = this->aOrder + this->aStarts[g];
+    nGroup = this->aStarts[g + 1] - this->aStarts[g];
+
+    if(nGroup > SOLVER_MAX_COMPONENT)
+      continue;
+
+    this->nSolutions = 0;
+    this->dBudget = SOLVER_ENUMERATION_BUDGET;
+
+    if(!Solver_search(this, aGroup, nGroup, 0) || !this->nSolutions)
+      continue;
+
+    for(k = 0; k < nGroup; k++) {
+      if(!this->aMineCounts[aGroup[k]])
+        nFound += Solver_mark(this, aGroup[k], 0);
+      else if(this->aMineCounts[aGroup[k]] == this->nSolutions)
+        nFound += Solver_mark(this, aGroup[k], 1);
+    }
+  }
+
+  return nFound;
+}
+
+/**
+ * //
+ * ////
+ * //////    Solver functions
+ * ////////
+ * //////////
+*/
+
+/**
+ * Runs the cheapest rule that proves anything on the field as it looks right now.
+ *
+ * @param   { Solver * }  this    The solver to use.
+ * @return  { int }               How many cells were proven.
+*/
+int Solver_step(Solver *this) {
+  int nFound;
+
+  Solver_build(this);
+
+  // Nothing visible touches an unknown
+  if(!this->nConstraints)
+    return 0;
+
+  if((nFound = Solver_applySingle(this)))
+    return nFound;
+
+  if((nFound = Solver_applyPairs(this)))
+    return nFound;
+
+  return Solver_enumerate(this);
+}
+
+/**
+ * Proves as much as possible about the field without changing it.
+ * The results pile up on pSafe and pMines; they're cleared by Solver_apply() or Solver_clear().
+ *
+ * @param   { Solver * }  this    The solver to use.
+ * @return  { int }               How many cells were proven.
+*/
+int Solver_deduce(Solver *this) {
+  int n, nFound = 0;
+
+  while((n = Solver_step(this)))
+    nFound += n;
+
+  return nFound;
+}
+
+/**
+ * Forgets what the solver has proven.
+ *
+ * @param   { Solver * }  this    The solver to modify.
+*/
+void Solver_clear(Solver *this) {
+  Grid_clear(this->pSafe, 0);
+  Grid_clear(this->pMines, 0);
+}
+
+/**
+ * Plays what the solver has proven: the safe tiles get inspected and the mines get flagged.
+ *
+ * @param   { Solver * }  this    The solver to use.
+*/
+void Solver_apply(Solver *this) {
+  int y, w, x;
+  uint64_t dSafe;
+  Field *pField = this->pField;
+
+  for(y = 0; y < pField->dHeight; y++) {
+    for(w = 0; w < this->pSafe->dStride; w++) {
+      Grid_getRow(pField->pFlagGrid, y)[w] |= Grid_getRow(this->pMines, y)[w];
+
+      // An earlier cascade might have gotten to some of these already
+      for(dSafe = Grid_getRow(this->pSafe, y)[w]; dSafe; dSafe &= dSafe - 1) {
+        x = (w << GRID_WORD_SHIFT) + __builtin_ctzll(dSafe);
+
+        if(!Grid_getBit(pField->pInspectGrid, x, y))
+          Field_cascade(pField, x, y);
+      }
+    }
+  }
+
+  Solver_clear(this);
+}
+
+/**
+ * Plays the field from a tile for as long as the solver can make progress.
+ * The inspections and deduced flags are left on the field.
+ *
+ * @param   { Field * }   pField    The field to solve; it should have no inspections or flags yet.
+ * @param   { int }       x         The x-coordinate of the first click.
+ * @param   { int }       y         The y-coordinate of the first click.
+ * @return  { int }                 Whether or not the whole field was cleared without guessing.
+*/
+int Solver_solve(Field *pField, int x, int y) {
+  Solver solver;
+
+  // The first click is always a guess
+  if(Grid_getBit(pField->pMineGrid, x, y))
+    return 0;
+
+  Field_cascade(pField, x, y);
+  Solver_init(&solver, pField);
+
+  // Play whatever the cheapest rule finds right away, since new numbers make the next step easier
+  while(!Field_isCleared(pField) && Solver_step(&solver))
+    Solver_apply(&solver);
+
+  Solver_exit(&solver);
+
+  return Field_isCleared(pField);
+}
+
+/**
+ * Checks whether a field can be cleared from a tile without guessing.
+ * Unlike Solver_solve(), this leaves the field as it was.
+ *
+ * @param   { Field * }   pField    The field to check; it should have no inspections or flags yet.
+ * @param   { int }       x         The x-coordinate of the first click.
+ * @param   { int }       y         The y-coordinate of the first click.
+ * @return  { int }                 Whether or not the field needs no guesses.
+*/
+int Solver_isSolvable(Field *pField, int x, int y) {
+  int bSolvable = Solver_solve(pField, x, y);
+
+  Field_reset(pField);
+
+  return bSolvable;
+}
+
+#endif
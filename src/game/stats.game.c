@@ -256,7 +256,7 @@ int Stats_saveGame(Game *this) {
 
 	// The latest game data
 	char sGameData[256];
-	char sGameGridData[GAME_MAX_ROWS + 1][GAME_MAX_COLUMNS + 2] = {0};
+	char **sGameGridData;
 
 	// The data in the profile file
 	int nProfileDataLength = 0;
@@ -265,7 +265,7 @@ int Stats_saveGame(Game *this) {
 	char *sProfileNewDataArray[PROFILE_FILE_MAX_HEIGHT + 1];
 
 	// Path to the profile
-	sProfilePath = String_alloc(PROFILE_USERNAME_MAX_LENGTH + strlen(PROFILE_FOLDER_PATH) + 8);
+	sProfilePath = String_alloc(PROFILE_USERNAME_MAX_LENGTH + strlen(PROFILE_FOLDER_PATH) + 16);
 	sprintf(sProfilePath, "%s%s.txt", PROFILE_FOLDER_PATH, this->pProfile->sCurrentProfile);
 
 	// Too many games
@@ -296,6 +296,11 @@ int Stats_saveGame(Game *this) {
 	// Read the file header
 	Stats_readProfileHeader(sProfileDataArray, nCustom, nClassicEasy, nClassicDifficult);
 
+	// The board picture is sized after the field (one extra column for the newline)
+	sGameGridData = calloc(this->field.dHeight + 1, sizeof(*sGameGridData));
+	for(i = 0; i <= this->field.dHeight; i++)
+		sGameGridData[i] = String_alloc(this->field.dWidth + 2);
+
 	// The player lost
 	if(this->eOutcome == GAME_OUTCOME_LOSS) {
 		if(this->eType == GAME_TYPE_CUSTOM) nCustom[1]++;
@@ -424,6 +429,14 @@ int Stats_saveGame(Game *this) {
 	// Garbage collection
 	File_freeBuffer(nProfileDataLength, sProfileDataArray);
 	File_freeBuffer(nProfileNewDataLength, sProfileNewDataArray);
+	File_freeBuffer(this->field.dHeight + 1, sGameGridData);
+	free(sGameGridData);
+
+	// Keep the moves too, so the game can be replayed (and checked)
+	sprintf(sProfilePath, "%s%s.replays.bin", PROFILE_FOLDER_PATH, this->pProfile->sCurrentProfile);
+	Game_closeLog(this);
+	MoveLog_save(&this->log, sProfilePath);
+	String_kill(sProfilePath);
 
 	return 1;
 }
@@ -0,0 +1,753 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 09:12:40
+ * @ Modified time: 2026-10-16 16:04:51
+ * @ Description:
+ *
+ * Benchmarks for the game logic; this doesn't touch the console at all.
+ * Build it the same way as the game:
+ *
+ *    gcc -Wall -O2 ./src/minesweeper.bench.c -o ./build/minesweeper.bench.o -lrt -lm -lpthread
+ *
+ * and run it with
+ *
+ *    ./build/minesweeper.bench.o [--kernels-only] [--csv out.csv] [--compare old.csv]
+ *
+ * The kernel suite times the hot paths of the game on their own, in ns and allocations per call.
+ * One of them draws a whole frame of the play screen, short of printing it.
+ * Its results can be written as CSV, and compared against the CSV of an earlier commit; anything
+ *    that got slower by more than BENCH_REGRESSION_PERCENT is flagged, and the exit code is 1.
+ */
+
+// These come before anything of ours, so the counting below doesn't rename their declarations
+#include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// How many allocations the game code has made so far
+size_t dBenchAllocs = 0;
+
+void *Bench_malloc(size_t dSize) {
+  dBenchAllocs++;
+  return malloc(dSize);
+}
+
+void *Bench_calloc(size_t nItems, size_t dSize) {
+  dBenchAllocs++;
+  return calloc(nItems, dSize);
+}
+
+void *Bench_realloc(void *pBlock, size_t dSize) {
+  dBenchAllocs++;
+  return realloc(pBlock, dSize);
+}
+
+// Everything included after this gets counted
+#define malloc(dSize) Bench_malloc(dSize)
+#define calloc(nItems, dSize) Bench_calloc(nItems, dSize)
+#define realloc(pBlock, dSize) Bench_realloc(pBlock, dSize)
+
+#include "game/field.obj.h"
+#include "game/endless.obj.h"
+#include "game/game.c"
+#include "utils/utils.component.h"
+
+// The boards we try the cascades on
+#define BENCH_SIZES_COUNT 5
+#define BENCH_DENSITIES_COUNT 2
+
+// Past this, the recursive cascade would run out of stack
+#define BENCH_MAX_RECURSIVE_CELLS (256 * 256)
+
+// How many fields get generated per batch
+#define BENCH_BATCH_SIZE 1024
+
+// The seed every benchmark starts from, so runs can be compared
+#define BENCH_SEED 0x5eedULL
+
+// The boards and kernels of the kernel suite
+#define BENCH_KERNEL_COUNT 8
+#define BENCH_KERNEL_SIZES_COUNT 8
+#define BENCH_KERNEL_DENSITIES_COUNT 3
+#define BENCH_MAX_RESULTS (BENCH_KERNEL_COUNT * BENCH_KERNEL_SIZES_COUNT * BENCH_KERNEL_DENSITIES_COUNT)
+
+#define BENCH_ROUNDS 5                            // How many times each kernel is timed on each board; the best one counts
+#define BENCH_MIN_NANOS 1e7                       // How long each of those rounds lasts, at least
+#define BENCH_MIN_OPS 3                           // How many calls each round makes, at least
+#define BENCH_REGRESSION_PERCENT 10               // How much slower a kernel can get before it's flagged
+#define BENCH_MAX_DISPLAY_CELLS (256 * 256)       // Past this, drawing the board takes longer than it tells us
+
+// The terminal the frame kernel draws for
+#define BENCH_FRAME_WIDTH 160
+#define BENCH_FRAME_HEIGHT 45
+#define BENCH_MAX_FRAME_CELLS (64 * 64)           // Past this, the board is clipped by the frame, so every frame is the same
+
+typedef struct BenchCase BenchCase;
+typedef struct BenchKernel BenchKernel;
+typedef struct BenchResult BenchResult;
+
+typedef void (*f_bench_op)(BenchCase *pCase);
+
+/**
+ * A board to run the kernels on.
+ *
+ * @struct
+*/
+struct BenchCase {
+  Game game;
+  Random *pRandom;
+  int dMines;
+  char *sBuffer;                                  // Where Game_displayGrid() writes to
+  int dSink;                                      // Keeps results from being optimized away
+
+  ComponentManager componentManager;              // The play screen the frame kernel draws
+  Buffer *pFrame;                                 // The frame being drawn; this is NULL until the frame kernel runs
+  Buffer *pScreen;                                // What the last frame left on the screen
+  int dCursorHandle;
+};
+
+/**
+ * A hot path to be timed.
+ *
+ * @struct
+*/
+struct BenchKernel {
+  char *sName;
+  f_bench_op fPrepare;                            // Gets the board ready, once per board; this may be NULL
+  f_bench_op fSetup;                              // Gets the board ready, untimed, before every call; this may be NULL
+  f_bench_op fRun;                                // The call being timed
+  int dMaxCells;                                  // The biggest board it's worth running on
+};
+
+/**
+ * How a kernel did on a board.
+ *
+ * @struct
+*/
+struct BenchResult {
+  char sKernel[STRING_KEY_MAX_LENGTH];
+  int dWidth, dHeight, dDensity;
+  int nOps;
+  double dNanosPerOp;
+  double dAllocsPerOp;
+};
+
+/**
+ * The old way of cascading inspections, kept here so we have something to compare against.
+ * This recurses once per zero tile, so big empty boards end up very deep in the stack.
+ *
+ * @param   { Field * }   pField    The field to be modified.
+ * @param   { int }       x         The tile's x-coordinate in index notation.
+ * @param   { int }       y         The tile's y-coordinate in index notation.
+*/
+void Bench_cascadeRecursive(Field *pField, int x, int y) {
+  int i, j;
+
+  Field_inspect(pField, x, y);
+
+  if(pField->aNumbers[y][x] == 0) {
+    for(i = x - 1; i <= x + 1; i++) {
+      if(i >= 0 && i <= pField->dWidth - 1) {
+        for(j = y - 1; j <= y + 1; j++) {
+          if(j >= 0 && j <= pField->dHeight - 1) {
+            Grid_setBit(pField->pFlagGrid, i, j, 0);
+
+            if(!pField->aNumbers[j][i] &&
+              !Grid_getBit(pField->pInspectGrid, i, j))
+              Bench_cascadeRecursive(pField, i, j);
+
+            if(pField->aNumbers[j][i] >= 0)
+              Field_inspect(pField, i, j);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Returns the time elapsed since a given clock reading, in milliseconds.
+ *
+ * @param   { clock_t }   dStart  The clock reading to measure from.
+ * @return  { double }            The milliseconds elapsed.
+*/
+double Bench_getElapsed(clock_t dStart) {
+  return (double) (clock() - dStart) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/**
+ * Returns a reading of a clock that only ever goes forward, in nanoseconds.
+ * clock() only ticks every microsecond, which is longer than some of the kernels take.
+ *
+ * @return  { double }    The reading.
+*/
+double Bench_getNanos() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+/**
+ * //
+ * ////
+ * //////    Kernels
+ * ////////
+ * //////////
+*/
+
+void Bench_runPopulate(BenchCase *pCase) {
+  Field_populateRandom(&pCase->game.field, pCase->dMines, pCase->pRandom);
+}
+
+void Bench_runSetNumbers(BenchCase *pCase) {
+  Field_setNumbers(&pCase->game.field);
+}
+
+void Bench_setupInspect(BenchCase *pCase) {
+  Field_reset(&pCase->game.field);
+  pCase->game.eOutcome = GAME_OUTCOME_PENDING;
+}
+
+void Bench_runInspect(BenchCase *pCase) {
+  Game_inspect(&pCase->game, pCase->game.field.dWidth / 2, pCase->game.field.dHeight / 2);
+}
+
+/**
+ * Inspects every safe tile, so Game_hasWon() has to go all the way.
+ *
+ * @param   { BenchCase * }   pCase   The board.
+*/
+void Bench_prepareHasWon(BenchCase *pCase) {
+  int y, w;
+  Field *pField = &pCase->game.field;
+
+  for(y = 0; y < pField->dHeight; y++)
+    for(w = 0; w < pField->pInspectGrid->dStride; w++)
+      Grid_getRow(pField->pInspectGrid, y)[w] = ~Grid_getRow(pField->pMineGrid, y)[w] &
+        (w == pField->pInspectGrid->dStride - 1 ? Grid_getTailMask(pField->pInspectGrid) : ~0ULL);
+
+  Field_countSafeLeft(pField);
+}
+
+/**
+ * Inspects every safe tile but the center, so the board is one move away from being won.
+ *
+ * @param   { BenchCase * }   pCase   The board.
+*/
+void Bench_preparePending(BenchCase *pCase) {
+  Field *pField = &pCase->game.field;
+
+  Bench_prepareHasWon(pCase);
+  Grid_setBit(pField->pInspectGrid, pField->dWidth / 2, pField->dHeight / 2, 0);
+  Field_countSafeLeft(pField);
+}
+
+void Bench_runHasWon(BenchCase *pCase) {
+  pCase->dSink += Game_hasWon(&pCase->game);
+}
+
+void Bench_runGetCount(BenchCase *pCase) {
+  pCase->dSink += Grid_getCount(pCase->game.field.pMineGrid);
+}
+
+/**
+ * Opens up the board from the center, so the grid shows a bit of everything.
+ *
+ * @param   { BenchCase * }   pCase   The board.
+*/
+void Bench_prepareDisplay(BenchCase *pCase) {
+  Bench_setupInspect(pCase);
+  Bench_runInspect(pCase);
+}
+
+void Bench_runDisplay(BenchCase *pCase) {
+  Game_displayGrid(&pCase->game, pCase->sBuffer);
+}
+
+/**
+ * Draws the tiles of the board for the frame kernel, the same way the play page does.
+ *
+ * @param   { p_obj }     pArgs_Case  The board.
+ * @param   { Buffer * }  pBuffer     The buffer to draw on.
+ * @param   { int }       x           Where the first tile goes in the buffer.
+ * @param   { int }       y           Where the first tile goes in the buffer.
+ * @param   { int }       dStartX     The first column to draw.
+ * @param   { int }       dStartY     The first row to draw.
+ * @param   { int }       dEndX       The column to stop at.
+ * @param   { int }       dEndY       The row to stop at.
+*/
+void Bench_drawTiles(p_obj pArgs_Case, Buffer *pBuffer, int x, int y, int dStartX, int dStartY, int dEndX, int dEndY) {
+  BenchCase *pCase = (BenchCase *) pArgs_Case;
+  int dTileX, dTileY;
+
+  for(dTileX = dStartX; dTileX < dEndX; dTileX++)
+    for(dTileY = dStartY; dTileY < dEndY; dTileY++)
+      Game_drawTile(&pCase->game, pBuffer, x + dTileX * GAME_CELL_WIDTH, y + dTileY * GAME_CELL_HEIGHT, dTileX, dTileY);
+}
+
+/**
+ * Each frame moves the cursor one tile over, the way it does while the player holds down a key.
+ * The frame is drawn and compared against the last one, but nothing gets printed.
+ *
+ * @param   { BenchCase * }   pCase   The board.
+*/
+void Bench_runFrame(BenchCase *pCase) {
+  Game *pGame = &pCase->game;
+
+  pGame->dCursorX = (pGame->dCursorX + 1) % pGame->field.dWidth;
+  ComponentManager_setPosByHandle(&pCase->componentManager, pCase->dCursorHandle, 
+    pGame->dCursorX * GAME_CELL_WIDTH, pGame->dCursorY * GAME_CELL_HEIGHT);
+
+  ComponentManager_draw(&pCase->componentManager, pCase->pFrame, BENCH_FRAME_WIDTH, BENCH_FRAME_HEIGHT);
+  pCase->dSink += Buffer_diff(pCase->pFrame, pCase->pScreen);
+}
+
+/**
+ * Lays out a play screen around the board: the field in the middle, with the game info above it.
+ * The board is opened up from the center, and the first frame is drawn so the screen isn't empty.
+ *
+ * @param   { BenchCase * }   pCase   The board.
+*/
+void Bench_prepareFrame(BenchCase *pCase) {
+  static char *aInfo[] = { "board:           classic", "frame rate:      32 fps", "time elapsed:    0:00", "mines left:      10", "mine chance:     -" };
+  static char *aCursor[] = { "+---+", "|   |", "+---+" };
+
+  ComponentManager *pManager = &pCase->componentManager;
+  int dWidth = Game_getCharWidth(&pCase->game);
+  int dHeight = Game_getCharHeight(&pCase->game);
+  int dHandle;
+
+  // Every board gets a fresh screen
+  if(pCase->pFrame == NULL) {
+    pCase->pFrame = Buffer_create(0, 0, 0x000000, 0x000000);
+    pCase->pScreen = Buffer_create(0, 0, 0x000000, 0x000000);
+  } else {
+    ComponentManager_exit(pManager);
+  }
+
+  ComponentManager_init(pManager);
+  ComponentManager_add(pManager, "play.fixed", "root", 0, 0, BENCH_FRAME_WIDTH, BENCH_FRAME_HEIGHT, 0, NULL, 0xd8d8d8, 0x202020);
+  ComponentManager_add(pManager, "info.fixed.aleft-x.abottom-y", "play.fixed", 
+    BENCH_FRAME_WIDTH / 2 - dWidth / 2, BENCH_FRAME_HEIGHT / 2 - dHeight / 2 - 1, 24, 5, 5, aInfo, -1, -1);
+
+  dHandle = ComponentManager_add(pManager, "field.aleft-x.atop-y", "play.fixed", 
+    BENCH_FRAME_WIDTH / 2 - dWidth / 2, BENCH_FRAME_HEIGHT / 2 - dHeight / 2, 0, 0, 0, NULL, 0x808080, -1);
+  ComponentManager_setTilemapByHandle(pManager, dHandle, Bench_drawTiles, pCase, 
+    GAME_CELL_WIDTH, GAME_CELL_HEIGHT, pCase->game.field.dWidth, pCase->game.field.dHeight);
+  pCase->dCursorHandle = ComponentManager_add(pManager, "field-cursor.aleft-x.atop-y", "field.aleft-x.atop-y", 
+    0, 0, 5, 3, 3, aCursor, 0xff4040, -1);
+
+  Bench_prepareDisplay(pCase);
+  Bench_runFrame(pCase);
+}
+
+BenchKernel aBenchKernels[BENCH_KERNEL_COUNT] = {
+  { "Field_populateRandom", NULL, NULL, Bench_runPopulate, INT32_MAX },
+  { "Field_setNumbers", NULL, NULL, Bench_runSetNumbers, INT32_MAX },
+  { "Game_inspect", NULL, Bench_setupInspect, Bench_runInspect, INT32_MAX },
+  { "Game_hasWon", Bench_prepareHasWon, NULL, Bench_runHasWon, INT32_MAX },
+  { "Game_hasWon:pending", Bench_preparePending, NULL, Bench_runHasWon, INT32_MAX },
+  { "Grid_getCount", NULL, NULL, Bench_runGetCount, INT32_MAX },
+  { "Game_displayGrid", Bench_prepareDisplay, NULL, Bench_runDisplay, BENCH_MAX_DISPLAY_CELLS },
+  { "Frame", Bench_prepareFrame, NULL, Bench_runFrame, BENCH_MAX_FRAME_CELLS },
+};
+
+/**
+ * Times a kernel on a board.
+ * Kernels that need setting up before each call are timed one call at a time; the rest are
+ *    timed in batches that double in size, so the clock itself doesn't show up in the results.
+ * The fastest of a few rounds is kept, since anything else running on the machine only ever slows a round down.
+ *
+ * @param   { BenchKernel * }   pKernel   The kernel to time.
+ * @param   { BenchCase * }     pCase     The board to run it on.
+ * @param   { BenchResult * }   pResult   Where to write the results.
+*/
+void Bench_runKernel(BenchKernel *pKernel, BenchCase *pCase, BenchResult *pResult) {
+  int i, r, nBatch = 1, nOps, nTotalOps = 0;
+  size_t dAllocs = 0, dAllocsStart;
+  double dTotal, dStart, dBest = INFINITY;
+
+  if(pKernel->fPrepare != NULL)
+    pKernel->fPrepare(pCase);
+
+  for(r = 0; r < BENCH_ROUNDS; r++) {
+    for(dTotal = 0, nOps = 0; dTotal < BENCH_MIN_NANOS || nOps < BENCH_MIN_OPS; nOps += nBatch) {
+      if(pKernel->fSetup != NULL)
+        pKernel->fSetup(pCase);
+      else if(nOps)
+        nBatch *= 2;
+
+      dAllocsStart = dBenchAllocs;
+      dStart = Bench_getNanos();
+
+      for(i = 0; i < nBatch; i++)
+        pKernel->fRun(pCase);
+
+      dTotal += Bench_getNanos() - dStart;
+      dAllocs += dBenchAllocs - dAllocsStart;
+    }
+
+    dBest = dTotal / nOps < dBest ? dTotal / nOps : dBest;
+    nTotalOps += nOps;
+  }
+
+  strcpy(pResult->sKernel, pKernel->sName);
+  pResult->dWidth = pCase->game.field.dWidth;
+  pResult->dHeight = pCase->game.field.dHeight;
+  pResult->nOps = nTotalOps;
+  pResult->dNanosPerOp = dBest;
+  pResult->dAllocsPerOp = (double) dAllocs / nTotalOps;
+}
+
+/**
+ * Runs every kernel on every board of the suite.
+ * Each board starts out the way a first click leaves it: random mines, with the center kept clear.
+ *
+ * @param   { BenchResult * }   aResults  Where to write the results.
+ * @param   { Random * }        pRandom   The generator to use.
+ * @return  { int }                       How many results there are.
+*/
+int Bench_runKernels(BenchResult *aResults, Random *pRandom) {
+  int i, j, k, dSize, nResults = 0;
+  int aSizes[BENCH_KERNEL_SIZES_COUNT] = { 8, 16, 32, 64, 128, 256, 512, 1024 };
+  int aDensities[BENCH_KERNEL_DENSITIES_COUNT] = { 0, 10, 20 };
+  BenchCase benchCase;
+
+  memset(&benchCase, 0, sizeof(benchCase));
+  benchCase.pRandom = pRandom;
+  benchCase.game.bIsGenerated = 1;
+
+  printf("%-22s %-12s %-8s %-10s %-14s %s\n", "kernel", "board", "mines%", "calls", "ns/call", "allocs/call");
+
+  for(i = 0; i < BENCH_KERNEL_SIZES_COUNT; i++) {
+    dSize = aSizes[i];
+
+    Field_init(&benchCase.game.field, dSize, dSize);
+    benchCase.sBuffer = calloc((size_t) Game_getCharWidth(&benchCase.game) * Game_getCharHeight(&benchCase.game) * 4, 1);
+
+    for(j = 0; j < BENCH_KERNEL_DENSITIES_COUNT; j++) {
+      benchCase.dMines = dSize * dSize * aDensities[j] / 100;
+
+      for(k = 0; k < BENCH_KERNEL_COUNT; k++) {
+        if(dSize * dSize > aBenchKernels[k].dMaxCells)
+          continue;
+
+        // Every kernel gets the same board, no matter how many numbers the ones before it drew
+        Random_seed(pRandom, BENCH_SEED + dSize * 100 + aDensities[j]);
+        Field_populateSafe(&benchCase.game.field, benchCase.dMines, dSize / 2, dSize / 2, pRandom);
+        Field_setNumbers(&benchCase.game.field);
+        Field_reset(&benchCase.game.field);
+        benchCase.game.eOutcome = GAME_OUTCOME_PENDING;
+
+        Bench_runKernel(&aBenchKernels[k], &benchCase, &aResults[nResults]);
+        aResults[nResults].dDensity = aDensities[j];
+
+        printf("%-22s %5dx%-6d %-8d %-10d %-14.1f %.2f\n",
+          aResults[nResults].sKernel, dSize, dSize, aDensities[j], aResults[nResults].nOps,
+          aResults[nResults].dNanosPerOp, aResults[nResults].dAllocsPerOp);
+
+        nResults++;
+      }
+    }
+
+    free(benchCase.sBuffer);
+  }
+
+  Field_exit(&benchCase.game.field);
+
+  if(benchCase.pFrame != NULL) {
+    ComponentManager_exit(&benchCase.componentManager);
+    Buffer_kill(benchCase.pFrame);
+    Buffer_kill(benchCase.pScreen);
+  }
+
+  return nResults;
+}
+
+/**
+ * Writes the results of the kernel suite as CSV.
+ *
+ * @param   { char * }          sPath       Where to write them.
+ * @param   { BenchResult * }   aResults    The results.
+ * @param   { int }             nResults    How many there are.
+*/
+void Bench_writeResults(char *sPath, BenchResult *aResults, int nResults) {
+  int i;
+  FILE *pFile = fopen(sPath, "w");
+
+  if(pFile == NULL) {
+    printf("Could not write to %s.\n", sPath);
+    return;
+  }
+
+  fprintf(pFile, "kernel,width,height,density,calls,ns_per_call,allocs_per_call\n");
+
+  for(i = 0; i < nResults; i++)
+    fprintf(pFile, "%s,%d,%d,%d,%d,%.2f,%.4f\n",
+      aResults[i].sKernel, aResults[i].dWidth, aResults[i].dHeight, aResults[i].dDensity,
+      aResults[i].nOps, aResults[i].dNanosPerOp, aResults[i].dAllocsPerOp);
+
+  fclose(pFile);
+}
+
+/**
+ * Compares the results of the kernel suite against those of an earlier run.
+ * A kernel is flagged if it got slower by more than BENCH_REGRESSION_PERCENT, or if it allocates more.
+ *
+ * @param   { char * }          sPath       The CSV of the earlier run.
+ * @param   { BenchResult * }   aResults    The results of this run.
+ * @param   { int }             nResults    How many there are.
+ * @return  { int }                         How many kernels got worse.
+*/
+int Bench_compareResults(char *sPath, BenchResult *aResults, int nResults) {
+  int i, nRegressions = 0;
+  char sLine[STRING_KEY_MAX_LENGTH];
+  FILE *pFile = fopen(sPath, "r");
+  BenchResult old;
+  int bIsWorse;
+
+  if(pFile == NULL) {
+    printf("Could not read %s.\n", sPath);
+    return 0;
+  }
+
+  printf("\n%-22s %-12s %-8s %-14s %-14s %-8s %s\n", "kernel", "board", "mines%", "old ns/call", "new ns/call", "change", "allocs");
+
+  while(fgets(sLine, STRING_KEY_MAX_LENGTH, pFile) != NULL) {
+    if(sscanf(sLine, "%[^,],%d,%d,%d,%d,%lf,%lf", old.sKernel, &old.dWidth, &old.dHeight, &old.dDensity,
+      &old.nOps, &old.dNanosPerOp, &old.dAllocsPerOp) != 7)
+      continue;
+
+    for(i = 0; i < nResults; i++) {
+      if(strcmp(aResults[i].sKernel, old.sKernel) || aResults[i].dWidth != old.dWidth ||
+        aResults[i].dHeight != old.dHeight || aResults[i].dDensity != old.dDensity)
+        continue;
+
+      bIsWorse = aResults[i].dNanosPerOp > old.dNanosPerOp * (100 + BENCH_REGRESSION_PERCENT) / 100 ||
+        aResults[i].dAllocsPerOp > old.dAllocsPerOp;
+      nRegressions += bIsWorse;
+
+      printf("%-22s %5dx%-6d %-8d %-14.1f %-14.1f %+-7.1f%% %.2f -> %.2f%s\n",
+        old.sKernel, old.dWidth, old.dHeight, old.dDensity, old.dNanosPerOp, aResults[i].dNanosPerOp,
+        (aResults[i].dNanosPerOp / old.dNanosPerOp - 1) * 100, old.dAllocsPerOp, aResults[i].dAllocsPerOp,
+        bIsWorse ? "  (worse)" : "");
+    }
+  }
+
+  fclose(pFile);
+
+  printf("\n%d regression%s\n", nRegressions, nRegressions == 1 ? "" : "s");
+
+  return nRegressions;
+}
+
+/**
+ * //
+ * ////
+ * //////    Whole-board benchmarks
+ * ////////
+ * //////////
+*/
+
+/**
+ * Times a single cascade from the center of a board, averaged over a few runs.
+ * The inspections are cleared before each run so every run does the same work.
+ *
+ * @param   { Game * }    pGame         The game whose field we cascade on.
+ * @param   { int }       bRecursive    Whether to use the old recursive cascade.
+ * @return  { double }                  The average milliseconds per cascade.
+*/
+double Bench_timeCascade(Game *pGame, int bRecursive) {
+  int i, dRuns = 0;
+  int x = pGame->field.dWidth / 2;
+  int y = pGame->field.dHeight / 2;
+  double dTotal = 0;
+  clock_t dStart;
+
+  // Run it at least a few times, or until a good amount of time has passed
+  for(i = 0; i < 5 || (dTotal < 200 && i < 1000); i++) {
+    Grid_clear(pGame->field.pInspectGrid, 0);
+    Field_countSafeLeft(&pGame->field);
+
+    dStart = clock();
+
+    if(bRecursive)
+      Bench_cascadeRecursive(&pGame->field, x, y);
+    else
+      Field_cascade(&pGame->field, x, y);
+
+    dTotal += Bench_getElapsed(dStart);
+    dRuns++;
+  }
+
+  return dTotal / dRuns;
+}
+
+/**
+ * Measures how many boards per second the batch generator can produce.
+ *
+ * @param   { int }       dWidth    The width of the boards.
+ * @param   { int }       dHeight   The height of the boards.
+ * @param   { int }       dMines    The number of mines on each board.
+ * @param   { Random * }  pRandom   The generator to use.
+ * @return  { double }              The boards generated per second.
+*/
+double Bench_timeBatch(int dWidth, int dHeight, int dMines, Random *pRandom) {
+  int i, dBatches = 0;
+  double dTotal = 0;
+  clock_t dStart;
+
+  Field *aFields = calloc(BENCH_BATCH_SIZE, sizeof(*aFields));
+
+  for(i = 0; i < BENCH_BATCH_SIZE; i++)
+    Field_init(&aFields[i], dWidth, dHeight);
+
+  // Keep going until a good amount of time has passed
+  while(dTotal < 250) {
+    dStart = clock();
+    Field_populateBatch(aFields, BENCH_BATCH_SIZE, dMines, pRandom);
+    dTotal += Bench_getElapsed(dStart);
+    dBatches++;
+  }
+
+  for(i = 0; i < BENCH_BATCH_SIZE; i++)
+    Field_exit(&aFields[i]);
+
+  free(aFields);
+
+  return (double) dBatches * BENCH_BATCH_SIZE * 1000.0 / dTotal;
+}
+
+/**
+ * Explores an endless field by inspecting random tiles within a growing radius of the start.
+ * Mines are skipped, since we only care about how the chunks grow.
+ *
+ * @param   { int }       dInspects   How many tiles to inspect.
+ * @param   { int }       dRadius     How far from the start the tiles can be.
+ * @param   { Random * }  pRandom     The generator to use.
+*/
+void Bench_exploreEndless(int dInspects, int dRadius, Random *pRandom) {
+  int i, x, y;
+  double dTotal;
+  clock_t dStart;
+
+  Endless endless;
+  Endless_init(&endless, BENCH_SEED, ENDLESS_DENSITY_DEFAULT);
+
+  dStart = clock();
+  Endless_inspect(&endless, 0, 0);
+
+  for(i = 0; i < dInspects; i++) {
+    x = (int) Random_range(pRandom, 2 * dRadius + 1) - dRadius;
+    y = (int) Random_range(pRandom, 2 * dRadius + 1) - dRadius;
+
+    if(Endless_getNumber(&endless, x, y) >= 0)
+      Endless_inspect(&endless, x, y);
+  }
+
+  dTotal = Bench_getElapsed(dStart);
+
+  printf("%-10d %-8d %-10d %-8d %-12.2f\n", dInspects, dRadius, 
+    endless.dInspected, endless.dChunkCount, dTotal);
+
+  Endless_exit(&endless);
+}
+
+int main(int argc, char **argv) {
+  int i, j, nResults, nRegressions = 0;
+  int aSizes[BENCH_SIZES_COUNT] = { 16, 64, 256, 1024, 2048 };
+  int aDensities[BENCH_DENSITIES_COUNT] = { 0, 5 };
+  int bKernelsOnly = 0;
+  char *sCsvPath = NULL, *sComparePath = NULL;
+  double dFlood, dRecursive;
+
+  Game game;
+  Random random;
+  BenchResult *aResults = calloc(BENCH_MAX_RESULTS, sizeof(*aResults));
+
+  for(i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--kernels-only"))
+      bKernelsOnly = 1;
+    else if(!strcmp(argv[i], "--csv") && i + 1 < argc)
+      sCsvPath = argv[++i];
+    else if(!strcmp(argv[i], "--compare") && i + 1 < argc)
+      sComparePath = argv[++i];
+  }
+
+  Random_seed(&random, BENCH_SEED);
+  memset(&game, 0, sizeof(game));
+
+  // The hot paths on their own
+  nResults = Bench_runKernels(aResults, &random);
+
+  if(sCsvPath != NULL)
+    Bench_writeResults(sCsvPath, aResults, nResults);
+
+  if(sComparePath != NULL)
+    nRegressions = Bench_compareResults(sComparePath, aResults, nResults);
+
+  free(aResults);
+
+  if(bKernelsOnly)
+    return nRegressions > 0;
+
+  printf("\n");
+
+  printf("%-12s %-8s %-10s %-14s %-14s %s\n",
+    "board", "mines%", "revealed", "flood (ms)", "recursive (ms)", "speedup");
+
+  for(i = 0; i < BENCH_SIZES_COUNT; i++) {
+    for(j = 0; j < BENCH_DENSITIES_COUNT; j++) {
+
+      // Make the board; the center is kept clear so the cascade always opens something
+      Field_init(&game.field, aSizes[i], aSizes[i]);
+      Field_populateRandom(&game.field, aSizes[i] * aSizes[i] * aDensities[j] / 100, &random);
+      Grid_setBit(game.field.pMineGrid, aSizes[i] / 2, aSizes[i] / 2, 0);
+      Field_setNumbers(&game.field);
+
+      dFlood = Bench_timeCascade(&game, 0);
+
+      // Only do the recursion if the stack can take it
+      if(aSizes[i] * aSizes[i] <= BENCH_MAX_RECURSIVE_CELLS) {
+        dRecursive = Bench_timeCascade(&game, 1);
+
+        printf("%5dx%-6d %-8d %-10d %-14.4f %-14.4f %.2fx\n",
+          aSizes[i], aSizes[i], aDensities[j], Grid_getCount(game.field.pInspectGrid),
+          dFlood, dRecursive, dFlood > 0 ? dRecursive / dFlood : 0);
+      } else {
+        printf("%5dx%-6d %-8d %-10d %-14.4f %-14s %s\n",
+          aSizes[i], aSizes[i], aDensities[j], Grid_getCount(game.field.pInspectGrid),
+          dFlood, "(stack)", "-");
+      }
+    }
+  }
+
+  // Batch generation for the bots
+  printf("\n%-12s %-8s %s\n", "board", "mines", "boards/s");
+  printf("%5dx%-6d %-8d %.0f\n", GAME_EASY_COLUMNS, GAME_EASY_ROWS, GAME_EASY_MINES, 
+    Bench_timeBatch(GAME_EASY_COLUMNS, GAME_EASY_ROWS, GAME_EASY_MINES, &random));
+  printf("%5dx%-6d %-8d %.0f\n", GAME_DIFFICULT_COLUMNS, GAME_DIFFICULT_ROWS, GAME_DIFFICULT_MINES, 
+    Bench_timeBatch(GAME_DIFFICULT_COLUMNS, GAME_DIFFICULT_ROWS, GAME_DIFFICULT_MINES, &random));
+
+  // The endless field only grows where we go
+  printf("\n%-10s %-8s %-10s %-8s %s\n", "inspects", "radius", "revealed", "chunks", "time (ms)");
+  Bench_exploreEndless(1000, 64, &random);
+  Bench_exploreEndless(1000, 1024, &random);
+  Bench_exploreEndless(10000, 1024, &random);
+  Bench_exploreEndless(10000, 1 << 20, &random);
+
+  Field_exit(&game.field);
+
+  return nRegressions > 0;
+}
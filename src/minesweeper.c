@@ -25,7 +25,7 @@ int main() {
   Engine_init(&engine);
 
   // Keep the main thread open while the engine is running
-  while(Engine_getState(&engine));
+  Engine_wait(&engine);
 
   // Clean up the IO related stuff
   IO_clear();
@@ -0,0 +1,333 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 18:05:51
+ * @ Modified time: 2026-10-16 18:05:51
+ * @ Description:
+ *
+ * Replays a whole file of move logs and reports the ones that don't check out.
+ * The games are spread over worker threads the same way the sim spreads them, so thousands of
+ *    games take well under a second. Run it over a profile's replays to catch edited logs, or
+ *    over logs from an older build to see whether anything plays out differently now.
+ * Build it the same way as the game:
+ *
+ *    gcc -Wall -O2 ./src/minesweeper.replay.c -o ./build/minesweeper.replay.o -lrt -lm -lpthread
+ *
+ * and run it with
+ *
+ *    ./build/minesweeper.replay.o <file> [threads] [hashes]
+ *
+ * where threads defaults to the number of cores, and hashes prints a hash of every final board
+ *    (so the output of two builds can be diffed). The exit code is 1 if any game failed.
+ */
+
+#include "game/game.c"
+#include "game/movelog.obj.h"
+#include "game/replay.game.c"
+
+#include "utils/utils.file.h"
+#include "utils/utils.thread.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#define BULK_MAX_WORKERS (MUTEX_MAX_COUNT - 1)  // Every worker but the caller needs a mutex, and the pool needs one
+#define BULK_CHUNK_SIZE 64                      // How many games a worker takes at a time
+#define BULK_MAX_REPORTED 20                    // How many failed games get listed
+
+#define BULK_POOL_MUTEX "bulk-pool-mutex"
+#define BULK_WORKER_MUTEX "bulk-worker-mutex"
+#define BULK_WORKER_THREAD "bulk-worker-thread"
+
+typedef struct BulkWorker BulkWorker;
+typedef struct Bulk Bulk;
+
+/**
+ * //
+ * ////
+ * //////    Bulk structs
+ * ////////
+ * //////////
+*/
+
+/**
+ * A thread's game and what it's replayed so far.
+ *
+ * @struct
+*/
+struct BulkWorker {
+  Bulk *pBulk;
+
+  Game game;                                    // Every log this worker takes is played on this
+  Replay replay;
+
+  int nGames, nValid, nActions;
+  int aOutcomes[GAME_OUTCOME_WIN + 1];          // How the valid games ended
+  int64_t dLoggedTime;                          // How long the games took to play, in milliseconds
+};
+
+/**
+ * The run as a whole.
+ *
+ * @struct
+*/
+struct Bulk {
+  ThreadManager threadManager;
+  int nWorkers;
+  BulkWorker aWorkers[BULK_MAX_WORKERS + 1];
+
+  MoveLogReader *aLogs;                         // Every log in the file
+  char **aErrors;                               // Why each game failed, or NULL
+  uint64_t *aHashes;                            // The final board of each game
+  int nGames;
+  int dNextGame;                                // The next game nobody has taken yet
+  int nGamesDone;
+};
+
+/**
+ * Returns a reading of a steady clock, in seconds.
+ *
+ * @return  { double }    The reading.
+*/
+double Bulk_getTime() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ * Returns how many cores the machine has.
+ *
+ * @return  { int }   The number of cores.
+*/
+int Bulk_getCoreCount() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+
+  return info.dwNumberOfProcessors;
+#else
+  return sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+/**
+ * Splits a file of logs into its logs.
+ * A file that ends partway through a log is reported as one more failed game.
+ *
+ * @param   { Bulk * }      this      The run.
+ * @param   { uint8_t * }   pBytes    The contents of the file.
+ * @param   { size_t }      dLength   The size of the file.
+ * @return  { int }                   Whether or not the whole file was read.
+*/
+int Bulk_readLogs(Bulk *this, uint8_t *pBytes, size_t dLength) {
+  MoveLogReader reader, log;
+  int dCapacity = 0;
+
+  MoveLogReader_init(&reader, pBytes, dLength);
+
+  while(!MoveLogReader_isDone(&reader)) {
+    if(!MoveLogReader_readLog(&reader, &log))
+      return 0;
+
+    if(this->nGames == dCapacity) {
+      dCapacity = dCapacity ? dCapacity * 2 : BULK_CHUNK_SIZE;
+      this->aLogs = realloc(this->aLogs, dCapacity * sizeof(*this->aLogs));
+    }
+
+    this->aLogs[this->nGames++] = log;
+  }
+
+  return 1;
+}
+
+/**
+ * The routine of a worker thread: it replays games until none are left.
+ * The caller runs this too, as worker 0.
+ *
+ * @param   { p_obj }   pArgs_Bulk    The run.
+ * @param   { int }     tArg_Worker   Which worker this is.
+*/
+void Bulk_work(p_obj pArgs_Bulk, int tArg_Worker) {
+  Bulk *this = (Bulk *) pArgs_Bulk;
+  BulkWorker *pWorker = &this->aWorkers[tArg_Worker];
+  MoveLogReader *pLog;
+  int i, dFirst, dLast;
+
+  while(1) {
+    ThreadManager_lockMutex(&this->threadManager, BULK_POOL_MUTEX);
+    dFirst = this->dNextGame;
+    dLast = dFirst + BULK_CHUNK_SIZE < this->nGames ? dFirst + BULK_CHUNK_SIZE : this->nGames;
+    this->dNextGame = dLast;
+    ThreadManager_unlockMutex(&this->threadManager, BULK_POOL_MUTEX);
+
+    if(dFirst >= dLast)
+      return;
+
+    for(i = dFirst; i < dLast; i++) {
+      pLog = &this->aLogs[i];
+
+      if(Replay_run(&pWorker->replay, &pWorker->game, pLog->pBytes, pLog->dLength)) {
+        pWorker->nValid++;
+        pWorker->aOutcomes[pWorker->game.eOutcome]++;
+        pWorker->dLoggedTime += pWorker->replay.dTime;
+      }
+
+      // Every game gets its own slot, so these don't need the lock
+      this->aErrors[i] = pWorker->replay.sError;
+      this->aHashes[i] = pWorker->replay.sError == NULL ? Replay_getHash(&pWorker->replay) : 0;
+
+      pWorker->nActions += pWorker->replay.nActions;
+      pWorker->nGames++;
+    }
+
+    ThreadManager_lockMutex(&this->threadManager, BULK_POOL_MUTEX);
+    this->nGamesDone += dLast - dFirst;
+    ThreadManager_unlockMutex(&this->threadManager, BULK_POOL_MUTEX);
+  }
+}
+
+/**
+ * Replays every game of a run, spread over the workers.
+ *
+ * @param   { Bulk * }  this    The run.
+ * @return  { double }          How many seconds it took.
+*/
+double Bulk_run(Bulk *this) {
+  int i, bIsDone;
+  char sThreadKey[STRING_KEY_MAX_LENGTH];
+  char sMutexKey[STRING_KEY_MAX_LENGTH];
+  double dStart = Bulk_getTime();
+
+  ThreadManager_init(&this->threadManager);
+  ThreadManager_createMutex(&this->threadManager, BULK_POOL_MUTEX);
+
+  // The caller is worker 0
+  for(i = 0; i < this->nWorkers; i++) {
+    this->aWorkers[i].pBulk = this;
+
+    if(i) {
+      sprintf(sThreadKey, "%s-%d", BULK_WORKER_THREAD, i);
+      sprintf(sMutexKey, "%s-%d", BULK_WORKER_MUTEX, i);
+
+      ThreadManager_createMutex(&this->threadManager, sMutexKey);
+      ThreadManager_createThread(&this->threadManager, sThreadKey, sMutexKey, Bulk_work, this, i);
+    }
+  }
+
+  Bulk_work(this, 0);
+
+  // Wait for the games the others are still on
+  do {
+    ThreadManager_lockMutex(&this->threadManager, BULK_POOL_MUTEX);
+    bIsDone = this->nGamesDone == this->nGames;
+    ThreadManager_unlockMutex(&this->threadManager, BULK_POOL_MUTEX);
+  } while(!bIsDone);
+
+  return Bulk_getTime() - dStart;
+}
+
+int main(int argc, char **argv) {
+  int i, nFailed, nReported, bIsWhole, bPrintHashes;
+  long dSize;
+  double dTime;
+  uint8_t *pBytes;
+  File *pFile;
+  BulkWorker total;
+  Bulk *pBulk = calloc(1, sizeof(*pBulk));
+
+  if(argc < 2) {
+    printf("usage: %s <file> [threads] [hashes]\n", argv[0]);
+    return 2;
+  }
+
+  pBulk->nWorkers = argc > 2 ? atoi(argv[2]) : Bulk_getCoreCount();
+  bPrintHashes = argc > 3 && !strcmp(argv[3], "hashes");
+
+  if(pBulk->nWorkers < 1)
+    pBulk->nWorkers = 1;
+
+  if(pBulk->nWorkers > BULK_MAX_WORKERS)
+    pBulk->nWorkers = BULK_MAX_WORKERS;
+
+  // Read the whole file at once
+  pFile = File_create(argv[1]);
+  dSize = File_getSize(pFile);
+
+  if(dSize < 0) {
+    printf("could not open %s\n", argv[1]);
+    return 2;
+  }
+
+  pBytes = calloc(dSize + 1, 1);
+  File_readBinObject(pFile, 0, dSize, pBytes);
+  File_kill(pFile);
+
+  bIsWhole = Bulk_readLogs(pBulk, pBytes, dSize);
+  pBulk->aErrors = calloc(pBulk->nGames + 1, sizeof(*pBulk->aErrors));
+  pBulk->aHashes = calloc(pBulk->nGames + 1, sizeof(*pBulk->aHashes));
+
+  dTime = Bulk_run(pBulk);
+
+  // Add up what everyone replayed
+  memset(&total, 0, sizeof(total));
+
+  for(i = 0; i < pBulk->nWorkers; i++) {
+    total.nGames += pBulk->aWorkers[i].nGames;
+    total.nValid += pBulk->aWorkers[i].nValid;
+    total.nActions += pBulk->aWorkers[i].nActions;
+    total.aOutcomes[GAME_OUTCOME_WIN] += pBulk->aWorkers[i].aOutcomes[GAME_OUTCOME_WIN];
+    total.aOutcomes[GAME_OUTCOME_LOSS] += pBulk->aWorkers[i].aOutcomes[GAME_OUTCOME_LOSS];
+    total.aOutcomes[GAME_OUTCOME_QUIT] += pBulk->aWorkers[i].aOutcomes[GAME_OUTCOME_QUIT];
+    total.dLoggedTime += pBulk->aWorkers[i].dLoggedTime;
+  }
+
+  nFailed = total.nGames - total.nValid + !bIsWhole;
+
+  if(bPrintHashes)
+    for(i = 0; i < pBulk->nGames; i++)
+      printf("%-8d %016llx %s\n", i, (unsigned long long) pBulk->aHashes[i],
+        pBulk->aErrors[i] == NULL ? "ok" : pBulk->aErrors[i]);
+
+  printf("%-8s %-8s %-8s %-8s %-8s %-8s %-10s %-12s %-14s %s\n",
+    "threads", "games", "valid", "failed", "wins", "losses", "quits", "games/s", "actions/s", "vs real time");
+  printf("%-8d %-8d %-8d %-8d %-8d %-8d %-10d %-12.0f %-14.0f %.0fx\n",
+    pBulk->nWorkers, total.nGames, total.nValid, nFailed,
+    total.aOutcomes[GAME_OUTCOME_WIN], total.aOutcomes[GAME_OUTCOME_LOSS], total.aOutcomes[GAME_OUTCOME_QUIT],
+    total.nGames / dTime, total.nActions / dTime, total.dLoggedTime / 1000.0 / dTime);
+
+  // Say what went wrong
+  if(nFailed)
+    printf("\n%-8s %s\n", "game", "reason");
+
+  for(i = 0, nReported = 0; i < pBulk->nGames && nReported < BULK_MAX_REPORTED; i++) {
+    if(pBulk->aErrors[i] == NULL)
+      continue;
+
+    printf("%-8d %s\n", i, pBulk->aErrors[i]);
+    nReported++;
+  }
+
+  if(!bIsWhole)
+    printf("%-8d %s\n", pBulk->nGames, "file ends partway through a log");
+
+  // The workers only ever touch the counters now
+  for(i = 0; i < pBulk->nWorkers; i++) {
+    Field_exit(&pBulk->aWorkers[i].game.field);
+    History_exit(&pBulk->aWorkers[i].game.history);
+    MoveLog_exit(&pBulk->aWorkers[i].game.log);
+  }
+
+  free(pBulk->aLogs);
+  free(pBulk->aErrors);
+  free(pBulk->aHashes);
+  free(pBytes);
+
+  return total.nValid < total.nGames || !bIsWhole;
+}
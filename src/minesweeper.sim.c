@@ -0,0 +1,576 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 15:31:08
+ * @ Modified time: 2026-10-16 15:31:08
+ * @ Description:
+ *
+ * Plays lots of games without the console, with a bot making the moves.
+ * Every worker thread owns its own game and takes games off a shared counter a chunk at a time,
+ *    so adding cores adds games per second. The board of game i only depends on i, so the same
+ *    run gives the same results no matter how many threads it used.
+ * Build it the same way as the game:
+ *
+ *    gcc -Wall -O2 ./src/minesweeper.sim.c -o ./build/minesweeper.sim.o -lrt -lm -lpthread
+ *
+ * and run it with
+ *
+ *    ./build/minesweeper.sim.o [random|solver|chance] [games] [threads] [easy|difficult] [noguess] [--log <file>]
+ *
+ * where threads defaults to the number of cores. With --log, the move log of every game is written
+ *    to the file, which minesweeper.replay.c can then check.
+ */
+
+#include "game/game.c"
+#include "game/probability.game.c"
+#include "game/solver.game.c"
+
+#include "utils/utils.thread.h"
+
+#include <stdio.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#define SIM_BOT_COUNT 3
+#define SIM_MAX_WORKERS (MUTEX_MAX_COUNT - 1)   // Every worker but the caller needs a mutex, and the pool needs one
+
+#define SIM_CHUNK_SIZE 64                       // How many games a worker takes at a time
+#define SIM_DEFAULT_GAMES 100000
+
+// The seed every run starts from, so runs can be compared
+#define SIM_SEED 0x5eedULL
+
+#define SIM_POOL_MUTEX "sim-pool-mutex"
+#define SIM_WORKER_MUTEX "sim-worker-mutex"
+#define SIM_WORKER_THREAD "sim-worker-thread"
+
+typedef struct SimBot SimBot;
+typedef struct SimWorker SimWorker;
+typedef struct Sim Sim;
+
+typedef void (*f_sim_move)(SimWorker *pWorker, int *x, int *y);   // Picks the next tile a bot inspects
+
+/**
+ * //
+ * ////
+ * //////    Sim structs
+ * ////////
+ * //////////
+*/
+
+/**
+ * A way of playing.
+ *
+ * @struct
+*/
+struct SimBot {
+  char *sName;
+  f_sim_move fMove;
+};
+
+/**
+ * A thread's game, the tools its bot uses, and what it's played so far.
+ *
+ * @struct
+*/
+struct SimWorker {
+  Sim *pSim;
+
+  Game game;                                    // The game being played
+  Random random;                                // The bot's own dice; reseeded every game
+  Solver solver;                                // For bots that only guess when they have to
+  Probability probability;                      // For bots that guess the safest tile
+  int bHasSolver;                               // Whether the solver has been set up yet
+  MoveLog archive;                              // The logs of the games played so far, if they're kept
+
+  int nGames, nWins, nMoves, nGuesses;
+  double dSetupTime;                            // Spent in Game_setup() and Game_init(), in thread time
+  double dFirstTime;                            // Spent on the first inspect, which makes the board
+  double dPlayTime;                             // Spent on every move after that
+};
+
+/**
+ * The run as a whole.
+ *
+ * @struct
+*/
+struct Sim {
+  SimBot *pBot;
+  GameDifficulty eDifficulty;
+  int bNoGuess;
+  char *sLogPath;                               // Where the move logs go; NULL if they aren't kept
+
+  ThreadManager threadManager;
+  int nWorkers;
+  SimWorker aWorkers[SIM_MAX_WORKERS + 1];
+
+  int nGames;
+  int dNextGame;                                // The next game nobody has taken yet
+  int nGamesDone;
+};
+
+/**
+ * //
+ * ////
+ * //////    Helpers
+ * ////////
+ * //////////
+*/
+
+/**
+ * Returns a reading of a clock, in seconds.
+ * CLOCK_MONOTONIC gives the time that has passed; CLOCK_THREAD_CPUTIME_ID gives the time the calling
+ *    thread has spent running, which doesn't get thrown off when there are more threads than cores.
+ *
+ * @param   { clockid_t }   dClock    Which clock to read.
+ * @return  { double }                The reading.
+*/
+double Sim_getTime(clockid_t dClock) {
+  struct timespec time;
+
+  clock_gettime(dClock, &time);
+
+  return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ * Returns how many cores the machine has.
+ *
+ * @return  { int }   The number of cores.
+*/
+int Sim_getCoreCount() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+
+  return info.dwNumberOfProcessors;
+#else
+  return sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+/**
+ * Finds a tile the solver has proven safe that hasn't been inspected yet.
+ *
+ * @param   { SimWorker * }   this    The worker.
+ * @param   { int * }         x       Where to put the x-coordinate of the tile.
+ * @param   { int * }         y       Where to put the y-coordinate of the tile.
+ * @return  { int }                   Whether there was one.
+*/
+int Sim_findSafe(SimWorker *this, int *x, int *y) {
+  int j, w;
+  uint64_t dSafe;
+  Field *pField = &this->game.field;
+
+  for(j = 0; j < pField->dHeight; j++) {
+    for(w = 0; w < pField->pInspectGrid->dStride; w++) {
+      dSafe = Grid_getRow(this->solver.pSafe, j)[w] & ~Grid_getRow(pField->pInspectGrid, j)[w];
+
+      if(dSafe) {
+        *x = (w << GRID_WORD_SHIFT) + __builtin_ctzll(dSafe);
+        *y = j;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Picks any tile that could still be safe: not inspected, not flagged and not proven to be a mine.
+ *
+ * @param   { SimWorker * }   this    The worker.
+ * @param   { int * }         x       Where to put the x-coordinate of the tile.
+ * @param   { int * }         y       Where to put the y-coordinate of the tile.
+*/
+void Sim_guessRandom(SimWorker *this, int *x, int *y) {
+  Field *pField = &this->game.field;
+
+  do {
+    *x = Random_range(&this->random, pField->dWidth);
+    *y = Random_range(&this->random, pField->dHeight);
+  } while(
+    Grid_getBit(pField->pInspectGrid, *x, *y) ||
+    Grid_getBit(pField->pFlagGrid, *x, *y) ||
+    (this->bHasSolver && Grid_getBit(this->solver.pMines, *x, *y)));
+
+  this->nGuesses++;
+}
+
+/**
+ * //
+ * ////
+ * //////    Bots
+ * ////////
+ * //////////
+*/
+
+/**
+ * Inspects tiles at random.
+ *
+ * @param   { SimWorker * }   this    The worker.
+ * @param   { int * }         x       Where to put the x-coordinate of the tile.
+ * @param   { int * }         y       Where to put the y-coordinate of the tile.
+*/
+void Sim_moveRandom(SimWorker *this, int *x, int *y) {
+  Sim_guessRandom(this, x, y);
+}
+
+/**
+ * Inspects whatever the solver proves safe, and guesses at random when it can't prove anything.
+ * What the solver proves stays on its grids until the next game, so it only runs when it runs out of tiles.
+ *
+ * @param   { SimWorker * }   this    The worker.
+ * @param   { int * }         x       Where to put the x-coordinate of the tile.
+ * @param   { int * }         y       Where to put the y-coordinate of the tile.
+*/
+void Sim_moveSolver(SimWorker *this, int *x, int *y) {
+  if(Sim_findSafe(this, x, y))
+    return;
+
+  Solver_deduce(&this->solver);
+
+  if(Sim_findSafe(this, x, y))
+    return;
+
+  Sim_guessRandom(this, x, y);
+}
+
+/**
+ * Inspects the tile least likely to be a mine.
+ * When nothing is certain, this is the best guess there is.
+ *
+ * @param   { SimWorker * }   this    The worker.
+ * @param   { int * }         x       Where to put the x-coordinate of the tile.
+ * @param   { int * }         y       Where to put the y-coordinate of the tile.
+*/
+void Sim_moveChance(SimWorker *this, int *x, int *y) {
+  int i, dBest = -1;
+  int dWidth = this->game.field.dWidth;
+  int dCells = dWidth * this->game.field.dHeight;
+  double *aChances;
+
+  if(!Probability_compute(&this->probability, &this->game.field)) {
+    Sim_guessRandom(this, x, y);
+    return;
+  }
+
+  aChances = this->probability.aChances;
+
+  for(i = 0; i < dCells; i++)
+    if(aChances[i] >= 0 && (dBest < 0 || aChances[i] < aChances[dBest]))
+      dBest = i;
+
+  *x = dBest % dWidth;
+  *y = dBest / dWidth;
+
+  if(aChances[dBest] > 0)
+    this->nGuesses++;
+}
+
+SimBot aSimBots[SIM_BOT_COUNT] = {
+  { "random", Sim_moveRandom },
+  { "solver", Sim_moveSolver },
+  { "chance", Sim_moveChance },
+};
+
+/**
+ * //
+ * ////
+ * //////    Workers
+ * ////////
+ * //////////
+*/
+
+/**
+ * Plays a single game from start to end.
+ * The first inspect always goes in the middle of the board.
+ *
+ * @param   { SimWorker * }   this    The worker.
+ * @param   { int }           dGame   Which game of the run this is.
+*/
+void Sim_playGame(SimWorker *this, int dGame) {
+  Game *pGame = &this->game;
+  Field *pField = &pGame->field;
+  uint64_t dSeed = SIM_SEED + dGame;
+  double dStart, dSetup, dFirst;
+  int x, y;
+
+  dStart = Sim_getTime(CLOCK_THREAD_CPUTIME_ID);
+
+  Game_setup(pGame, GAME_TYPE_CLASSIC, this->pSim->eDifficulty);
+  Game_setSeed(pGame, Random_splitMix(&dSeed));
+  Game_setNoGuess(pGame, this->pSim->bNoGuess);
+  Game_init(pGame);
+
+  Random_seed(&this->random, pGame->dSeed);
+
+  // The solver only has to be made again if the board changes size
+  if(!this->bHasSolver ||
+    this->solver.pSafe->dWidth != pField->dWidth ||
+    this->solver.pSafe->dHeight != pField->dHeight) {
+
+    if(this->bHasSolver)
+      Solver_exit(&this->solver);
+
+    Solver_init(&this->solver, pField);
+    this->bHasSolver = 1;
+  }
+
+  Solver_clear(&this->solver);
+
+  dSetup = Sim_getTime(CLOCK_THREAD_CPUTIME_ID);
+
+  Game_inspect(pGame, pField->dWidth / 2, pField->dHeight / 2);
+
+  dFirst = Sim_getTime(CLOCK_THREAD_CPUTIME_ID);
+
+  while(!Game_isDone(pGame)) {
+    this->pSim->pBot->fMove(this, &x, &y);
+    Game_inspect(pGame, x, y);
+    this->nMoves++;
+  }
+
+  this->dSetupTime += dSetup - dStart;
+  this->dFirstTime += dFirst - dSetup;
+  this->dPlayTime += Sim_getTime(CLOCK_THREAD_CPUTIME_ID) - dFirst;
+
+  this->nWins += Game_isWon(pGame);
+  this->nGames++;
+
+  if(this->pSim->sLogPath != NULL) {
+    Game_closeLog(pGame);
+    MoveLog_pack(&pGame->log, &this->archive);
+  }
+}
+
+/**
+ * The routine of a worker thread: it plays games until none are left.
+ * The caller runs this too, as worker 0.
+ *
+ * @param   { p_obj }   pArgs_Sim     The run.
+ * @param   { int }     tArg_Worker   Which worker this is.
+*/
+void Sim_work(p_obj pArgs_Sim, int tArg_Worker) {
+  Sim *this = (Sim *) pArgs_Sim;
+  SimWorker *pWorker = &this->aWorkers[tArg_Worker];
+  int i, dFirst, dLast;
+
+  while(1) {
+    ThreadManager_lockMutex(&this->threadManager, SIM_POOL_MUTEX);
+    dFirst = this->dNextGame;
+    dLast = dFirst + SIM_CHUNK_SIZE < this->nGames ? dFirst + SIM_CHUNK_SIZE : this->nGames;
+    this->dNextGame = dLast;
+    ThreadManager_unlockMutex(&this->threadManager, SIM_POOL_MUTEX);
+
+    if(dFirst >= dLast)
+      return;
+
+    for(i = dFirst; i < dLast; i++)
+      Sim_playGame(pWorker, i);
+
+    ThreadManager_lockMutex(&this->threadManager, SIM_POOL_MUTEX);
+    this->nGamesDone += dLast - dFirst;
+    ThreadManager_unlockMutex(&this->threadManager, SIM_POOL_MUTEX);
+  }
+}
+
+/**
+ * Plays every game of a run, spread over the workers.
+ *
+ * @param   { Sim * }   this    The run.
+ * @return  { double }          How many seconds it took.
+*/
+double Sim_run(Sim *this) {
+  int i, bIsDone;
+  char sThreadKey[STRING_KEY_MAX_LENGTH];
+  char sMutexKey[STRING_KEY_MAX_LENGTH];
+  double dStart = Sim_getTime(CLOCK_MONOTONIC);
+
+  ThreadManager_init(&this->threadManager);
+  ThreadManager_createMutex(&this->threadManager, SIM_POOL_MUTEX);
+
+  // The caller is worker 0
+  for(i = 0; i < this->nWorkers; i++) {
+    this->aWorkers[i].pSim = this;
+    Probability_init(&this->aWorkers[i].probability, NULL);
+
+    if(i) {
+      sprintf(sThreadKey, "%s-%d", SIM_WORKER_THREAD, i);
+      sprintf(sMutexKey, "%s-%d", SIM_WORKER_MUTEX, i);
+
+      ThreadManager_createMutex(&this->threadManager, sMutexKey);
+      ThreadManager_createThread(&this->threadManager, sThreadKey, sMutexKey, Sim_work, this, i);
+    }
+  }
+
+  Sim_work(this, 0);
+
+  // Wait for the games the others are still on
+  do {
+    ThreadManager_lockMutex(&this->threadManager, SIM_POOL_MUTEX);
+    bIsDone = this->nGamesDone == this->nGames;
+    ThreadManager_unlockMutex(&this->threadManager, SIM_POOL_MUTEX);
+  } while(!bIsDone);
+
+  return Sim_getTime(CLOCK_MONOTONIC) - dStart;
+}
+
+/**
+ * Reads a count off the command line.
+ * 
+ * @param   { char * }  sArg    The argument.
+ * @return  { int }             The count, or 0 if the argument isn't a positive number.
+*/
+int Sim_readCount(char *sArg) {
+  char *sEnd;
+  long dCount = strtol(sArg, &sEnd, 10);
+
+  if(sEnd == sArg || *sEnd != '\0' || dCount < 1 || dCount > INT_MAX)
+    return 0;
+
+  return dCount;
+}
+
+/**
+ * Reads the options of the run, all of which can be left out.
+ * Anything it doesn't recognize, --help included, makes it give up.
+ * 
+ * @param   { Sim * }     this    The simulation.
+ * @param   { int }       argc    How many arguments there are.
+ * @param   { char ** }   argv    The arguments.
+ * @return  { int }               Whether or not the arguments made sense.
+*/
+int Sim_readArgs(Sim *this, int argc, char **argv) {
+  int i;
+
+  this->pBot = &aSimBots[1];
+  this->nGames = SIM_DEFAULT_GAMES;
+  this->nWorkers = Sim_getCoreCount();
+  this->eDifficulty = GAME_DIFFICULTY_DIFFICULT;
+
+  // The log file comes last, so it doesn't get in the way of the others
+  if(argc > 2 && !strcmp(argv[argc - 2], "--log")) {
+    this->sLogPath = argv[argc - 1];
+    argc -= 2;
+  }
+
+  if(argc > 6)
+    return 0;
+
+  // Flags only go at the end, so anything else that looks like one is wrong
+  for(i = 1; i < argc; i++)
+    if(argv[i][0] == '-')
+      return 0;
+
+  if(argc > 1) {
+    for(i = 0; i < SIM_BOT_COUNT && strcmp(argv[1], aSimBots[i].sName); i++);
+
+    if(i == SIM_BOT_COUNT)
+      return 0;
+
+    this->pBot = &aSimBots[i];
+  }
+
+  if(argc > 2 && !(this->nGames = Sim_readCount(argv[2])))
+    return 0;
+
+  if(argc > 3 && !(this->nWorkers = Sim_readCount(argv[3])))
+    return 0;
+
+  if(argc > 4) {
+    if(!strcmp(argv[4], "easy"))
+      this->eDifficulty = GAME_DIFFICULTY_EASY;
+    else if(strcmp(argv[4], "difficult"))
+      return 0;
+  }
+
+  if(argc > 5) {
+    if(strcmp(argv[5], "noguess"))
+      return 0;
+
+    this->bNoGuess = 1;
+  }
+
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  int i;
+  double dTime, dGames;
+  SimWorker total;
+  File *pLogFile;
+  Sim *pSim = calloc(1, sizeof(*pSim));
+
+  if(!Sim_readArgs(pSim, argc, argv)) {
+    printf("usage: %s [random|solver|chance] [games] [threads] [easy|difficult] [noguess] [--log <file>]\n", argv[0]);
+    free(pSim);
+    return 2;
+  }
+
+  if(pSim->nWorkers < 1)
+    pSim->nWorkers = 1;
+
+  if(pSim->nWorkers > SIM_MAX_WORKERS)
+    pSim->nWorkers = SIM_MAX_WORKERS;
+
+  dTime = Sim_run(pSim);
+
+  // Add up what everyone played
+  memset(&total, 0, sizeof(total));
+
+  for(i = 0; i < pSim->nWorkers; i++) {
+    total.nGames += pSim->aWorkers[i].nGames;
+    total.nWins += pSim->aWorkers[i].nWins;
+    total.nMoves += pSim->aWorkers[i].nMoves;
+    total.nGuesses += pSim->aWorkers[i].nGuesses;
+    total.dSetupTime += pSim->aWorkers[i].dSetupTime;
+    total.dFirstTime += pSim->aWorkers[i].dFirstTime;
+    total.dPlayTime += pSim->aWorkers[i].dPlayTime;
+  }
+
+  dGames = total.nGames > 0 ? total.nGames : 1;
+
+  printf("%-8s %-8s %-8s %-8s %-10s %-12s %-8s %-8s %s\n",
+    "bot", "board", "noguess", "threads", "games", "games/s", "win %", "moves", "guesses");
+  printf("%-8s %-8s %-8s %-8d %-10d %-12.0f %-8.2f %-8.2f %.2f\n",
+    pSim->pBot->sName, pSim->eDifficulty == GAME_DIFFICULTY_EASY ? "easy" : "difficult",
+    pSim->bNoGuess ? "yes" : "no", pSim->nWorkers, total.nGames, total.nGames / dTime,
+    total.nWins * 100.0 / dGames, total.nMoves / dGames, total.nGuesses / dGames);
+
+  // The phases are timed on each thread, so these are per game and don't depend on the thread count
+  printf("\n%-16s %s\n", "phase", "us/game");
+  printf("%-16s %.2f\n", "setup", total.dSetupTime * 1e6 / dGames);
+  printf("%-16s %.2f\n", "first inspect", total.dFirstTime * 1e6 / dGames);
+  printf("%-16s %.2f\n", "play", total.dPlayTime * 1e6 / dGames);
+
+  // Each worker kept its own logs, so they're written one worker after the other
+  if(pSim->sLogPath != NULL) {
+    pLogFile = File_create(pSim->sLogPath);
+    File_clear(pLogFile);
+    File_kill(pLogFile);
+
+    for(i = 0; i < pSim->nWorkers; i++)
+      MoveLog_write(&pSim->aWorkers[i].archive, pSim->sLogPath);
+  }
+
+  // The workers only ever touch the counters now
+  for(i = 0; i < pSim->nWorkers; i++) {
+    Field_exit(&pSim->aWorkers[i].game.field);
+    History_exit(&pSim->aWorkers[i].game.history);
+    MoveLog_exit(&pSim->aWorkers[i].game.log);
+    MoveLog_exit(&pSim->aWorkers[i].archive);
+    Probability_exit(&pSim->aWorkers[i].probability);
+
+    if(pSim->aWorkers[i].bHasSolver)
+      Solver_exit(&pSim->aWorkers[i].solver);
+  }
+
+  return 0;
+}
@@ -17,6 +17,44 @@
 #include "../utils/utils.page.h"
 #include "../utils/utils.component.h"
 
+/**
+ * Draws the tiles of the field being edited, along with its mines.
+ * 
+ * @param   { p_obj }     pArgs_Page  The page the field belongs to.
+ * @param   { Buffer * }  pBuffer     The buffer to draw on.
+ * @param   { int }       x           Where the first tile goes in the buffer.
+ * @param   { int }       y           Where the first tile goes in the buffer.
+ * @param   { int }       dStartX     The first column to draw.
+ * @param   { int }       dStartY     The first row to draw.
+ * @param   { int }       dEndX       The column to stop at.
+ * @param   { int }       dEndY       The row to stop at.
+*/
+void PageHandler_editorITiles(p_obj pArgs_Page, Buffer *pBuffer, int x, int y, int dStartX, int dStartY, int dEndX, int dEndY) {
+  Page *this = (Page *) pArgs_Page;
+  Game *pGame = (Game *) this->pSharedObject;
+  int dTileX, dTileY, dCellX, dCellY;
+  char *sMine = "(#)";
+
+  // The colors are the same for every tile
+  color colorMine = ThemeManager_getActive(this->pSharedThemeManager, "accent2");
+  color colorMineDarken = ThemeManager_getActive(this->pSharedThemeManager, "accent2-darken-0.36");
+
+  for(dTileX = dStartX; dTileX < dEndX; dTileX++) {
+    for(dTileY = dStartY; dTileY < dEndY; dTileY++) {
+      dCellX = x + dTileX * GAME_CELL_WIDTH;
+      dCellY = y + dTileY * GAME_CELL_HEIGHT;
+
+      Game_drawTile(pGame, pBuffer, dCellX, dCellY, dTileX, dTileY);
+
+      if(Grid_getBit(pGame->field.pMineGrid, dTileX, dTileY)) {
+        Buffer_contextRect(pBuffer, dCellX + 1, dCellY + 1, 3, 1, colorMine, -1);
+        Buffer_contextRect(pBuffer, dCellX + 1, dCellY + 1, 1, 1, colorMineDarken, -1);
+        Buffer_write(pBuffer, dCellX + 1, dCellY + 1, 1, &sMine);
+      }
+    }
+  }
+}
+
 /**
  * Configures the main menu.
  * 
@@ -26,32 +64,29 @@ void PageHandler_editorI(p_obj pArgs_Page) {
 
   Page *this = (Page *) pArgs_Page;
   Game *pGame = (Game *) this->pSharedObject;
-  int dWidth, dHeight, dMargin, x, y;
+  int dWidth, dHeight, dMargin;
 
   // Component names
   char *sEditorIComponent = "editor-i.fixed";
   char *sLefterComponent = "lefter.fixed.aright-x.atop-y";
   char *sFooterComponent = "footer.fixed.aleft-x.atop-y";
   char *sFieldContainerComponent = "field-container.fixed";
-  char *sFieldComponent = "field.acenter-x.acenter-y";
+  char *sFieldComponent = "field.aleft-x.atop-y";
   char *sFieldCursorComponent = "field-cursor.aleft-x.atop-y";
   char *sEditorPromptComponent = "editor-prompt.fixed.aleft-x.atop-y";
   char *sSideInfoComponent = "side-info.fixed.aleft-x.atop-y";
   char *sPopupComponent = "popup.fixed";
 
-  // For inspect components
-  char sMineKey[STRING_KEY_MAX_LENGTH];
-
   // Some of the component contents
   char sEditorPromptText[STRING_KEY_MAX_LENGTH];
   char sSideInfoText[STRING_KEY_MAX_LENGTH];
 
-  // Buffer for minesweeper grid 
-  char *sGridBuffer;
-
   // Pressed key
   char cKeyPressed = 0;
 
+  // The first corner of a box being filled, if any
+  int dCornerX, dCornerY;
+
   // Do stuff based on page status
   switch(this->ePageStatus) {
 
@@ -62,52 +97,25 @@ void PageHandler_editorI(p_obj pArgs_Page) {
       dHeight = IO_getHeight();
       dMargin = 3;
 
+      // No box is being filled yet
+      Page_setUserState(this, "corner-x", -1);
+
       // Create component tree
       Page_addComponentContext(this, sEditorIComponent, "root", 0, 0, dWidth, dHeight, "primary", "secondary");
       Page_addComponentContainer(this, sLefterComponent, sEditorIComponent, dWidth / 2 + Game_getCharWidth(pGame) / 2 + dMargin * 2, dHeight / 2 - Game_getCharHeight(pGame) / 2 - 1);
       Page_addComponentContainer(this, sFooterComponent, sEditorIComponent, dWidth / 2 - Game_getCharWidth(pGame) / 2, dHeight / 2 + Game_getCharHeight(pGame) / 2 + dMargin / 2);
       Page_addComponentContainer(this, sFieldContainerComponent, sEditorIComponent, dWidth / 2, dHeight / 2);
-      Page_addComponentText(this, sFieldComponent, sFieldContainerComponent, 0, 0, "primary-darken-0.75", "", "");
+      Page_addComponentTilemap(this, sFieldComponent, sFieldContainerComponent, 
+        -Game_getCharWidth(pGame) / 2, 
+        -Game_getCharHeight(pGame) / 2 - 1, 
+        "primary-darken-0.75", "", 
+        PageHandler_editorITiles, this, 
+        GAME_CELL_WIDTH, GAME_CELL_HEIGHT, pGame->field.dWidth, pGame->field.dHeight);
       Page_addComponentAsset(this, sFieldCursorComponent, sFieldComponent, 0, 0, "accent", "", "field-cursor");
       Page_addComponentText(this, sSideInfoComponent, sLefterComponent, 0, 0, "", "", "");
       Page_addComponentText(this, sEditorPromptComponent, sFooterComponent, 0, 0, "", "", "");
       Page_addComponentPopup(this, sPopupComponent, dWidth / 2, dHeight / 2, 56, 14, "secondary", "accent", "", "", "");
 
-      // This is stupid but LMAO
-      for(x = 0; x < pGame->field.dWidth; x++) {
-        for(y = 0; y < pGame->field.dHeight; y++) {
-
-          // The key
-          sprintf(sMineKey, "flag-%d-%d", x, y);
-
-          // Create the component
-          Page_addComponentText(this, 
-            sMineKey, 
-            sFieldContainerComponent, 
-            
-            x * GAME_CELL_WIDTH - Game_getCharWidth(pGame) / 2 + 1, 
-            y * GAME_CELL_HEIGHT - Game_getCharHeight(pGame) / 2,  
-            
-            "accent2", "", "");
-
-          sprintf(sMineKey, "flag-darken-%d-%d", x, y);
-
-          Page_addComponentText(this, 
-            sMineKey, 
-            sFieldContainerComponent, 
-            
-            x * GAME_CELL_WIDTH - Game_getCharWidth(pGame) / 2 + 1, 
-            y * GAME_CELL_HEIGHT - Game_getCharHeight(pGame) / 2,  
-            
-            "accent2-darken-0.36", "", " ");
-        }
-      }
-
-      // Display the actual grid
-      sGridBuffer = String_alloc(Game_getCharWidth(pGame) * Game_getCharHeight(pGame) * 4);
-      Game_displayGrid(pGame, sGridBuffer);
-      Page_setComponentText(this, sFieldComponent, sGridBuffer);
-      String_kill(sGridBuffer);
     break;
 
     case PAGE_ACTIVE_RUNNING:
@@ -228,46 +236,60 @@ void PageHandler_editorI(p_obj pArgs_Page) {
               // If already has a flag
               else Editor_removeMine(pGame);
             }
-            
-            // For each cell, check if it's been inspected, and if so, change color
-            for(x = 0; x < pGame->field.dWidth; x++) {
-              for(y = 0; y < pGame->field.dHeight; y++) {
-                
-                // The key
-                sprintf(sMineKey, "flag-%d-%d", x, y);
-                
-                // If there's a flag on it
-                if(Grid_getBit(pGame->field.pMineGrid, x, y))
-                  Page_setComponentText(this, sMineKey, "(#)");
-                
-                // Remove flag if it exists
-                else
-                  Page_setComponentText(this, sMineKey, "");
+
+            // Bulk edits
+            if(cKeyPressed == '|')
+              Editor_mirror(pGame);
+
+            if(cKeyPressed == '-')
+              Editor_flip(pGame);
+
+            if(cKeyPressed == '%')
+              Editor_fillRandom(pGame, EDITOR_SCATTER_PERCENT);
+
+            // The page is laid out for the current size, so only square fields can turn
+            if(cKeyPressed == '@' && pGame->field.dWidth == pGame->field.dHeight)
+              Editor_rotate(pGame);
+
+            // The first press marks a corner, the second fills the box up to the cursor
+            // The box gets the opposite of what the first corner had
+            if(cKeyPressed == '#') {
+              dCornerX = Page_getUserState(this, "corner-x");
+              dCornerY = Page_getUserState(this, "corner-y");
+
+              if(dCornerX < 0) {
+                Page_setUserState(this, "corner-x", pGame->dCursorX);
+                Page_setUserState(this, "corner-y", pGame->dCursorY);
+                Page_setUserState(this, "corner-mines", !Grid_getBit(pGame->field.pMineGrid, pGame->dCursorX, pGame->dCursorY));
+              
+              } else {
+                Editor_fillRect(pGame, 
+                  dCornerX < pGame->dCursorX ? dCornerX : pGame->dCursorX, 
+                  dCornerY < pGame->dCursorY ? dCornerY : pGame->dCursorY, 
+                  abs(pGame->dCursorX - dCornerX) + 1, 
+                  abs(pGame->dCursorY - dCornerY) + 1, 
+                  Page_getUserState(this, "corner-mines"));
+                Page_setUserState(this, "corner-x", -1);
               }
             }
 
           break;
         }
 
-        // Display the actual grid
-        sGridBuffer = String_alloc(Game_getCharWidth(pGame) * Game_getCharHeight(pGame) * 4);
-        Game_displayGrid(pGame, sGridBuffer);
-        Page_setComponentText(this, sFieldComponent, sGridBuffer);
-        String_kill(sGridBuffer);
-
         // Update UI
         Page_setComponentPos(this, sFieldCursorComponent, 
           pGame->dCursorX * GAME_CELL_WIDTH, 
           pGame->dCursorY * GAME_CELL_HEIGHT);
 
         // Player information text
-        sprintf(sSideInfoText, "%s.txt\n%d mines",
+        sprintf(sSideInfoText, "%s.txt\n%d mines%s",
           Editor_getSaveName(pGame),
-          Editor_countMines(pGame));
+          Editor_countMines(pGame),
+          Page_getUserState(this, "corner-x") < 0 ? "" : "\n\ncorner marked");
         Page_setComponentText(this, sSideInfoComponent, sSideInfoText);
 
         // Prompt text
-        sprintf(sEditorPromptText, "[%s%s%s%s]   to move\n[%s]      to toggle a mine\n[enter]  to exit and save file\n[esc]    to clear grid",
+        sprintf(sEditorPromptText, "[%s%s%s%s]   to move\n[%s]      to toggle a mine\n[| - @]  to mirror, flip or turn\n[%%]      to scatter mines\n[#]      twice to fill or clear a box\n[enter]  to exit and save file\n[esc]    to clear grid",
           String_renderEscChar(Settings_getGameMoveUp(this->pSharedEventStore)),
           String_renderEscChar(Settings_getGameMoveLeft(this->pSharedEventStore)),
           String_renderEscChar(Settings_getGameMoveDown(this->pSharedEventStore)),
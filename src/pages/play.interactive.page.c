@@ -23,6 +23,67 @@
 #include <string.h>
 #include <ctype.h>
 
+/**
+ * Draws the tiles of the field, along with the flags and the shading of the inspected tiles.
+ * The tiles are drawn column by column, so neighboring tiles overlap in the same order they used to.
+ * 
+ * @param   { p_obj }     pArgs_Page  The page the field belongs to.
+ * @param   { Buffer * }  pBuffer     The buffer to draw on.
+ * @param   { int }       x           Where the first tile goes in the buffer.
+ * @param   { int }       y           Where the first tile goes in the buffer.
+ * @param   { int }       dStartX     The first column to draw.
+ * @param   { int }       dStartY     The first row to draw.
+ * @param   { int }       dEndX       The column to stop at.
+ * @param   { int }       dEndY       The row to stop at.
+*/
+void PageHandler_playITiles(p_obj pArgs_Page, Buffer *pBuffer, int x, int y, int dStartX, int dStartY, int dEndX, int dEndY) {
+  Page *this = (Page *) pArgs_Page;
+  Game *pGame = (Game *) this->pSharedObject;
+  Field *pField = &pGame->field;
+  int dTileX, dTileY, dCellX, dCellY;
+  int bIsWon, bIsLost, bIsMine, bIsFlag, bIsFalseFlag;
+  char *sFlag;
+
+  // The colors are the same for every tile
+  color colorFlag = ThemeManager_getActive(this->pSharedThemeManager, "accent2");
+  color colorFlagDarken = ThemeManager_getActive(this->pSharedThemeManager, "accent2-darken-0.36");
+  color colorFalseFlag = ThemeManager_getActive(this->pSharedThemeManager, "accent");
+  color colorFalseFlagDarken = ThemeManager_getActive(this->pSharedThemeManager, "accent-darken-0.25");
+  color colorNumber = ThemeManager_getActive(this->pSharedThemeManager, "primary-darken-0.25");
+  color colorEmpty = ThemeManager_getActive(this->pSharedThemeManager, "primary-darken-0.5");
+
+  bIsWon = Game_isWon(pGame);
+  bIsLost = !bIsWon && Game_isDone(pGame);
+
+  for(dTileX = dStartX; dTileX < dEndX; dTileX++) {
+    for(dTileY = dStartY; dTileY < dEndY; dTileY++) {
+      dCellX = x + dTileX * GAME_CELL_WIDTH;
+      dCellY = y + dTileY * GAME_CELL_HEIGHT;
+
+      bIsMine = Grid_getBit(pField->pMineGrid, dTileX, dTileY);
+      bIsFlag = Grid_getBit(pField->pFlagGrid, dTileX, dTileY);
+      bIsFalseFlag = bIsLost && bIsFlag && !bIsMine;
+
+      Game_drawTile(pGame, pBuffer, dCellX, dCellY, dTileX, dTileY);
+
+      // Mines are shown once the game is lost; otherwise, the flags
+      sFlag = bIsLost && bIsMine ? "(#)" : bIsFlag ? "▐▀ " : NULL;
+
+      if(sFlag != NULL) {
+        Buffer_contextRect(pBuffer, dCellX + 1, dCellY + 1, 3, 1, bIsFalseFlag ? colorFalseFlag : colorFlag, -1);
+        Buffer_contextRect(pBuffer, dCellX + 1, dCellY + 1, 1, 1, bIsFalseFlag ? colorFalseFlagDarken : colorFlagDarken, -1);
+        Buffer_write(pBuffer, dCellX + 1, dCellY + 1, 1, &sFlag);
+      }
+
+      // A lighter shade for numbers > 0, and a darker one otherwise; the whole grid turns yellow once the game is won
+      if(Grid_getBit(pField->pInspectGrid, dTileX, dTileY)) {
+        Buffer_contextRect(pBuffer, dCellX, dCellY, GAME_CELL_WIDTH + 1, GAME_CELL_HEIGHT + 1, 
+          bIsWon ? colorFalseFlag : pField->aNumbers[dTileY][dTileX] > 0 ? colorNumber : colorEmpty, -1);
+      }
+    }
+  }
+}
+
 /**
  * Configures the main menu.
  * 
@@ -33,7 +94,7 @@ void PageHandler_playI(p_obj pArgs_Page) {
   Page *this = (Page *) pArgs_Page;
   Game *pGame = (Game *) this->pSharedObject;
   Profile *pProfile = (Profile *) pGame->pProfile;
-  int dWidth, dHeight, dMargin, x, y;
+  int dWidth, dHeight, dMargin;
 
   // Component names
   char *sPlayIComponent = "play-i.fixed";
@@ -41,36 +102,35 @@ void PageHandler_playI(p_obj pArgs_Page) {
   char *sLefterComponent = "lefter.fixed.aright-x.atop-y";
   char *sFooterComponent = "footer.fixed.aleft-x.atop-y";
   char *sFieldContainerComponent = "field-container.fixed";
-  char *sFieldComponent = "field.acenter-x.acenter-y";
+  char *sFieldComponent = "field.aleft-x.atop-y";
   char *sFieldCursorComponent = "field-cursor.aleft-x.atop-y";
   char *sGamePromptComponent = "game-prompt.fixed.aleft-x.atop-y";
   char *sGameInfoComponent = "game-info.fixed.aleft-x.abottom-y";
   char *sProfileInfoComponent = "profile-info.fixed.aleft-x.atop-y";
   char *sPopupComponent = "popup.fixed";
 
-  // For inspect components
-  char sInspectKey[STRING_KEY_MAX_LENGTH];
-  char sFlagKey[STRING_KEY_MAX_LENGTH];
-
   // Some of the component contents
   char sProfileInfoText[STRING_KEY_MAX_LENGTH];
   char sGamePromptText[STRING_KEY_MAX_LENGTH];
   char sGameInfoText[STRING_KEY_MAX_LENGTH];
 
-  // Buffer for minesweeper grid 
-  char *sGridBuffer;
-
   // Current highscore
   int dHighscore = 0;
 
   // Pressed key
   char cKeyPressed = 0;
+
+  // Whether an undo or redo changed the board
+  int bHasChanged = 0;
   
   // Do stuff based on page status
   switch(this->ePageStatus) {
 
     case PAGE_ACTIVE_INIT:
 
+      // The timer has to tick even when no keys are pressed
+      Page_setRefresh(this, PAGE_REFRESH_SECOND);
+
       // Get the dimensions 
       dWidth = IO_getWidth();
       dHeight = IO_getHeight();
@@ -82,52 +142,24 @@ void PageHandler_playI(p_obj pArgs_Page) {
       Page_addComponentContainer(this, sLefterComponent, sPlayIComponent, dWidth / 2 + Game_getCharWidth(pGame) / 2 + dMargin * 2, dHeight / 2 - Game_getCharHeight(pGame) / 2 - 1);
       Page_addComponentContainer(this, sFooterComponent, sPlayIComponent, dWidth / 2 - Game_getCharWidth(pGame) / 2, dHeight / 2 + Game_getCharHeight(pGame) / 2 + dMargin / 2);
       Page_addComponentContainer(this, sFieldContainerComponent, sPlayIComponent, dWidth / 2, dHeight / 2);
-      Page_addComponentText(this, sFieldComponent, sFieldContainerComponent, 0, 0, "primary-darken-0.75", "", "");
+      Page_addComponentTilemap(this, sFieldComponent, sFieldContainerComponent, 
+        -Game_getCharWidth(pGame) / 2, 
+        -Game_getCharHeight(pGame) / 2 - 1, 
+        "primary-darken-0.75", "", 
+        PageHandler_playITiles, this, 
+        GAME_CELL_WIDTH, GAME_CELL_HEIGHT, pGame->field.dWidth, pGame->field.dHeight);
       Page_addComponentAsset(this, sFieldCursorComponent, sFieldComponent, 0, 0, "accent", "", "field-cursor");
       Page_addComponentText(this, sGameInfoComponent, sHeaderComponent, 0, 0, "", "", "");
       Page_addComponentText(this, sProfileInfoComponent, sLefterComponent, 0, 0, "", "", "");
       Page_addComponentText(this, sGamePromptComponent, sFooterComponent, 0, 0, "", "", "");
       Page_addComponentPopup(this, sPopupComponent, dWidth / 2, dHeight / 2, 56, 14, "secondary", "accent", "", "", "");
 
-      // This is stupid but LMAO
-      for(x = 0; x < pGame->field.dWidth; x++) {
-        for(y = 0; y < pGame->field.dHeight; y++) {
-
-          // The key
-          sprintf(sFlagKey, "flag-%d-%d", x, y);
-
-          // Create the component
-          Page_addComponentText(this, 
-            sFlagKey, 
-            sFieldContainerComponent, 
-            
-            x * GAME_CELL_WIDTH - Game_getCharWidth(pGame) / 2 + 1, 
-            y * GAME_CELL_HEIGHT - Game_getCharHeight(pGame) / 2,  
-            
-            "accent2", "", "");
-
-          sprintf(sFlagKey, "flag-darken-%d-%d", x, y);
-
-          Page_addComponentText(this, 
-            sFlagKey, 
-            sFieldContainerComponent, 
-            
-            x * GAME_CELL_WIDTH - Game_getCharWidth(pGame) / 2 + 1, 
-            y * GAME_CELL_HEIGHT - Game_getCharHeight(pGame) / 2,  
-            
-            "accent2-darken-0.36", "", " ");
-        }
-      }
-
-      // Display the actual grid
-      sGridBuffer = String_alloc(Game_getCharWidth(pGame) * Game_getCharHeight(pGame) * 4);
-      Game_displayGrid(pGame, sGridBuffer);
-      Page_setComponentText(this, sFieldComponent, sGridBuffer);
-      String_kill(sGridBuffer);
-
     break;
 
     case PAGE_ACTIVE_RUNNING:
+
+      // The first inspect goes through once its no-guess board is ready
+      Game_resume(pGame);
       
       // Key handling
       cKeyPressed = EventStore_get(this->pSharedEventStore, "key-pressed");
@@ -226,16 +258,24 @@ void PageHandler_playI(p_obj pArgs_Page) {
 
             // Do the inspection algorithm
             Game_inspect(pGame, pGame->dCursorX, pGame->dCursorY);
-
-            // Display the actual grid
-            sGridBuffer = String_alloc(Game_getCharWidth(pGame) * Game_getCharHeight(pGame) * 4);
-            Game_displayGrid(pGame, sGridBuffer);
-            Page_setComponentText(this, sFieldComponent, sGridBuffer);
-            String_kill(sGridBuffer);
           break;
 
           default:
 
+            // Undo and redo work even after the game has ended
+            if(cKeyPressed == tolower(Settings_getGameUndo(this->pSharedEventStore)) ||
+              cKeyPressed == toupper(Settings_getGameUndo(this->pSharedEventStore)))
+              bHasChanged = Game_undo(pGame);
+
+            else if(cKeyPressed == tolower(Settings_getGameRedo(this->pSharedEventStore)) ||
+              cKeyPressed == toupper(Settings_getGameRedo(this->pSharedEventStore)))
+              bHasChanged = Game_redo(pGame);
+
+            // Take back whatever the end of the game did to the display
+            if(bHasChanged) {
+              Page_setComponentColor(this, sFieldComponent, "primary-darken-0.75", "");
+            }
+
             // The user won
             if(Game_isWon(pGame)) {
 
@@ -249,41 +289,22 @@ void PageHandler_playI(p_obj pArgs_Page) {
 
               // Change the display
               Page_setComponentColor(this, sFieldComponent, "accent", "");
-              sprintf(sProfileInfoText, "%s\n%s, %s\n%s (best)\n\n%s (current)",
+              sprintf(sProfileInfoText, "%s\n%s, %s\n%s (best)\n\n%s (%s)",
                 Profile_getCurrent(pProfile),
                 pGame->eType == GAME_TYPE_CLASSIC ? "CLASSIC" : "CUSTOM",
                 pGame->eType == GAME_TYPE_CLASSIC ? (pGame->eDifficulty == GAME_DIFFICULTY_EASY ? "EASY" : "DIFFICULT") : pGame->sSaveName,
                 dHighscore < 0 ? "none" : String_formatSecs(dHighscore),
                   
-                Game_getTime(pGame));                    
+                Game_getTime(pGame), Game_isRecorded(pGame) ? "current" : "not recorded");
               Page_setComponentText(this, sProfileInfoComponent, sProfileInfoText);
-              Page_setComponentText(this, sGamePromptComponent, "[enter]  to proceed");
-              Page_setComponentText(this, sGameInfoComponent, "Congratulations! You won.\n\n");
-              
-              // Turn the grid yellow and fill with flags
-              for(x = 0; x < pGame->field.dWidth; x++) {
-                for(y = 0; y < pGame->field.dHeight; y++) {
-
-                  // Check if it's been inspected
-                  if(Grid_getBit(pGame->field.pInspectGrid, x, y)) {
+              sprintf(sGamePromptText, "[enter]  to proceed\n[%s]      to undo",
+                String_renderEscChar(Settings_getGameUndo(this->pSharedEventStore)));
+              Page_setComponentText(this, sGamePromptComponent, sGamePromptText);
 
-                    // Unique key for each component
-                    sprintf(sInspectKey, "inspector-%d-%d", x, y);
-                    Page_setComponentColor(this, sInspectKey, "accent", "");
-                  }
-                  
-                  // The key
-                  sprintf(sFlagKey, "flag-%d-%d", x, y);
-                  
-                  // If there's a flag on it
-                  if(Grid_getBit(pGame->field.pFlagGrid, x, y))
-                    Page_setComponentText(this, sFlagKey, "▐▀ ");
-                  
-                  // Remove flag if it exists
-                  else
-                    Page_setComponentText(this, sFlagKey, "");
-                }
-              }
+              // Only the first ending of a game goes into the stats
+              Page_setComponentText(this, sGameInfoComponent, Game_isRecorded(pGame) ? 
+                "Congratulations! You won.\n\n" : 
+                "Congratulations! You won.\nOnly the first ending of a game is recorded.\n");
 
               return;
             }
@@ -297,28 +318,12 @@ void PageHandler_playI(p_obj pArgs_Page) {
               
               // Update display
               Page_setComponentText(this, sProfileInfoComponent, "");
-              Page_setComponentText(this, sGamePromptComponent, "[enter]  to proceed");
-              Page_setComponentText(this, sGameInfoComponent, "Darn, you stepped on a mine!\n\n");
-
-              // Turn the grid red and indicate mines
-              for(x = 0; x < pGame->field.dWidth; x++) {
-                for(y = 0; y < pGame->field.dHeight; y++) {
-
-                  // The key
-                  sprintf(sFlagKey, "flag-%d-%d", x, y);
-                  
-                  // If there's a mine on it
-                  if(Grid_getBit(pGame->field.pMineGrid, x, y)) {
-                    Page_setComponentText(this, sFlagKey, "(#)");
-                  
-                  // False flags
-                  } else if(Grid_getBit(pGame->field.pFlagGrid, x, y)) {
-                    Page_setComponentColor(this, sFlagKey, "accent", "");
-                    sprintf(sFlagKey, "flag-darken-%d-%d", x, y);
-                    Page_setComponentColor(this, sFlagKey, "accent-darken-0.25", "");
-                  }
-                }
-              }
+              sprintf(sGamePromptText, "[enter]  to proceed\n[%s]      to undo",
+                String_renderEscChar(Settings_getGameUndo(this->pSharedEventStore)));
+              Page_setComponentText(this, sGamePromptComponent, sGamePromptText);
+              Page_setComponentText(this, sGameInfoComponent, Game_isRecorded(pGame) ? 
+                "Darn, you stepped on a mine!\n\n" : 
+                "Darn, you stepped on a mine!\nOnly the first ending of a game is recorded.\n");
 
               return;
             }
@@ -351,59 +356,6 @@ void PageHandler_playI(p_obj pArgs_Page) {
               // If already has a flag
               else Game_removeFlag(pGame);
             }
-            
-            // For each cell, check if it's been inspected, and if so, change color
-            for(x = 0; x < pGame->field.dWidth; x++) {
-              for(y = 0; y < pGame->field.dHeight; y++) {
-
-                // Check if it's been inspected
-                if(Grid_getBit(pGame->field.pInspectGrid, x, y)) {
-
-                  // Unique key for each component
-                  sprintf(sInspectKey, "inspector-%d-%d", x, y);
-
-                  // A lighter component for numbers > 0
-                  if(pGame->field.aNumbers[y][x] > 0) {
-                    Page_addComponentContext(this, 
-                      sInspectKey, 
-                      sFieldContainerComponent, 
-                      
-                      x * GAME_CELL_WIDTH - Game_getCharWidth(pGame) / 2, 
-                      y * GAME_CELL_HEIGHT - Game_getCharHeight(pGame) / 2 - 1, 
-                      
-                      GAME_CELL_WIDTH + 1, 
-                      GAME_CELL_HEIGHT + 1, 
-                      
-                      "primary-darken-0.25", "");
-                  
-                  // A darker component
-                  } else {
-                    Page_addComponentContext(this, 
-                      sInspectKey, 
-                      sFieldContainerComponent, 
-                      
-                      x * GAME_CELL_WIDTH - Game_getCharWidth(pGame) / 2, 
-                      y * GAME_CELL_HEIGHT - Game_getCharHeight(pGame) / 2 - 1, 
-                      
-                      GAME_CELL_WIDTH + 1, 
-                      GAME_CELL_HEIGHT + 1, 
-                      
-                      "primary-darken-0.5", "");
-                  }
-                }
-                
-                // The key
-                sprintf(sFlagKey, "flag-%d-%d", x, y);
-                
-                // If there's a flag on it
-                if(Grid_getBit(pGame->field.pFlagGrid, x, y))
-                  Page_setComponentText(this, sFlagKey, "▐▀ ");
-                
-                // Remove flag if it exists
-                else
-                  Page_setComponentText(this, sFlagKey, "");
-              }
-            }
 
           break;
         }
@@ -414,10 +366,12 @@ void PageHandler_playI(p_obj pArgs_Page) {
           pGame->dCursorY * GAME_CELL_HEIGHT);
 
         // Game information text
-        sprintf(sGameInfoText, "frame rate:      %s\ntime elapsed:    %s\nmines left:      %s\n",
+        sprintf(sGameInfoText, "board:           %s\nframe rate:      %s\ntime elapsed:    %s\nmines left:      %s\nmine chance:     %s\n",
+          Game_getMode(pGame),
           Game_getFPS(pGame),
           Game_getTime(pGame),
-          Game_getMinesLeft(pGame));
+          Game_getMinesLeft(pGame),
+          Game_getChance(pGame));
         Page_setComponentText(this, sGameInfoComponent, sGameInfoText);
 
         // Hold the highscore of the user for now
@@ -433,12 +387,14 @@ void PageHandler_playI(p_obj pArgs_Page) {
         Page_setComponentText(this, sProfileInfoComponent, sProfileInfoText);
 
         // Prompt text
-        sprintf(sGamePromptText, "[%s%s%s%s]   to move\n[enter]  to inspect a tile\n[%s]      to toggle a flag\n[esc]    to pause or exit",
+        sprintf(sGamePromptText, "[%s%s%s%s]   to move\n[enter]  to inspect a tile\n[%s]      to toggle a flag\n[%s] [%s]  to undo or redo\n[esc]    to pause or exit",
           String_renderEscChar(Settings_getGameMoveUp(this->pSharedEventStore)),
           String_renderEscChar(Settings_getGameMoveLeft(this->pSharedEventStore)),
           String_renderEscChar(Settings_getGameMoveDown(this->pSharedEventStore)),
           String_renderEscChar(Settings_getGameMoveRight(this->pSharedEventStore)),
-          String_renderEscChar(Settings_getGameToggleFlag(this->pSharedEventStore)));
+          String_renderEscChar(Settings_getGameToggleFlag(this->pSharedEventStore)),
+          String_renderEscChar(Settings_getGameUndo(this->pSharedEventStore)),
+          String_renderEscChar(Settings_getGameRedo(this->pSharedEventStore)));
         Page_setComponentText(this, sGamePromptComponent, sGamePromptText);
       }
 
@@ -45,14 +45,17 @@ void PageHandler_play(p_obj pArgs_Page) {
   char *sTypePromptComponent = "type-prompt.aleft-x";
   char *sFileordiffComponent = "fileordiff.aleft-x";
   char *sTypeComponent = "type.aleft-x";
+  char *sNoGuessPromptComponent = "noguess-prompt.aleft-x";
+  char *sNoGuessComponent = "noguess.aleft-x";
   char *sFieldPromptComponent = "field-prompt.aright-x.abottom-y";
   char *sErrorPromptComponent = "error-prompt.aleft-x";
 
   // Input fields
   char *sTypeField;
   char *sFileordiffField;
+  char *sNoGuessField;
   char cPlayCurrentField = 0;
-  char cPlayFieldCount = 2;
+  char cPlayFieldCount = 3;
 
   // Divider text
   char *sDividerText;
@@ -84,7 +87,9 @@ void PageHandler_play(p_obj pArgs_Page) {
       Page_addComponentText(this, sTypeComponent, sFieldContainerComponent, 1, 0, "", "", "");
       Page_addComponentText(this, sFileordiffPromptComponent, sFieldContainerComponent, 1, 1, "", "", "Enter difficulty or filename:");
       Page_addComponentText(this, sFileordiffComponent, sFieldContainerComponent, 1, 0, "", "", "");
-      Page_addComponentText(this, sErrorPromptComponent, sFieldContainerComponent, 1, 3, "primary-darken-0.75", "secondary", "type CLASSIC or CUSTOM under game type           \n\ntype EASY or DIFFICULT under difficulty (CLASSIC)\ntype FILENAME          under filename   (CUSTOM)");
+      Page_addComponentText(this, sNoGuessPromptComponent, sFieldContainerComponent, 1, 1, "", "", "No-guess board (optional):");
+      Page_addComponentText(this, sNoGuessComponent, sFieldContainerComponent, 1, 0, "", "", "");
+      Page_addComponentText(this, sErrorPromptComponent, sFieldContainerComponent, 1, 3, "primary-darken-0.75", "secondary", "type CLASSIC or CUSTOM  under game type\n\ntype EASY or DIFFICULT under difficulty (CLASSIC)\ntype FILENAME          under filename   (CUSTOM)\ntype YES or NO         under no-guess   (CLASSIC)");
       Page_addComponentText(this, sFieldPromptComponent, sPlayComponent, dWidth - dMargin - 1, dHeight - dMargin / 2, "primary-darken-0.5", "", "[tab]    to switch between fields\n[enter]  to submit\n[esc]   to go back");
       
       // Garbage collection
@@ -105,6 +110,7 @@ void PageHandler_play(p_obj pArgs_Page) {
       // Retrieve the user input 
       sTypeField = String_toUpper(EventStore_getString(this->pSharedEventStore, "type-input"));
       sFileordiffField = String_toUpper(EventStore_getString(this->pSharedEventStore, "fileordiff-input"));
+      sNoGuessField = String_toUpper(EventStore_getString(this->pSharedEventStore, "noguess-input"));
 
       // Switch based on what key was last pressed
       switch(EventStore_get(this->pSharedEventStore, "key-pressed")) {
@@ -134,6 +140,11 @@ void PageHandler_play(p_obj pArgs_Page) {
             Page_setComponentText(this, sErrorPromptComponent, "Error: invalid game type; check whitespaces.");
             Page_setComponentColor(this, sErrorPromptComponent, "secondary", "accent");
 
+          // The no-guess option is left empty to turn it off
+          } else if(strlen(sNoGuessField) && strcmp(sNoGuessField, "YES") && strcmp(sNoGuessField, "NO")) {
+            Page_setComponentText(this, sErrorPromptComponent, "Error: no-guess is either YES or NO.");
+            Page_setComponentColor(this, sErrorPromptComponent, "secondary", "accent");
+
           // If classic mode
           } else if(!strcmp(sTypeField, "CLASSIC")) {
             
@@ -147,6 +158,7 @@ void PageHandler_play(p_obj pArgs_Page) {
             } else {
               if(!strcmp(sFileordiffField, "EASY")) Game_setup(pGame, GAME_TYPE_CLASSIC, GAME_DIFFICULTY_EASY);
               if(!strcmp(sFileordiffField, "DIFFICULT")) Game_setup(pGame, GAME_TYPE_CLASSIC, GAME_DIFFICULTY_DIFFICULT);
+              Game_setNoGuess(pGame, !strcmp(sNoGuessField, "YES"));
               Game_init(pGame);
 
               Page_idle(this);
@@ -156,8 +168,13 @@ void PageHandler_play(p_obj pArgs_Page) {
           // If custom mode
           } else if(!strcmp(sTypeField, "CUSTOM")) {
             
+            // Custom levels come with their own mines
+            if(!strcmp(sNoGuessField, "YES")) {
+              Page_setComponentText(this, sErrorPromptComponent, "Error: CUSTOM levels can't be no-guess.");
+              Page_setComponentColor(this, sErrorPromptComponent, "secondary", "accent");
+
             // Check for valid filename
-            if(!String_isValidFilename(sFileordiffField)) {
+            } else if(!String_isValidFilename(sFileordiffField)) {
               Page_setComponentText(this, sErrorPromptComponent, "Error: invalid filename for custom game.");   
               Page_setComponentColor(this, sErrorPromptComponent, "secondary", "accent");           
             
@@ -188,6 +205,8 @@ void PageHandler_play(p_obj pArgs_Page) {
             Page_setComponentColor(this, sTypeComponent, "accent", "");
             Page_setComponentColor(this, sFileordiffPromptComponent, "primary-darken-0.75", "");
             Page_setComponentColor(this, sFileordiffComponent, "primary-darken-0.75", "");
+            Page_setComponentColor(this, sNoGuessPromptComponent, "primary-darken-0.75", "");
+            Page_setComponentColor(this, sNoGuessComponent, "primary-darken-0.75", "");
 
           // Update the values of the current inputted password
           } else if(cPlayCurrentField == 1) {
@@ -197,11 +216,24 @@ void PageHandler_play(p_obj pArgs_Page) {
             Page_setComponentColor(this, sTypeComponent, "primary-darken-0.75", "");
             Page_setComponentColor(this, sFileordiffPromptComponent, "primary", "");
             Page_setComponentColor(this, sFileordiffComponent, "accent", "");
+            Page_setComponentColor(this, sNoGuessPromptComponent, "primary-darken-0.75", "");
+            Page_setComponentColor(this, sNoGuessComponent, "primary-darken-0.75", "");
+
+          // Update whether the board should be no-guess
+          } else if(cPlayCurrentField == 2) {
+            EventStore_setString(this->pSharedEventStore, "key-pressed", "noguess-input");
+
+            Page_setComponentColor(this, sTypePromptComponent, "primary-darken-0.75", "");
+            Page_setComponentColor(this, sTypeComponent, "primary-darken-0.75", "");
+            Page_setComponentColor(this, sFileordiffPromptComponent, "primary-darken-0.75", "");
+            Page_setComponentColor(this, sFileordiffComponent, "primary-darken-0.75", "");
+            Page_setComponentColor(this, sNoGuessPromptComponent, "primary", "");
+            Page_setComponentColor(this, sNoGuessComponent, "accent", "");
           }
 
           // Clear the error
           if(EventStore_get(this->pSharedEventStore, "key-pressed")) {
-            Page_setComponentText(this, sErrorPromptComponent, "type CLASSIC or CUSTOM under game type           \n\ntype EASY or DIFFICULT under difficulty (CLASSIC)\ntype FILENAME          under filename   (CUSTOM)");
+            Page_setComponentText(this, sErrorPromptComponent, "type CLASSIC or CUSTOM  under game type\n\ntype EASY or DIFFICULT under difficulty (CLASSIC)\ntype FILENAME          under filename   (CUSTOM)\ntype YES or NO         under no-guess   (CLASSIC)");
             Page_setComponentColor(this, sErrorPromptComponent, "primary-darken-0.75", "secondary");
           }
 
@@ -211,6 +243,7 @@ void PageHandler_play(p_obj pArgs_Page) {
       // Indicate the user input on screen
       Page_setComponentText(this, sTypeComponent, strlen(sTypeField) ? sTypeField : "____________________");
       Page_setComponentText(this, sFileordiffComponent, strlen(sFileordiffField) ? sFileordiffField : "____________________");
+      Page_setComponentText(this, sNoGuessComponent, strlen(sNoGuessField) ? sNoGuessField : "____________________");
 
     break;
 
@@ -13,6 +13,42 @@
 #include "./utils/utils.event.h"
 #include "./utils/utils.theme.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Works out how many colors the terminal can show.
+ * MINESWEEPER_COLORS can be set to "truecolor", "256" or "16" to pick one. Otherwise the colors are 
+ *    sent as they are, unless the terminal clearly can't show them (like the Linux console).
+ * 
+ * @return  { GraphicsMode }  How the colors should be sent.
+*/
+GraphicsMode Settings_getColorMode() {
+  char *sColors = getenv("MINESWEEPER_COLORS");
+  char *sColorTerm = getenv("COLORTERM");
+  char *sTerm = getenv("TERM");
+  size_t dTermLength = sTerm == NULL ? 0 : strlen(sTerm);
+
+  if(sColors != NULL && (!strcmp(sColors, "truecolor") || !strcmp(sColors, "24bit")))
+    return GRAPHICS_MODE_TRUECOLOR;
+
+  if(sColors != NULL && !strcmp(sColors, "256"))
+    return GRAPHICS_MODE_256;
+
+  if(sColors != NULL && !strcmp(sColors, "16"))
+    return GRAPHICS_MODE_16;
+
+  if(sColorTerm != NULL && (!strcmp(sColorTerm, "truecolor") || !strcmp(sColorTerm, "24bit")))
+    return GRAPHICS_MODE_TRUECOLOR;
+
+  // Only the terminals that say they have 16 colors get fewer
+  if(sTerm != NULL && (!strcmp(sTerm, "linux") || 
+    (dTermLength >= 7 && !strcmp(sTerm + dTermLength - 7, "16color"))))
+    return GRAPHICS_MODE_16;
+
+  return GRAPHICS_MODE_TRUECOLOR;
+}
+
 /**
  * Sets certain keybinds in the event store.
  * Sets the current theme in the theme manager.
@@ -30,8 +66,11 @@ void Settings_init(EventStore *pSharedEventStore, ThemeManager *pSharedThemeMana
 
   // Other game keybinds
   EventStore_set(pSharedEventStore, "game-toggle-flag", 'f');
+  EventStore_set(pSharedEventStore, "game-undo", 'u');
+  EventStore_set(pSharedEventStore, "game-redo", 'r');
 
   // Default theming
+  ThemeManager_setColorMode(pSharedThemeManager, Settings_getColorMode());
   ThemeManager_setActive(pSharedThemeManager, "default");
 }
 
@@ -49,8 +88,10 @@ void Settings_getKeybinds(int *dKeybindCount, char *sKeybindArray[]) {
   sKeybindArray[2] = "game-move-left";
   sKeybindArray[3] = "game-move-right";
   sKeybindArray[4] = "game-toggle-flag";
+  sKeybindArray[5] = "game-undo";
+  sKeybindArray[6] = "game-redo";
 
-  *dKeybindCount = 5;
+  *dKeybindCount = 7;
 }
 
 /**
@@ -103,5 +144,25 @@ char Settings_getGameToggleFlag(EventStore *pSharedEventStore) {
   return EventStore_get(pSharedEventStore, "game-toggle-flag");
 }
 
+/**
+ * Returns the key bound to the undo functionality.
+ * 
+ * @param   { EventStore * }  pSharedEventStore   The event store to access the data from.
+ * @param   { char }                              The key bound to undo.
+*/
+char Settings_getGameUndo(EventStore *pSharedEventStore) {
+  return EventStore_get(pSharedEventStore, "game-undo");
+}
+
+/**
+ * Returns the key bound to the redo functionality.
+ * 
+ * @param   { EventStore * }  pSharedEventStore   The event store to access the data from.
+ * @param   { char }                              The key bound to redo.
+*/
+char Settings_getGameRedo(EventStore *pSharedEventStore) {
+  return EventStore_get(pSharedEventStore, "game-redo");
+}
+
 #endif
 
@@ -13,6 +13,7 @@
 #include <sys/ioctl.h>
 #include <termios.h>
 #include <unistd.h>
+#include <time.h>
 
 typedef struct IO IO;
 
@@ -136,6 +137,20 @@ void IO_flushBuffer() {
   fflush(stdout);
 }
 
+/**
+ * Returns how far into the current second of the clock we are.
+ * The seconds themselves line up with time(), so this tells us when time() will tick next.
+ * 
+ * @return  {int}   The milliseconds past the current second.
+*/
+int IO_getMillis() {
+  struct timespec now;
+
+  clock_gettime(CLOCK_REALTIME, &now);
+
+  return now.tv_nsec / 1000000;
+}
+
 /**
  * Helper function that gets a single character without return key.
  * 
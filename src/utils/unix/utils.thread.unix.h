@@ -31,6 +31,7 @@
 #define WAIT_TIMEOUT 0x00000102                         // This is defined in Windows but we just redefined it here for convenience
 
 typedef struct Mutex Mutex;
+typedef struct Signal Signal;
 typedef struct Thread Thread;
 
 /**
@@ -150,6 +151,129 @@ void Mutex_unlock(Mutex *this) {
   pthread_mutex_unlock(this->hMutex);
 }
 
+/**
+ * //
+ * ////
+ * //////    Signal class
+ * ////////
+ * ////////// 
+*/
+
+/**
+ * A class that lets a thread sleep until another thread wakes it up.
+ * Raising the signal while no one is waiting isn't lost; the next wait returns right away.
+ * 
+ * @class
+*/
+struct Signal {
+
+  char sName[STRING_KEY_MAX_LENGTH];  // The name of the signal
+  pthread_mutex_t *hMutex;            // Guards the flag below
+  pthread_cond_t *hCondition;         // What the waiting thread sleeps on
+  int bIsRaised;                      // Whether or not the signal was raised since the last wait
+
+};
+
+/**
+ * Allocates memory for a new instance of the signal class.
+ * 
+ * @return  { Signal * }  A pointer to the location of the allocated space.
+*/
+Signal *Signal_new() {
+  Signal *pSignal = calloc(1, sizeof(*pSignal));
+  return pSignal;
+}
+
+/**
+ * Initializes the instance of the signal class we pass to the function.
+ * 
+ * @param   { Signal * }  this    The instance to initialize.
+ * @param   { char * }    sName   An identifier for the signal.
+ * @return  { Signal * }          The initialized instance.
+*/
+Signal *Signal_init(Signal *this, char *sName) {
+  strcpy(this->sName, sName);
+  this->hMutex = calloc(1, sizeof(*(this->hMutex)));
+  this->hCondition = calloc(1, sizeof(*(this->hCondition)));
+  this->bIsRaised = 0;
+
+  pthread_mutex_init(this->hMutex, NULL);
+  pthread_cond_init(this->hCondition, NULL);
+
+  return this;
+}
+
+/**
+ * Creates an initialized signal instance.
+ * 
+ * @param   { char * }  sName   The identifier for the instance.
+*/
+Signal *Signal_create(char *sName) {
+  return Signal_init(Signal_new(), sName);
+}
+
+/**
+ * Frees the memory of an instance of the signal class.
+ * 
+ * @param   { Signal * }  this  The instance to destroy.
+*/
+void Signal_kill(Signal *this) {
+  pthread_cond_destroy(this->hCondition);
+  pthread_mutex_destroy(this->hMutex);
+
+  free(this->hCondition);
+  free(this->hMutex);
+  free(this);
+}
+
+/**
+ * Raises a signal, waking up the thread waiting on it.
+ * 
+ * @param   { Signal * }  this  The signal to raise.
+*/
+void Signal_raise(Signal *this) {
+  pthread_mutex_lock(this->hMutex);
+  this->bIsRaised = 1;
+  pthread_cond_signal(this->hCondition);
+  pthread_mutex_unlock(this->hMutex);
+}
+
+/**
+ * Waits for a signal to be raised, but only until the specified amount of time.
+ * 
+ * @param   { Signal * }  this      The signal to wait for.
+ * @param   { long }      dMillis   How long to wait for, at most.
+ * @return  { int }                 WAIT_TIMEOUT if the time ran out first, 0 if the signal was raised.
+*/
+int Signal_wait(Signal *this, long dMillis) {
+  struct timespec timeout;
+  int dResult = 0;
+
+  clock_gettime(CLOCK_REALTIME, &timeout);
+
+  // The wait can be longer than a second, unlike a frame
+  timeout.tv_sec += dMillis / 1000;
+  timeout.tv_nsec += (dMillis % 1000) * 1000000L;
+
+  if(timeout.tv_nsec >= 1000000000L) {
+    timeout.tv_nsec -= 1000000000L;
+    timeout.tv_sec++;
+  }
+
+  pthread_mutex_lock(this->hMutex);
+
+  // The condition can wake up on its own, so we check the flag each time
+  while(!this->bIsRaised && dResult != ETIMEDOUT)
+    dResult = pthread_cond_timedwait(this->hCondition, this->hMutex, &timeout);
+
+  dResult = this->bIsRaised ? 0 : WAIT_TIMEOUT;
+  this->bIsRaised = 0;
+
+  pthread_mutex_unlock(this->hMutex);
+
+  return dResult;
+}
+
 /**
  * //
  * ////
@@ -172,6 +296,8 @@ struct Thread {
   Mutex *pStateMutex;                 // A pointer to the mutex that tells the thread to keep running
   Mutex *pDataMutex;                  // A pointer to the mutex that tells the thread if it can 
                                       //    modify the shared resource
+  Signal *pWakeSignal;                // Wakes the thread up before its sleep is over; this may be NULL
+  long dSleep;                        // How long the thread sleeps between runs (in ms)
         
   f_void_callback fCallee;            // A pointer to the routine to be run by the thread
   p_obj pArgs_ANY;                    // The arguments to the callee
@@ -190,6 +316,8 @@ Thread *Thread_create(char *sName, Mutex *pStateMutex, Mutex *pDataMutex, f_void
 
 void Thread_kill(Thread *this);
 
+int Thread_wait(Thread *this);
+
 /**
  * Helper function for callbacks
  * 
@@ -235,6 +363,10 @@ Thread *Thread_init(Thread *this, char *sName, Mutex *pStateMutex, Mutex *pDataM
   this->pStateMutex = pStateMutex;
   this->pDataMutex = pDataMutex;
 
+  // A thread runs once every cycle unless told otherwise
+  this->pWakeSignal = NULL;
+  this->dSleep = THREAD_TIMEOUT;
+
   // Store the callback and its argument object
   this->fCallee = fCallee;
   this->pArgs_ANY = pArgs_ANY;
@@ -309,7 +441,7 @@ void *ThreadHandler(void *pThread) {
     Mutex_unlock(this->pDataMutex);
 
   // While the state mutex hasn't been released, keep running the thread
-  } while(Mutex_lockTimed(this->pStateMutex, THREAD_TIMEOUT) == WAIT_TIMEOUT);
+  } while(Thread_wait(this) == WAIT_TIMEOUT);
 
   // Perform cleanup
   Thread_kill(this);
@@ -317,4 +449,21 @@ void *ThreadHandler(void *pThread) {
   return NULL;
 }
 
+/**
+ * Sleeps until the thread should run again.
+ * Threads without a wake signal wait on their state mutex, so they stop as soon as they're told to.
+ * The others wait on their signal first, then check whether they should still be running.
+ * 
+ * @param   { Thread * }  this  The thread to put to sleep.
+ * @return  { int }             WAIT_TIMEOUT if the thread should keep running.
+*/
+int Thread_wait(Thread *this) {
+  if(this->pWakeSignal == NULL)
+    return Mutex_lockTimed(this->pStateMutex, this->dSleep);
+
+  Signal_wait(this->pWakeSignal, this->dSleep);
+
+  return Mutex_lockTimed(this->pStateMutex, 0);
+}
+
 #endif
\ No newline at end of file
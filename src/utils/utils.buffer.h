@@ -14,12 +14,16 @@
 #include "./utils.string.h"
 #include "./utils.graphics.h"
 
+#include <limits.h>
 #include <string.h>
 #include <stdio.h>
 
 #define BUFFER_MAX_WIDTH (1 << 8)
 #define BUFFER_MAX_HEIGHT (1 << 6)
-#define BUFFER_MAX_CONTEXTS (1 << 10)
+#define BUFFER_MAX_CONTEXTS ((1 << 8) - 1)                            // Contexts are shared by their colors, so this counts distinct color pairs; 0 is left for the defaults
+#define BUFFER_CONTEXT_SLOTS (1 << 9)                                 // The size of the table we look contexts up in; this has to be a power of 2
+#define BUFFER_DIFF_GAP 8                                             // Unchanged cells shorter than a cursor jump get reprinted instead
+#define BUFFER_CELL_BYTES 64                                          // The most a single cell can add to the output (a jump, two colors and the char)
 
 typedef struct Buffer Buffer;
 
@@ -47,12 +51,24 @@ struct Buffer {
                                                                       //    some of the characters we will be using might need more than 8 bytes to be
                                                                       //    represented (in other words, more than one char unit).
 
-  int dContextCount;                                                  // How many contexts we currently have
-  char *sDefaultContext;                                              // The default ANSI escape sequence for the FG and BG color of the buffer
-  char *sContextArray[BUFFER_MAX_CONTEXTS];                           // Stores the different contexts we will be using  
-  unsigned short dContextMask[BUFFER_MAX_HEIGHT][BUFFER_MAX_WIDTH];   // Stores the contexts that define the styling of the entire buffer
+  int dContextCount;                                                  // How many contexts we currently have (each one has different colors)
+  unsigned char dContextSlots[BUFFER_CONTEXT_SLOTS];                  // Finds the context with a given pair of colors; the slots hold the index + 1
+  GraphicsCode defaultCode;                                           // The default ANSI escape sequence for the FG and BG color of the buffer
+  GraphicsCache *pCodeCache;                                          // Where the sequences of the contexts are kept; this may be NULL
+  int dContextCodes[BUFFER_MAX_CONTEXTS];                             // The id of the sequence of each context in the cache
+  unsigned char dContextMask[BUFFER_MAX_HEIGHT][BUFFER_MAX_WIDTH];    // Stores the contexts that define the styling of the entire buffer
                                                                       // Note that this is unsigned so we don't waste space; we need the extra memory LMOO
                                                                       // Because of this, 0 has to mean smth like NULL and 1 -> 0, 2 -> 1, etc.
+
+  color colorContextFG[BUFFER_MAX_CONTEXTS];                          // The colors behind each context, or -1 if the context leaves that color alone
+  color colorContextBG[BUFFER_MAX_CONTEXTS];
+  color colorStyleFG[BUFFER_MAX_HEIGHT][BUFFER_MAX_WIDTH];            // The colors each cell actually ends up with on the screen
+  color colorStyleBG[BUFFER_MAX_HEIGHT][BUFFER_MAX_WIDTH];            //    (these are only worked out when the buffer is printed)
+
+  color colorPenFG;                                                   // When the buffer stands for the screen, the colors the terminal is currently printing with
+  color colorPenBG;                                                   //    (-1 means we don't know, so the next cell has to set them)
+  char *sBlob;                                                        // The output of the last frame; we keep it around so we don't reallocate it every frame
+  int dBlobCapacity;
 };
 
 /**
@@ -85,10 +101,18 @@ Buffer *Buffer_init(Buffer *this, int dWidth, int dHeight, int dDefaultFG, int d
   // Set the default config of the styling
   this->dDefaultFG = dDefaultFG;
   this->dDefaultBG = dDefaultBG;
-  this->sDefaultContext = Graphics_getCodeFGBG(dDefaultFG, dDefaultBG);
+  this->defaultCode.dLength = Graphics_writeCode(this->defaultCode.sCode, dDefaultFG, dDefaultBG);
 
-  // No contexts at the moment
+  // No contexts at the moment, and nowhere to keep their sequences yet
+  this->pCodeCache = NULL;
   this->dContextCount = 0;
+  memset(this->dContextSlots, 0, sizeof(this->dContextSlots));
+
+  // We don't know what the terminal is doing yet
+  this->colorPenFG = -1;
+  this->colorPenBG = -1;
+  this->sBlob = NULL;
+  this->dBlobCapacity = 0;
 
   // Initialize everything to a space character
   // Also, initialize the context mask values to 0
@@ -128,10 +152,241 @@ Buffer *Buffer_create(int dWidth, int dHeight, int dDefaultFG, int dDefaultBG) {
  * @param   { Buffer * }  this  The instance to be freed from memory.
 */
 void Buffer_kill(Buffer *this) {
-  free(this->sDefaultContext);
+  free(this->sBlob);
   free(this);
 }
 
+/**
+ * Returns how far apart two colors of a context are.
+ * A color that's left alone is as far as it gets from any actual color.
+ * 
+ * @param   { color }   color1  The first color; this may be -1.
+ * @param   { color }   color2  The second color; this may be -1.
+ * @return  { int }             The squared distance between their RGB values.
+*/
+int Buffer_getContextDist(color color1, color color2) {
+  int r = ((color1 >> 16) & 0xff) - ((color2 >> 16) & 0xff);
+  int g = ((color1 >> 8) & 0xff) - ((color2 >> 8) & 0xff);
+  int b = ((color1 >> 0) & 0xff) - ((color2 >> 0) & 0xff);
+
+  if(color1 < 0 || color2 < 0)
+    return color1 == color2 ? 0 : 3 << 16;
+
+  return r * r + g * g + b * b;
+}
+
+/**
+ * Returns the context with the given colors, adding it if the buffer doesn't have one yet.
+ * A negative color means the context doesn't touch that part of the style.
+ * Once every context is taken, the closest one we have stands in for the new colors.
+ * 
+ * @param   { Buffer * }  this      The buffer to modify.
+ * @param   { color }     colorFG   The color of the foreground within the context.
+ * @param   { color }     colorBG   The color of the background within the context.
+ * @return  { int }                 The value the context goes by in the mask (its index + 1).
+*/
+int Buffer_addContext(Buffer *this, color colorFG, color colorBG) {
+  int i, dDist, dBest = 0, dBestDist = INT_MAX;
+  unsigned int dSlot;
+
+  colorFG = colorFG < 0 ? -1 : colorFG;
+  colorBG = colorBG < 0 ? -1 : colorBG;
+
+  // Colors that look the same on the screen can share a context
+  if(this->pCodeCache != NULL) {
+    colorFG = GraphicsCache_quantize(this->pCodeCache, colorFG);
+    colorBG = GraphicsCache_quantize(this->pCodeCache, colorBG);
+  }
+
+  // Look for a context with the same colors
+  dSlot = ((unsigned int) colorFG * 0x9e3779b1u ^ (unsigned int) colorBG * 0x85ebca77u) >> 7;
+
+  for(dSlot &= BUFFER_CONTEXT_SLOTS - 1; this->dContextSlots[dSlot]; dSlot = (dSlot + 1) & (BUFFER_CONTEXT_SLOTS - 1)) {
+    i = this->dContextSlots[dSlot] - 1;
+
+    if(this->colorContextFG[i] == colorFG && this->colorContextBG[i] == colorBG)
+      return i + 1;
+  }
+
+  // Make a new one if there's still room
+  if(this->dContextCount < BUFFER_MAX_CONTEXTS) {
+    this->dContextCodes[this->dContextCount] = this->pCodeCache != NULL ? 
+      GraphicsCache_get(this->pCodeCache, colorFG, colorBG) : 
+      GRAPHICS_NO_CODE;
+
+    this->colorContextFG[this->dContextCount] = colorFG;
+    this->colorContextBG[this->dContextCount] = colorBG;
+    this->dContextSlots[dSlot] = ++this->dContextCount;
+
+    return this->dContextCount;
+  }
+
+  // Otherwise, settle for the closest one
+  for(i = 0; i < this->dContextCount; i++) {
+    dDist = 
+      Buffer_getContextDist(colorFG, this->colorContextFG[i]) + 
+      Buffer_getContextDist(colorBG, this->colorContextBG[i]);
+
+    if(dDist < dBestDist) {
+      dBestDist = dDist;
+      dBest = i;
+    }
+  }
+
+  return dBest + 1;
+}
+
+/**
+ * Writes the sequence that sets the given colors from scratch.
+ * The cache decides how the colors are sent; buffers without one send them as they are.
+ * 
+ * @param   { Buffer * }  this      The buffer whose cache we use.
+ * @param   { char * }    sOut      Where to write the sequence.
+ * @param   { color }     colorFG   The color of the foreground; this may be negative.
+ * @param   { color }     colorBG   The color of the background; this may be negative.
+ * @return  { int }                 How many chars were written.
+*/
+int Buffer_writeColors(Buffer *this, char *sOut, color colorFG, color colorBG) {
+  if(this->pCodeCache == NULL)
+    return Graphics_writeCode(sOut, colorFG, colorBG);
+
+  return GraphicsCache_writeCode(this->pCodeCache, sOut, colorFG, colorBG);
+}
+
+/**
+ * Clears the buffer so it can hold a new frame, without reallocating it.
+ * Only the part of the arrays the new size covers is touched; everything past it is never read.
+ * 
+ * @param   { Buffer * }  this        The buffer to reset.
+ * @param   { int }       dWidth      The width of each of the buffer lines.
+ * @param   { int }       dHeight     The height of the buffer.
+ * @param   { int }       dDefaultFG  The default foreground color of the buffer.
+ * @param   { int }       dDefaultBG  The default background color of the buffer.
+*/
+void Buffer_reset(Buffer *this, int dWidth, int dHeight, int dDefaultFG, int dDefaultBG) {
+  int i;
+
+  this->dWidth = dWidth < BUFFER_MAX_WIDTH ? dWidth : BUFFER_MAX_WIDTH;
+  this->dHeight = dHeight < BUFFER_MAX_HEIGHT ? dHeight : BUFFER_MAX_HEIGHT;
+
+  if(this->pCodeCache != NULL) {
+    dDefaultFG = GraphicsCache_quantize(this->pCodeCache, dDefaultFG);
+    dDefaultBG = GraphicsCache_quantize(this->pCodeCache, dDefaultBG);
+  }
+
+  // The default context only has to change with the colors
+  if(this->dDefaultFG != dDefaultFG || this->dDefaultBG != dDefaultBG) {
+    this->dDefaultFG = dDefaultFG;
+    this->dDefaultBG = dDefaultBG;
+    this->defaultCode.dLength = Buffer_writeColors(this, this->defaultCode.sCode, dDefaultFG, dDefaultBG);
+  }
+
+  // The contexts of the last frame are gone, so no one needs their ids anymore
+  this->dContextCount = 0;
+  memset(this->dContextSlots, 0, sizeof(this->dContextSlots));
+
+  if(this->pCodeCache != NULL)
+    GraphicsCache_trim(this->pCodeCache);
+
+  // Fill the lines with spaces and clear their masks
+  for(i = 0; i < this->dHeight; i++) {
+    memset(this->cContentArray[i], 32, this->dWidth * sizeof(this->cContentArray[i][0]));
+    memset(this->dContextMask[i], 0, this->dWidth * sizeof(this->dContextMask[i][0]));
+  }
+}
+
+/**
+ * Makes sure the blob of the buffer can hold a given number of bytes.
+ * 
+ * @param   { Buffer * }  this      The buffer to modify.
+ * @param   { int }       dLength   How many bytes we need room for.
+*/
+void Buffer_reserveBlob(Buffer *this, int dLength) {
+  if(dLength <= this->dBlobCapacity)
+    return;
+
+  this->dBlobCapacity = dLength > this->dBlobCapacity * 2 ? dLength : this->dBlobCapacity * 2;
+  this->sBlob = realloc(this->sBlob, this->dBlobCapacity + 1);
+}
+
+/**
+ * Appends a string to the blob of the buffer.
+ * The caller has to have reserved enough room.
+ * 
+ * @param   { Buffer * }  this      The buffer to modify.
+ * @param   { int }       dLength   Where the blob currently ends.
+ * @param   { char * }    sString   The string to append.
+ * @return  { int }                 Where the blob ends after.
+*/
+int Buffer_appendBlob(Buffer *this, int dLength, char *sString) {
+  while(*sString)
+    this->sBlob[dLength++] = *(sString++);
+
+  return dLength;
+}
+
+/**
+ * Gives the buffer somewhere to keep the sequences of its contexts.
+ * Buffers can share a cache, as long as they aren't drawn to at the same time.
+ * 
+ * @param   { Buffer * }          this        The buffer to modify.
+ * @param   { GraphicsCache * }   pCodeCache  The cache to use.
+*/
+void Buffer_setCodeCache(Buffer *this, GraphicsCache *pCodeCache) {
+  this->pCodeCache = pCodeCache;
+
+  // The defaults have to be sent the way the cache sends everything else
+  if(pCodeCache != NULL) {
+    this->dDefaultFG = GraphicsCache_quantize(pCodeCache, this->dDefaultFG);
+    this->dDefaultBG = GraphicsCache_quantize(pCodeCache, this->dDefaultBG);
+  }
+
+  this->defaultCode.dLength = Buffer_writeColors(this, this->defaultCode.sCode, this->dDefaultFG, this->dDefaultBG);
+}
+
+/**
+ * Writes out the sequence that sets the given colors.
+ * Codes in the cache are just copied over; it's only written out from scratch when the cache couldn't take it.
+ * 
+ * @param   { Buffer * }  this      The buffer whose cache we use.
+ * @param   { char * }    sOut      Where to write the sequence.
+ * @param   { int }       dId       The id of the code in the cache, or GRAPHICS_NO_CODE.
+ * @param   { color }     colorFG   The color of the foreground; this may be negative.
+ * @param   { color }     colorBG   The color of the background; this may be negative.
+ * @return  { int }                 How many chars were written.
+*/
+int Buffer_writeCode(Buffer *this, char *sOut, int dId, color colorFG, color colorBG) {
+  GraphicsCode *pCode;
+
+  if(dId == GRAPHICS_NO_CODE)
+    return Buffer_writeColors(this, sOut, colorFG, colorBG);
+
+  pCode = GraphicsCache_getCode(this->pCodeCache, dId);
+  memcpy(sOut, pCode->sCode, pCode->dLength);
+
+  return pCode->dLength;
+}
+
+/**
+ * Writes out the sequence of a context.
+ * 
+ * @param   { Buffer * }  this      The buffer to read.
+ * @param   { char * }    sOut      Where to write the sequence.
+ * @param   { int }       dMask     The value of the context in the mask (0 for the defaults).
+ * @return  { int }                 How many chars were written.
+*/
+int Buffer_writeContext(Buffer *this, char *sOut, int dMask) {
+  if(!dMask) {
+    memcpy(sOut, this->defaultCode.sCode, this->defaultCode.dLength);
+    return this->defaultCode.dLength;
+  }
+
+  return Buffer_writeCode(this, sOut, 
+    this->dContextCodes[dMask - 1], 
+    this->colorContextFG[dMask - 1], 
+    this->colorContextBG[dMask - 1]);
+}
+
 /**
  * Writes onto a rectangular section of the buffer, starting on (x, y).
  * 
@@ -218,29 +473,20 @@ void Buffer_write(Buffer *this, int x, int y, int h, char *sBlock[]) {
  * @param   { color }     colorBG   The color of the background within the context.
 */
 void Buffer_contextRect(Buffer *this, int x, int y, int w, int h, color colorFG, color colorBG) {
-  int i, j;
-
-  // Can't overload ourselves
-  if(this->dContextCount >= BUFFER_MAX_CONTEXTS)
-    return;
+  int i, j, dContext;
 
   // The user didn't specify anything to define the context
   if(colorFG < 0 && colorBG < 0)
     return;
 
-  // Append the new context
-  if(colorFG < 0)
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeBG(colorBG);
-  else if(colorBG < 0)
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeFG(colorFG);
-  else
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeFGBG(colorFG, colorBG);
+  // Find or append the context
+  dContext = Buffer_addContext(this, colorFG, colorBG);
 
-  // Set the appropriate context values to the index + 1 of the created context
+  // Set the appropriate context values to the index + 1 of the context
   for(i = y; i < y + h && i < this->dHeight; i++) 
     for(j = x; j < x + w && j < this->dWidth; j++) 
       if(i >= 0 && j >= 0)
-        this->dContextMask[i][j] = this->dContextCount;
+        this->dContextMask[i][j] = dContext;
 
 }
 
@@ -258,43 +504,39 @@ void Buffer_contextRect(Buffer *this, int x, int y, int w, int h, color colorFG,
 */
 void Buffer_contextCircle(Buffer *this, int x, int y, int r, color colorFG, color colorBG) {
   int i, j;
+  int dInner, dMiddle, dOuter;    // The three shades of the circle
 
   // Minimum radius would be 1
   if(r < 1)
     return;
 
-  // Can't overload ourselves
-  // The plus 2 is cuz we're adding three new contexts
-  if(this->dContextCount + 2 >= BUFFER_MAX_CONTEXTS)
-    return;
-
   // The user didn't specify anything to define the context
   if(colorFG < 0 && colorBG < 0)
     return;
 
   // Append the new contexts
   if(colorFG < 0) {
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeBG(colorBG);
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeBG(Graphics_lerp(this->dDefaultBG, colorBG, 0.8));
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeBG(Graphics_lerp(this->dDefaultBG, colorBG, 0.5));
+    dInner = Buffer_addContext(this, -1, colorBG);
+    dMiddle = Buffer_addContext(this, -1, Graphics_lerp(this->dDefaultBG, colorBG, 0.8));
+    dOuter = Buffer_addContext(this, -1, Graphics_lerp(this->dDefaultBG, colorBG, 0.5));
 
   } else if(colorBG < 0) {
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeFG(colorFG);
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeFG(Graphics_lerp(this->dDefaultFG, colorFG, 0.8));
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeFG(Graphics_lerp(this->dDefaultFG, colorFG, 0.5));
+    dInner = Buffer_addContext(this, colorFG, -1);
+    dMiddle = Buffer_addContext(this, Graphics_lerp(this->dDefaultFG, colorFG, 0.8), -1);
+    dOuter = Buffer_addContext(this, Graphics_lerp(this->dDefaultFG, colorFG, 0.5), -1);
 
   } else {
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeFGBG(colorFG, colorBG);
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeFGBG(
+    dInner = Buffer_addContext(this, colorFG, colorBG);
+    dMiddle = Buffer_addContext(this, 
       Graphics_lerp(this->dDefaultFG, colorBG, 0.8),
       Graphics_lerp(this->dDefaultBG, colorBG, 0.8));
-    this->sContextArray[this->dContextCount++] = Graphics_getCodeFGBG(
+    dOuter = Buffer_addContext(this, 
       Graphics_lerp(this->dDefaultFG, colorBG, 0.5),
       Graphics_lerp(this->dDefaultBG, colorBG, 0.5));
       
   }
 
-  // Set the appropriate context values to the index + 1 of the created context
+  // Set the appropriate context values to the index + 1 of each context
   // Note that we do r * 2 along the x because the height of a character is twice its width
   for(i = y - r; i < y + r && i < this->dHeight; i++) 
     for(j = x - r * 2; j < x + r * 2 && j < this->dWidth; j++) 
@@ -309,7 +551,7 @@ void Buffer_contextCircle(Buffer *this, int x, int y, int r, color colorFG, colo
           ) 
           <= (r - 1) * (r - 1))
           
-          this->dContextMask[i][j] = this->dContextCount - 2;
+          this->dContextMask[i][j] = dInner;
         
         // Don't mind the unorthodox formatting; this is just to see the form of the expressions
         //    much more clearly. Also, these are just here to shade the circles differently.
@@ -320,7 +562,7 @@ void Buffer_contextCircle(Buffer *this, int x, int y, int r, color colorFG, colo
           ) 
           < r * r)
           
-          this->dContextMask[i][j] = this->dContextCount - 1;
+          this->dContextMask[i][j] = dMiddle;
         
         // The outermost edges of the circle bleed off into the background.
         else if(
@@ -330,7 +572,7 @@ void Buffer_contextCircle(Buffer *this, int x, int y, int r, color colorFG, colo
           ) 
           <= r * r)
           
-          this->dContextMask[i][j] = this->dContextCount;
+          this->dContextMask[i][j] = dOuter;
       }
 
 }
@@ -348,9 +590,12 @@ void Buffer_print(Buffer *this) {
   int bShouldUpdateContext;
 
   // The current length of the blob
-  // and the blob itself
+  // The blob itself stays with the buffer, so we don't allocate it every frame
   int dLen = 0;   
-  char *sBlob = String_alloc(((this->dWidth) + 1) * this->dHeight << 3);
+  char *sBlob;
+
+  Buffer_reserveBlob(this, ((this->dWidth) + 1) * this->dHeight << 3);
+  sBlob = this->sBlob;
 
   // Iterate through the lines
   for(y = 0; y < this->dHeight; y++) {
@@ -362,6 +607,12 @@ void Buffer_print(Buffer *this) {
     // Check context changes too
     for(x = 0; x < this->dWidth; x++) {
 
+      // Make sure a new context and a compound character still fit
+      if(dLen + BUFFER_CELL_BYTES > this->dBlobCapacity) {
+        Buffer_reserveBlob(this, dLen + BUFFER_CELL_BYTES);
+        sBlob = this->sBlob;
+      }
+
       // Whether or not to update into a new context
       bShouldUpdateContext = 0;
 
@@ -376,24 +627,9 @@ void Buffer_print(Buffer *this) {
       }
 
       // Add the context string to the blob
-      if(bShouldUpdateContext) {
-        i = 0;
-        
-        // Just copy the new context string char by char
-        if(dLastMask) {
-          while(this->sContextArray[dLastMask - 1][i]) {
-            sBlob[dLen] = this->sContextArray[dLastMask - 1][i];
-            dLen++; i++;   
-          }
-
-        // If we're going back to "normal", we'll just put back the defaults
-        } else {
-          while(this->sDefaultContext[i] != 0) {
-            sBlob[dLen] = this->sDefaultContext[i];
-            dLen++; i++;   
-          }
-        }
-      }
+      // If we're going back to "normal", we'll just put back the defaults
+      if(bShouldUpdateContext)
+        dLen += Buffer_writeContext(this, sBlob + dLen, dLastMask);
       
       if(String_isChar(this->cContentArray[y][x][0])) {
         sBlob[dLen++] = this->cContentArray[y][x][0];
@@ -411,17 +647,211 @@ void Buffer_print(Buffer *this) {
       sBlob[dLen++] = '\n';
   }
 
+  sBlob[dLen] = 0;
+
   // Set the buffer size and print using puts(), then do garbage collection
   IO_setBuffer(sizeof(sBlob));
 
   // Windows and Unix have different preferences over which output functions are faster
   String_print(sBlob);
-  
-  // Clean up all the stuff we used
-  for(i = 0; i < this->dContextCount; i++)
-    Graphics_delCode(this->sContextArray[i]);
+}
+
+/**
+ * Works out the colors every cell ends up with when the buffer is printed.
+ * Contexts that only set one color keep whatever the previous cells were printed with, 
+ *    just like they do when the whole buffer goes out as one blob.
+ * 
+ * @param   { Buffer * }  this  The buffer to resolve.
+*/
+void Buffer_resolve(Buffer *this) {
+  int x, y, dMask, dLastMask;
+  color colorFG = this->dDefaultFG;
+  color colorBG = this->dDefaultBG;
+
+  for(y = 0; y < this->dHeight; y++) {
+    dLastMask = 0;
+
+    for(x = 0; x < this->dWidth; x++) {
+      dMask = this->dContextMask[y][x];
+
+      // The printer only switches colors when the mask changes
+      if(dMask != dLastMask) {
+        dLastMask = dMask;
+
+        if(dMask) {
+          if(this->colorContextFG[dMask - 1] >= 0) colorFG = this->colorContextFG[dMask - 1];
+          if(this->colorContextBG[dMask - 1] >= 0) colorBG = this->colorContextBG[dMask - 1];
+        
+        } else {
+          colorFG = this->dDefaultFG;
+          colorBG = this->dDefaultBG;
+        }
+      }
+
+      this->colorStyleFG[y][x] = colorFG;
+      this->colorStyleBG[y][x] = colorBG;
+    }
+  }
+}
+
+/**
+ * Checks whether or not two cells hold the same character.
+ * Single-byte characters don't clear the bytes after them, so we can't just compare all four.
+ * 
+ * @param   { char * }  cCell1  The first cell.
+ * @param   { char * }  cCell2  The second cell.
+ * @return  { int }             Whether or not they print the same thing.
+*/
+int Buffer_isSameChar(char *cCell1, char *cCell2) {
+  int i;
+
+  if(String_isChar(cCell1[0]) || String_isChar(cCell2[0]))
+    return cCell1[0] == cCell2[0];
+
+  for(i = 0; i < 4 && cCell1[i] == cCell2[i]; i++)
+    if(!cCell1[i])
+      return 1;
+
+  return i == 4;
+}
+
+/**
+ * Checks whether or not a cell of the buffer differs from what's on the screen.
+ * 
+ * @param   { Buffer * }  this      The buffer to compare.
+ * @param   { Buffer * }  pScreen   The buffer holding what's currently on the screen.
+ * @param   { int }       x         The x-coordinate of the cell.
+ * @param   { int }       y         The y-coordinate of the cell.
+ * @return  { int }                 Whether or not the cell has to be printed again.
+*/
+int Buffer_isChanged(Buffer *this, Buffer *pScreen, int x, int y) {
+  return 
+    this->colorStyleFG[y][x] != pScreen->colorStyleFG[y][x] ||
+    this->colorStyleBG[y][x] != pScreen->colorStyleBG[y][x] ||
+    !Buffer_isSameChar(this->cContentArray[y][x], pScreen->cContentArray[y][x]);
+}
+
+/**
+ * Writes out the parts of the buffer that differ from what's on the screen, without printing them.
+ * The screen is just another buffer that remembers the last frame we printed, cell by cell.
+ * Each run of changed cells gets a cursor jump followed by its contents, so a frame where 
+ *    nothing moved comes out empty. A screen of a different size gets drawn from scratch.
+ * The output is left in the blob of the screen.
+ * 
+ * @param   { Buffer * }  this      The buffer to compare.
+ * @param   { Buffer * }  pScreen   What's currently on the screen; this gets updated to the new frame.
+ * @return  { int }                 How long the output is.
+*/
+int Buffer_diff(Buffer *this, Buffer *pScreen) {
+  int x, y, i, k, dStart, dEnd, dGap;
+  int dLen = 0;
+  color colorFG, colorBG;
+  char sJump[GRAPHICS_STD_SEQ];
+
+  // Whether or not every cell has to be printed
+  int bIsFull = this->dWidth != pScreen->dWidth || this->dHeight != pScreen->dHeight;
+
+  Buffer_resolve(this);
+
+  for(y = 0; y < this->dHeight; y++) {
+    x = 0;
+
+    // Most rows don't change at all, and comparing them whole is much quicker than going cell by cell
+    if(!bIsFull &&
+      !memcmp(pScreen->cContentArray[y], this->cContentArray[y], this->dWidth * sizeof(this->cContentArray[y][0])) &&
+      !memcmp(pScreen->colorStyleFG[y], this->colorStyleFG[y], this->dWidth * sizeof(this->colorStyleFG[y][0])) &&
+      !memcmp(pScreen->colorStyleBG[y], this->colorStyleBG[y], this->dWidth * sizeof(this->colorStyleBG[y][0])))
+      continue;
+
+    while(x < this->dWidth) {
+
+      // Skip to the next cell that changed
+      while(x < this->dWidth && !bIsFull && !Buffer_isChanged(this, pScreen, x, y))
+        x++;
+
+      if(x >= this->dWidth)
+        break;
+
+      // The run goes on until we see a gap too long to be worth printing over
+      dStart = dEnd = x;
+      for(dGap = 0; x < this->dWidth && dGap <= BUFFER_DIFF_GAP; x++) {
+        if(bIsFull || Buffer_isChanged(this, pScreen, x, y)) {
+          dEnd = x;
+          dGap = 0;
+        } else {
+          dGap++;
+        }
+      }
+
+      x = dEnd + 1;
+
+      // Move the cursor to the start of the run (the terminal counts from 1)
+      Buffer_reserveBlob(pScreen, dLen + (dEnd - dStart + 1) * BUFFER_CELL_BYTES);
+      snprintf(sJump, GRAPHICS_STD_SEQ, "\x1b[%d;%dH", y + 1, dStart + 1);
+      dLen = Buffer_appendBlob(pScreen, dLen, sJump);
+
+      for(i = dStart; i <= dEnd; i++) {
+        colorFG = this->colorStyleFG[y][i];
+        colorBG = this->colorStyleBG[y][i];
+
+        // Only tell the terminal about the colors that actually changed
+        if(colorFG != pScreen->colorPenFG || colorBG != pScreen->colorPenBG) {
+          colorFG = colorFG != pScreen->colorPenFG ? colorFG : -1;
+          colorBG = colorBG != pScreen->colorPenBG ? colorBG : -1;
+
+          dLen += Buffer_writeCode(this, pScreen->sBlob + dLen, 
+            this->pCodeCache != NULL ? GraphicsCache_get(this->pCodeCache, colorFG, colorBG) : GRAPHICS_NO_CODE, 
+            colorFG, colorBG);
+
+          pScreen->colorPenFG = this->colorStyleFG[y][i];
+          pScreen->colorPenBG = this->colorStyleBG[y][i];
+        }
+
+        // Copy the char itself
+        if(String_isChar(this->cContentArray[y][i][0])) {
+          pScreen->sBlob[dLen++] = this->cContentArray[y][i][0];
+
+        } else {
+          k = 0;
+
+          while(k < 4 && this->cContentArray[y][i][k])
+            pScreen->sBlob[dLen++] = this->cContentArray[y][i][k++];
+        }
+      }
+    }
+
+    // The screen now holds this row
+    memcpy(pScreen->cContentArray[y], this->cContentArray[y], this->dWidth * sizeof(this->cContentArray[y][0]));
+    memcpy(pScreen->colorStyleFG[y], this->colorStyleFG[y], this->dWidth * sizeof(this->colorStyleFG[y][0]));
+    memcpy(pScreen->colorStyleBG[y], this->colorStyleBG[y], this->dWidth * sizeof(this->colorStyleBG[y][0]));
+  }
+
+  pScreen->dWidth = this->dWidth;
+  pScreen->dHeight = this->dHeight;
+
+  if(dLen)
+    pScreen->sBlob[dLen] = 0;
+
+  return dLen;
+}
+
+/**
+ * Outputs only the parts of the buffer that differ from what's on the screen.
+ * 
+ * @param   { Buffer * }  this      The buffer to print.
+ * @param   { Buffer * }  pScreen   What's currently on the screen; this gets updated to the new frame.
+ * @return  { int }                 Whether or not anything on the screen changed.
+*/
+int Buffer_printDiff(Buffer *this, Buffer *pScreen) {
+
+  // Nothing changed, so there's nothing to say
+  if(!Buffer_diff(this, pScreen))
+    return 0;
+
+  String_print(pScreen->sBlob);
+  IO_flushBuffer();
 
-  String_kill(sBlob);
+  return 1;
 }
 
 #endif
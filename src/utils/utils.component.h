@@ -24,6 +24,9 @@
 // Integer values we don't wanna change
 #define COMPONENT_NO_CHANGE -99999
 
+// The handle of a component that doesn't exist
+#define COMPONENT_NO_HANDLE -1
+
 // Max number of children per component
 #define COMPONENT_MAX_CHILD_COUNT (1 << 10)
 
@@ -36,6 +39,15 @@ typedef enum ComponentAnchorY ComponentAnchorY;
 typedef struct Component Component;
 typedef struct ComponentManager ComponentManager;
 
+// Creates a template for the function that draws the tiles of a tilemap
+// Here, the following are:
+//    (1) pArgs             =>  Whatever the tiles are drawn from
+//    (2) pBuffer           =>  The buffer to draw on
+//    (3) x, y              =>  Where the first tile goes in the buffer
+//    (4) dStartX, dStartY  =>  The first tile to draw along each axis
+//    (5) dEndX, dEndY      =>  The tile to stop at along each axis (this one isn't drawn)
+typedef void (*f_tilemap_handler)(p_obj pArgs, Buffer *pBuffer, int x, int y, int dStartX, int dStartY, int dEndX, int dEndY);
+
 enum ComponentType {
   COMPONENT_SINGLE_ROW,
   COMPONENT_MULTI_ROW,
@@ -86,9 +98,12 @@ enum ComponentAnchorY {
 struct Component {
   char sName[STRING_KEY_MAX_LENGTH];                // The name of the component
                                                     // This is important so we can get its states in the page class
+  int dHandle;                                      // Where the component sits in the list of its manager
 
   int zIndex;                                       // Default is 0; helps with layering
   int bIsHidden;                                    // Whether or not the component is hidden
+  int bIsDirty;                                     // Whether or not its layout has to be worked out again
+                                                    // If a component is dirty, so are all of its descendants
 
   Component *pParent;                               // The parent component
   Component *pChildren[COMPONENT_MAX_CHILD_COUNT];  // The children components
@@ -122,6 +137,13 @@ struct Component {
   color colorFG;                                    // A color for the foreground
   color colorBG;                                    // A color for the background
 
+  f_tilemap_handler fTilemapHandler;                // Draws the tiles of the component; this is NULL unless it's a tilemap
+  p_obj pTilemapObject;                             // What the tiles are drawn from
+  int dTileW;                                       // The width of a single tile
+  int dTileH;                                       // The height of a single tile
+  int dTileCountX;                                  // How many tiles there are along a row
+  int dTileCountY;                                  // How many tiles there are along a column
+
   ComponentType eComponentType;                     // Determines how the component renders its children
   ComponentAlignmentX eComponentAlignmentX;         // Determiens the alignment of its children along the horizontal
   ComponentAlignmentY eComponentAlignmentY;         // Determiens the alignment of its children along the vertical
@@ -166,6 +188,12 @@ Component *Component_init(Component *this, char *sName, Component *pParent, int
   this->zIndex = 0;
   this->bIsHidden = 0;
 
+  // It hasn't been laid out yet
+  this->bIsDirty = 1;
+
+  // The manager gives it a handle once it's added
+  this->dHandle = COMPONENT_NO_HANDLE;
+
   // Default component type
   this->eComponentType = COMPONENT_FIXED;
   this->eComponentAlignmentX = COMPONENT_LEFT_ALIGN_X;
@@ -245,6 +273,14 @@ Component *Component_init(Component *this, char *sName, Component *pParent, int
   this->dRenderW = 0;
   this->dRenderH = 0;
 
+  // Not a tilemap by default
+  this->fTilemapHandler = NULL;
+  this->pTilemapObject = NULL;
+  this->dTileW = 0;
+  this->dTileH = 0;
+  this->dTileCountX = 0;
+  this->dTileCountY = 0;
+
   this->dAssetHeight = dAssetHeight;
   this->aAsset = aAsset;
 
@@ -381,6 +417,100 @@ int Component_add(Component *this, Component *pChild) {
   return 1;
 }
 
+/**
+ * Marks a component and everything under it as needing to be laid out again.
+ * Since dirty components only ever have dirty descendants, we can stop at the ones that already are.
+ * 
+ * @param   { Component * }   this  The component that changed.
+*/
+void Component_setDirty(Component *this) {
+  int i;
+
+  if(this->bIsDirty)
+    return;
+
+  this->bIsDirty = 1;
+
+  for(i = 0; i < this->dChildCount; i++)
+    Component_setDirty(this->pChildren[i]);
+}
+
+/**
+ * Checks whether or not a component already displays some text.
+ * The text is split into lines the same way the page splits it when it makes an asset out of it.
+ * 
+ * @param   { Component * }   this    The component to check.
+ * @param   { char * }        sText   The text to compare against.
+ * @return  { int }                   Whether or not the asset of the component is exactly the text.
+*/
+int Component_hasText(Component *this, char *sText) {
+  int i;
+  size_t dLength;
+
+  if(this->aAsset == NULL)
+    return 0;
+
+  for(i = 0; i < this->dAssetHeight; i++) {
+    dLength = strcspn(sText, "\n");
+
+    // The lines have to match
+    if(this->aAsset[i] == NULL || strlen(this->aAsset[i]) != dLength || strncmp(this->aAsset[i], sText, dLength))
+      return 0;
+
+    sText += dLength;
+
+    // The last line has to be the end of the text
+    if(i == this->dAssetHeight - 1)
+      return *sText == 0;
+
+    // The text ran out before the asset did
+    if(*sText == 0)
+      return 0;
+
+    sText++;
+  }
+
+  return 0;
+}
+
+/**
+ * Draws the tiles of a tilemap that end up inside the buffer.
+ * Tiles may spill a cell onto their neighbors (for the borders they share), so we keep one extra tile on each side.
+ * 
+ * @param   { Component * }   this      The tilemap to draw.
+ * @param   { Buffer * }      pBuffer   The buffer to draw on.
+*/
+void Component_renderTilemap(Component *this, Buffer *pBuffer) {
+  int dStartX = 0, dStartY = 0;
+  int dEndX = this->dTileCountX, dEndY = this->dTileCountY;
+
+  if(this->fTilemapHandler == NULL || this->dTileW <= 0 || this->dTileH <= 0)
+    return;
+
+  // Skip the tiles before the left and top edges of the buffer
+  if(this->dRenderX < 0)
+    dStartX = -this->dRenderX / this->dTileW - 1;
+
+  if(this->dRenderY < 0)
+    dStartY = -this->dRenderY / this->dTileH - 1;
+
+  dStartX = dStartX < 0 ? 0 : dStartX;
+  dStartY = dStartY < 0 ? 0 : dStartY;
+
+  // And the ones past the right and bottom edges
+  if(dEndX > (pBuffer->dWidth - this->dRenderX) / this->dTileW + 1)
+    dEndX = (pBuffer->dWidth - this->dRenderX) / this->dTileW + 1;
+
+  if(dEndY > (pBuffer->dHeight - this->dRenderY) / this->dTileH + 1)
+    dEndY = (pBuffer->dHeight - this->dRenderY) / this->dTileH + 1;
+
+  // Nothing can be seen
+  if(dStartX >= dEndX || dStartY >= dEndY)
+    return;
+
+  this->fTilemapHandler(this->pTilemapObject, pBuffer, this->dRenderX, this->dRenderY, dStartX, dStartY, dEndX, dEndY);
+}
+
 /**
  * Computes the position of the component based on parent components.
 */
@@ -481,6 +611,9 @@ void Component_config(Component *this) {
  * A struct that stores a tree and hashmap of components.
  * The tree helps us render the components later on.
  * The hashmap allows us to append components much more easily.
+ * Every component also gets an integer handle, which is just its index in a list of the components.
+ * Handles are given out in the order the components were added, so they let us skip the hashmap
+ *    (and formatting the keys) when we update a lot of components every frame.
  * Note that this struct automatically creates a root node to which all other nodes
  *    may be appended.
  * 
@@ -491,8 +624,65 @@ struct ComponentManager {
   
   HashMap *pComponentMap;   // A hashmap with our components
   Queue *pRenderQueue;      // A queue we'll use for rendering
+
+  Component **aComponents;  // The components by handle; the root is always 0
+  int nComponents;
+  int dComponentCapacity;
+
+  int bHasChanged;          // Whether or not the last frame changed anything on the screen
 };
 
+/**
+ * Gives a component the next handle.
+ * 
+ * @param		{ ComponentManager * }		this          The component manager.
+ * @param   { Component * }           pComponent    The component to keep track of.
+ * @return  { int }                                 The handle of the component.
+*/
+int ComponentManager_register(ComponentManager *this, Component *pComponent) {
+
+  // Make some room
+  if(this->nComponents >= this->dComponentCapacity) {
+    this->dComponentCapacity = this->dComponentCapacity ? this->dComponentCapacity * 2 : 64;
+    this->aComponents = realloc(this->aComponents, this->dComponentCapacity * sizeof(*this->aComponents));
+  }
+
+  pComponent->dHandle = this->nComponents;
+  this->aComponents[this->nComponents++] = pComponent;
+
+  return pComponent->dHandle;
+}
+
+/**
+ * Returns the component with a given handle.
+ * 
+ * @param		{ ComponentManager * }		this          The component manager.
+ * @param   { int }                   dHandle       The handle of the component.
+ * @return  { Component * }                         The component, or NULL if there's no such handle.
+*/
+Component *ComponentManager_get(ComponentManager *this, int dHandle) {
+  if(dHandle < 0 || dHandle >= this->nComponents)
+    return NULL;
+
+  return this->aComponents[dHandle];
+}
+
+/**
+ * Returns the handle of the component with a given key.
+ * 
+ * @param		{ ComponentManager * }		this          The component manager.
+ * @param   { char * }                sKey          An identifier for the component.
+ * @return  { int }                                 The handle of the component, or COMPONENT_NO_HANDLE if it doesn't exist.
+*/
+int ComponentManager_getHandle(ComponentManager *this, char *sKey) {
+  Component *pComponent = HashMap_get(this->pComponentMap, sKey);
+
+  if(pComponent == NULL)
+    return COMPONENT_NO_HANDLE;
+
+  return pComponent->dHandle;
+}
+
 /**
  * Allocates memory for an instance of the ComponentManager class.
  * 
@@ -507,8 +697,17 @@ void ComponentManager_init(ComponentManager *this) {
   this->pRenderQueue = Queue_create();
   this->pComponentMap = HashMap_create();
 
+  // No handles yet
+  this->aComponents = NULL;
+  this->nComponents = 0;
+  this->dComponentCapacity = 0;
+
   // Add the root to the hashmap
   HashMap_add(this->pComponentMap, "root", this->pRoot);
+  ComponentManager_register(this, this->pRoot);
+
+  // Nothing has been rendered yet
+  this->bHasChanged = 0;
 }
 
 /**
@@ -519,6 +718,8 @@ void ComponentManager_init(ComponentManager *this) {
 void ComponentManager_exit(ComponentManager *this) {
   Queue_kill(this->pRenderQueue);
   HashMap_kill(this->pComponentMap);
+
+  free(this->aComponents);
 }
 
 /**
@@ -535,7 +736,7 @@ void ComponentManager_exit(ComponentManager *this) {
  * @param   { char ** }               aAsset        The asset to be rendered by the component. This may be NULL.
  * @param   { color }                 colorFG       A foreground color for the component.
  * @param   { color }                 colorBG       A background color for the component.
- * @return  { int }                                 Whether or not the component was added successfully.
+ * @return  { int }                                 The handle of the new component, or COMPONENT_NO_HANDLE if it couldn't be added.
 */
 int ComponentManager_add(ComponentManager *this, char *sKey, char *sParentKey, int x, int y, int w, int h, int dAssetHeight, char **aAsset, color colorFG, color colorBG) {
   Component *pParent =  NULL;
@@ -546,65 +747,106 @@ int ComponentManager_add(ComponentManager *this, char *sKey, char *sParentKey, i
 
   // The parent doesn't exist
   if(pParent == NULL && sParentKey != NULL)
-    return 0;
+    return COMPONENT_NO_HANDLE;
 
   // We have a duplicate component
   if(HashMap_get(this->pComponentMap, sKey) != NULL)
-    return 0;
+    return COMPONENT_NO_HANDLE;
 
   // Create the child
   pChild = Component_create(sKey, pParent, x, y, w, h, dAssetHeight, aAsset, colorFG, colorBG);
 
   // Couldn't add the child because too many children
-  if(!Component_add(pParent, pChild))
+  if(!Component_add(pParent, pChild)) {
     Component_kill(pChild);
+    return COMPONENT_NO_HANDLE;
+  }
+
+  // The parent might have grown, so its children have to be laid out again
+  Component_setDirty(pParent);
 
   // Otherwise, append it to the hashmap too
   HashMap_add(this->pComponentMap, sKey, pChild);
 
-  return 1;
+  return ComponentManager_register(this, pChild);
 }
 
 /**
  * Set the position of a specified component.
  * 
  * @param		{ ComponentManager * }		this          The component manager.
- * @param   { char * }                sKey          An identifier for the component.
+ * @param   { int }                   dHandle       The handle of the component.
  * @param   { int }                   x             The x-coordinate of the component.
  * @param   { int }                   y             The y-coordinate of the component.
 */
-void ComponentManager_setPos(ComponentManager *this, char *sKey, int x, int y) {
-  Component *pComponent = HashMap_get(this->pComponentMap, sKey);
+void ComponentManager_setPosByHandle(ComponentManager *this, int dHandle, int x, int y) {
+  Component *pComponent = ComponentManager_get(this, dHandle);
 
   if(pComponent == NULL)
     return;
 
+  // Nothing moved
+  if((x == COMPONENT_NO_CHANGE || x == pComponent->x) && (y == COMPONENT_NO_CHANGE || y == pComponent->y))
+    return;
+
   if(x != COMPONENT_NO_CHANGE)
     pComponent->x = x;
 
   if(y != COMPONENT_NO_CHANGE)
     pComponent->y = y;
+
+  Component_setDirty(pComponent);
 }
 
 /**
- * Set the size of a specified component.
+ * Set the position of a specified component.
  * 
  * @param		{ ComponentManager * }		this          The component manager.
  * @param   { char * }                sKey          An identifier for the component.
+ * @param   { int }                   x             The x-coordinate of the component.
+ * @param   { int }                   y             The y-coordinate of the component.
+*/
+void ComponentManager_setPos(ComponentManager *this, char *sKey, int x, int y) {
+  ComponentManager_setPosByHandle(this, ComponentManager_getHandle(this, sKey), x, y);
+}
+
+/**
+ * Set the size of a specified component.
+ * 
+ * @param		{ ComponentManager * }		this          The component manager.
+ * @param   { int }                   dHandle       The handle of the component.
  * @param   { int }                   w             The width of the component.
  * @param   { int }                   h             The height of the component.
 */
-void ComponentManager_setSize(ComponentManager *this, char *sKey, int w, int h) {
-  Component *pComponent = HashMap_get(this->pComponentMap, sKey);
+void ComponentManager_setSizeByHandle(ComponentManager *this, int dHandle, int w, int h) {
+  Component *pComponent = ComponentManager_get(this, dHandle);
 
   if(pComponent == NULL)
     return;
 
+  // Nothing changed
+  if((w == COMPONENT_NO_CHANGE || w == pComponent->w) && (h == COMPONENT_NO_CHANGE || h == pComponent->h))
+    return;
+
   if(w != COMPONENT_NO_CHANGE)
     pComponent->w = w;
 
   if(h != COMPONENT_NO_CHANGE)
     pComponent->h = h;
+
+  Component_setDirty(pComponent);
+}
+
+/**
+ * Set the size of a specified component.
+ * 
+ * @param		{ ComponentManager * }		this          The component manager.
+ * @param   { char * }                sKey          An identifier for the component.
+ * @param   { int }                   w             The width of the component.
+ * @param   { int }                   h             The height of the component.
+*/
+void ComponentManager_setSize(ComponentManager *this, char *sKey, int w, int h) {
+  ComponentManager_setSizeByHandle(this, ComponentManager_getHandle(this, sKey), w, h);
 }
 
 /**
@@ -628,28 +870,43 @@ void ComponentManager_setZIndex(ComponentManager *this, char *sKey, int zIndex)
  * 1 means hidden, 0 means visible.
  * 
  * @param		{ ComponentManager * }		this          The component manager.
- * @param   { char * }                sKey          An identifier for the component.
+ * @param   { int }                   dHandle       The handle of the component.
  * @param   { int }                   bIsHidden     The new value of bIsHidden.
 */
-void ComponentManager_setHidden(ComponentManager *this, char *sKey, int bIsHidden) {
-  Component *pComponent = HashMap_get(this->pComponentMap, sKey);
+void ComponentManager_setHiddenByHandle(ComponentManager *this, int dHandle, int bIsHidden) {
+  Component *pComponent = ComponentManager_get(this, dHandle);
 
-  if(pComponent == NULL)
+  if(pComponent == NULL || pComponent->bIsHidden == bIsHidden)
     return;
 
   pComponent->bIsHidden = bIsHidden;
+
+  // Its descendants weren't laid out while it was hidden
+  Component_setDirty(pComponent);
 }
 
 /**
- * Set the color of a specified component.
+ * Sets the visibility of a component.
+ * 1 means hidden, 0 means visible.
  * 
  * @param		{ ComponentManager * }		this          The component manager.
  * @param   { char * }                sKey          An identifier for the component.
+ * @param   { int }                   bIsHidden     The new value of bIsHidden.
+*/
+void ComponentManager_setHidden(ComponentManager *this, char *sKey, int bIsHidden) {
+  ComponentManager_setHiddenByHandle(this, ComponentManager_getHandle(this, sKey), bIsHidden);
+}
+
+/**
+ * Set the color of a specified component.
+ * 
+ * @param		{ ComponentManager * }		this          The component manager.
+ * @param   { int }                   dHandle       The handle of the component.
  * @param   { color }                 colorFG       The foreground color of the component.
  * @param   { color }                 colorBG       The background color of the component.
 */
-void ComponentManager_setColor(ComponentManager *this, char *sKey, color colorFG, color colorBG) {
-  Component *pComponent = HashMap_get(this->pComponentMap, sKey);
+void ComponentManager_setColorByHandle(ComponentManager *this, int dHandle, color colorFG, color colorBG) {
+  Component *pComponent = ComponentManager_get(this, dHandle);
 
   if(pComponent == NULL)
     return;
@@ -662,16 +919,31 @@ void ComponentManager_setColor(ComponentManager *this, char *sKey, color colorFG
 }
 
 /**
- * Set the asset of the specified component.
+ * Set the color of a specified component.
  * 
  * @param		{ ComponentManager * }		this          The component manager.
  * @param   { char * }                sKey          An identifier for the component.
+ * @param   { color }                 colorFG       The foreground color of the component.
+ * @param   { color }                 colorBG       The background color of the component.
+*/
+void ComponentManager_setColor(ComponentManager *this, char *sKey, color colorFG, color colorBG) {
+  ComponentManager_setColorByHandle(this, ComponentManager_getHandle(this, sKey), colorFG, colorBG);
+}
+
+/**
+ * Set the asset of the specified component.
+ * 
+ * @param		{ ComponentManager * }		this          The component manager.
+ * @param   { int }                   dHandle       The handle of the component.
  * @param   { int }                   dAssetHeight  The height of the provided asset.
  * @param   { char ** }               aAsset        The actual information stored by the asset.
 */
-void ComponentManager_setAsset(ComponentManager *this, char *sKey, int dAssetHeight, char **aAsset) {
+void ComponentManager_setAssetByHandle(ComponentManager *this, int dHandle, int dAssetHeight, char **aAsset) {
   int i;
-  Component *pComponent = HashMap_get(this->pComponentMap, sKey);
+  Component *pComponent = ComponentManager_get(this, dHandle);
+
+  if(pComponent == NULL)
+    return;
 
   // Garbage collection
   for(i = 0; i < pComponent->dAssetHeight; i++)
@@ -686,6 +958,48 @@ void ComponentManager_setAsset(ComponentManager *this, char *sKey, int dAssetHei
   pComponent->dAssetHeight = dAssetHeight;
 }
 
+/**
+ * Set the asset of the specified component.
+ * 
+ * @param		{ ComponentManager * }		this          The component manager.
+ * @param   { char * }                sKey          An identifier for the component.
+ * @param   { int }                   dAssetHeight  The height of the provided asset.
+ * @param   { char ** }               aAsset        The actual information stored by the asset.
+*/
+void ComponentManager_setAsset(ComponentManager *this, char *sKey, int dAssetHeight, char **aAsset) {
+  ComponentManager_setAssetByHandle(this, ComponentManager_getHandle(this, sKey), dAssetHeight, aAsset);
+}
+
+/**
+ * Turns a component into a tilemap.
+ * The tiles aren't components; the handler draws whichever of them can be seen straight onto the buffer.
+ * Tiles share their borders, so the component ends up a cell wider and taller than its tiles.
+ * 
+ * @param		{ ComponentManager * }		this            The component manager.
+ * @param   { int }                   dHandle         The handle of the component.
+ * @param   { f_tilemap_handler }     fHandler        Draws the tiles.
+ * @param   { p_obj }                 pTilemapObject  What the tiles are drawn from; this is passed to the handler.
+ * @param   { int }                   dTileW          The width of a single tile.
+ * @param   { int }                   dTileH          The height of a single tile.
+ * @param   { int }                   dTileCountX     How many tiles there are along a row.
+ * @param   { int }                   dTileCountY     How many tiles there are along a column.
+*/
+void ComponentManager_setTilemapByHandle(ComponentManager *this, int dHandle, f_tilemap_handler fHandler, p_obj pTilemapObject, int dTileW, int dTileH, int dTileCountX, int dTileCountY) {
+  Component *pComponent = ComponentManager_get(this, dHandle);
+
+  if(pComponent == NULL)
+    return;
+
+  pComponent->fTilemapHandler = fHandler;
+  pComponent->pTilemapObject = pTilemapObject;
+  pComponent->dTileW = dTileW;
+  pComponent->dTileH = dTileH;
+  pComponent->dTileCountX = dTileCountX;
+  pComponent->dTileCountY = dTileCountY;
+
+  ComponentManager_setSizeByHandle(this, dHandle, dTileCountX * dTileW + 1, dTileCountY * dTileH + 1);
+}
+
 /**
  * Checks if a component exists within the manager.
  * 
@@ -698,23 +1012,29 @@ int ComponentManager_exists(ComponentManager *this, char *sKey) {
 }
 
 /**
- * Renders the components in the tree to the specified buffer.
+ * Draws the components in the tree onto the specified buffer, without printing anything.
+ * Only the components that changed since the last frame (and whatever is under them) are laid out again.
  * 
  * @param   { ComponentManager * }  this      The component manager.
- * @param   { Buffer * }            pBuffer   The buffer to render components to.
+ * @param   { Buffer * }            pBuffer   The buffer to draw components on. Its old contents are cleared.
+ * @param   { int }                 dWidth    How wide the frame is.
+ * @param   { int }                 dHeight   How tall the frame is.
 */
-void ComponentManager_render(ComponentManager *this, Buffer *pBuffer) {
+void ComponentManager_draw(ComponentManager *this, Buffer *pBuffer, int dWidth, int dHeight) {
   int i, z = 0;
   Component *pComponent = NULL;
   Component *pChildComponent;
 
   // Initialize the queue with just the root component
+  // The root always sits at the origin, so it never has to be laid out
   Queue_push(this->pRenderQueue, this->pRoot);
+  this->pRoot->bIsDirty = 0;
 
-  // Prepare the buffer
-  pBuffer = Buffer_create(
-    IO_getWidth(), 
-    IO_getHeight(), 
+  // Prepare the buffer; it's reused across frames, so we only clear it
+  Buffer_reset(
+    pBuffer,
+    dWidth, 
+    dHeight, 
     0x000000,
     0x000000);
 
@@ -745,8 +1065,11 @@ void ComponentManager_render(ComponentManager *this, Buffer *pBuffer) {
       for(i = 0; i < pComponent->dChildCount; i++) {
         pChildComponent = pComponent->pChildren[i];
 
-        // Compute its position based on parent offsets
-        Component_config(pChildComponent);
+        // Compute its position based on parent offsets, if anything changed
+        if(pChildComponent->bIsDirty) {
+          Component_config(pChildComponent);
+          pChildComponent->bIsDirty = 0;
+        }
 
         // Push the child to the queue
         Queue_push(this->pRenderQueue, pChildComponent);
@@ -774,6 +1097,10 @@ void ComponentManager_render(ComponentManager *this, Buffer *pBuffer) {
           pComponent->aAsset);
       }
 
+      // If the component draws its own tiles
+      if(pComponent->fTilemapHandler != NULL)
+        Component_renderTilemap(pComponent, pBuffer);
+
       // Store the new z index
       z = pComponent->zIndex;
 
@@ -782,13 +1109,29 @@ void ComponentManager_render(ComponentManager *this, Buffer *pBuffer) {
 
     }
   }
+}
 
-  // Reset the cursor home position
-  IO_resetCursor();
-  
-  // Print the buffer
-  Buffer_print(pBuffer);
-  Buffer_kill(pBuffer);
+/**
+ * Renders the components in the tree to the specified buffer, and then to the screen.
+ * If we know what's on the screen, only the cells that changed get printed.
+ * 
+ * @param   { ComponentManager * }  this      The component manager.
+ * @param   { Buffer * }            pBuffer   The buffer to render components to. Its old contents are cleared.
+ * @param   { Buffer * }            pScreen   What's currently on the screen. This may be NULL.
+*/
+void ComponentManager_render(ComponentManager *this, Buffer *pBuffer, Buffer *pScreen) {
+  ComponentManager_draw(this, pBuffer, IO_getWidth(), IO_getHeight());
+
+  // Print only what changed since the last frame
+  if(pScreen != NULL) {
+    this->bHasChanged = Buffer_printDiff(pBuffer, pScreen);
+
+  // Otherwise, reset the cursor home position and print the whole buffer
+  } else {
+    IO_resetCursor();
+    Buffer_print(pBuffer);
+    this->bHasChanged = 1;
+  }
 }
 
 /**
@@ -810,6 +1153,10 @@ void ComponentManager_reset(ComponentManager *this) {
   // Add the new root element to the new hashmap
   this->pRoot = Component_create("root", NULL, 0, 0, 0, 0, 0, NULL, -1, -1);
   HashMap_add(this->pComponentMap, "root", this->pRoot);  
+
+  // The old handles don't mean anything anymore
+  this->nComponents = 0;
+  ComponentManager_register(this, this->pRoot);
 }
 
 #endif
@@ -162,6 +162,32 @@ void File_readBinObject(File *this, int dOffset, int n, p_obj pOutputObject) {
   fclose(this->pFile);
 }
 
+/**
+ * Returns the size of the file in bytes.
+ * 
+ * @param   { File * }    this    The file to check.
+ * @return  { long }              The size of the file, or -1 if it couldn't be opened.
+*/
+long File_getSize(File *this) {
+  long dSize;
+
+  // Open the file
+  this->pFile = fopen(this->sPath, "rb");
+
+  // Exit the routine if it's not found or smth
+  if(this->pFile == NULL)
+    return -1;
+
+  // The position at the end is the size
+  fseek(this->pFile, 0, SEEK_END);
+  dSize = ftell(this->pFile);
+
+  // Close the file
+  fclose(this->pFile);
+
+  return dSize;
+}
+
 /**
  * Writes to a text file.
  * This function only appends data to the existing content of the file.
@@ -20,6 +20,34 @@
 #include <stdlib.h>
 
 #define GRAPHICS_STD_SEQ 32
+#define GRAPHICS_CACHE_SIZE (1 << 12)           // How many codes the cache can hold; this has to be a power of 2
+#define GRAPHICS_NO_CODE -1                     // What the cache hands out when it's too full to take a new code
+
+#define GRAPHICS_LUT_BITS 5                     // How many bits of each channel the palette lookup table keeps
+#define GRAPHICS_LUT_SIZE (1 << GRAPHICS_LUT_BITS * 3)
+
+typedef enum GraphicsMode GraphicsMode;
+typedef struct GraphicsCode GraphicsCode;
+typedef struct GraphicsCache GraphicsCache;
+
+/**
+ * How colors get sent to the terminal.
+ * The smaller palettes make for much shorter sequences, and work on terminals without truecolor.
+*/
+enum GraphicsMode {
+  GRAPHICS_MODE_TRUECOLOR,    // Colors are sent as they are (38;2;r;g;b)
+  GRAPHICS_MODE_256,          // Colors are rounded to the 6x6x6 cube and the grays of the 256-color palette (38;5;n)
+  GRAPHICS_MODE_16,           // Colors are rounded to the 16 basic colors (30-37 and 90-97)
+};
+
+// The 16 basic colors, as xterm shows them by default
+const color GRAPHICS_PALETTE_16[16] = {
+  0x000000, 0xcd0000, 0x00cd00, 0xcdcd00, 0x0000ee, 0xcd00cd, 0x00cdcd, 0xe5e5e5,
+  0x7f7f7f, 0xff0000, 0x00ff00, 0xffff00, 0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff,
+};
+
+// The levels each channel can take in the 6x6x6 cube of the 256-color palette
+const int GRAPHICS_CUBE_LEVELS[6] = { 0x00, 0x5f, 0x87, 0xaf, 0xd7, 0xff };
 
 /**
  * Color functions
@@ -30,6 +58,10 @@ char *Graphics_getCodeBG(color color);
 
 char *Graphics_getCodeFGBG(color colorFG, color colorBG);
 
+int Graphics_writeCode(char *sOut, color colorFG, color colorBG);
+
+color Graphics_RGB(int r, int g, int b);
+
 /**
  * //
  * ////
@@ -123,6 +155,33 @@ char *Graphics_getCodeFGBG(color colorFG, color colorBG) {
   return sANSISequence;
 }
 
+/**
+ * Writes the sequence that sets the given colors, without allocating anything.
+ * A negative color is left as it is, so this can set the foreground, the background, or both.
+ * 
+ * @param   { char * }  sOut      Where to write the sequence; this needs room for GRAPHICS_STD_SEQ * 2 chars.
+ * @param   { color }   colorFG   The color of the foreground.
+ * @param   { color }   colorBG   The color of the background.
+ * @return  { int }               The length of the sequence.
+*/
+int Graphics_writeCode(char *sOut, color colorFG, color colorBG) {
+  int dLength = 0;
+
+  if(colorFG >= 0)
+    dLength += snprintf(sOut, GRAPHICS_STD_SEQ, "\x1b[38;2;%d;%d;%dm", 
+      (colorFG >> 16) % (1 << 8), 
+      (colorFG >> 8) % (1 << 8), 
+      (colorFG >> 0) % (1 << 8));
+
+  if(colorBG >= 0)
+    dLength += snprintf(sOut + dLength, GRAPHICS_STD_SEQ, "\x1b[48;2;%d;%d;%dm", 
+      (colorBG >> 16) % (1 << 8), 
+      (colorBG >> 8) % (1 << 8), 
+      (colorBG >> 0) % (1 << 8));
+
+  return dLength;
+}
+
 /**
  * Returns the "pythagorean distance" between two colors.
  * 
@@ -131,13 +190,123 @@ char *Graphics_getCodeFGBG(color colorFG, color colorBG) {
  * @return  { float }           The pythagorean distance between the two colors, with respect to their RGB values.
 */
 float Graphics_getColorDist(color color1, color color2) {
-  return sqrtf(
-    ((color1 >> 16) % (1 << 8) - (color2 >> 16) % (1 << 8)) * 
-    (color1 >> 16) % (1 << 8) - (color2 >> 16) % (1 << 8) + 
-    ((color1 >> 8) % (1 << 8) - (color2 >> 8) % (1 << 8) * 
-    (color1 >> 8) % (1 << 8) - (color2 >> 8) % (1 << 8)) + 
-    ((color1 >> 0) % (1 << 8) - (color2 >> 0) % (1 << 8) * 
-    (color1 >> 0) % (1 << 8) - (color2 >> 0) % (1 << 8)) * 1.0);
+  int r = (color1 >> 16) % (1 << 8) - (color2 >> 16) % (1 << 8);
+  int g = (color1 >> 8) % (1 << 8) - (color2 >> 8) % (1 << 8);
+  int b = (color1 >> 0) % (1 << 8) - (color2 >> 0) % (1 << 8);
+
+  return sqrtf((r * r + g * g + b * b) * 1.0);
+}
+
+/**
+ * Returns the color a palette index stands for.
+ * Indices below 16 are the basic colors, then come the 6x6x6 cube and the 24 grays.
+ * 
+ * @param   { int }     dIndex  The index in the 256-color palette.
+ * @return  { color }           The color of the index.
+*/
+color Graphics_getPaletteColor(int dIndex) {
+  if(dIndex < 16)
+    return GRAPHICS_PALETTE_16[dIndex];
+
+  // The grays at the end
+  if(dIndex >= 232)
+    return Graphics_RGB(8 + (dIndex - 232) * 10, 8 + (dIndex - 232) * 10, 8 + (dIndex - 232) * 10);
+
+  dIndex -= 16;
+
+  return Graphics_RGB(
+    GRAPHICS_CUBE_LEVELS[dIndex / 36], 
+    GRAPHICS_CUBE_LEVELS[dIndex / 6 % 6], 
+    GRAPHICS_CUBE_LEVELS[dIndex % 6]);
+}
+
+/**
+ * Returns the level of the 6x6x6 cube closest to a channel value.
+ * 
+ * @param   { int }   dValue  The value of the channel.
+ * @return  { int }           The level in the cube, from 0 to 5.
+*/
+int Graphics_getCubeLevel(int dValue) {
+  if(dValue < 0x30)
+    return 0;
+
+  if(dValue < 0x73)
+    return 1;
+
+  return (dValue - 0x23) / 0x28;
+}
+
+/**
+ * Returns the index of the color closest to the given one in a palette.
+ * The basic colors are left out of the 256-color palette, since terminals are free to change them.
+ * 
+ * @param   { GraphicsMode }  eMode   Which palette to look in; this can't be GRAPHICS_MODE_TRUECOLOR.
+ * @param   { color }         color   The color to round.
+ * @return  { int }                   The index of the closest color in the palette.
+*/
+int Graphics_getPaletteIndex(GraphicsMode eMode, color color) {
+  int r = (color >> 16) % (1 << 8), g = (color >> 8) % (1 << 8), b = (color >> 0) % (1 << 8);
+  int i, dBest = 0, dCube, dGray;
+  float fDist, fBestDist = 1e9;
+
+  // We only have a few colors to check here
+  if(eMode == GRAPHICS_MODE_16) {
+    for(i = 0; i < 16; i++) {
+      fDist = Graphics_getColorDist(color, GRAPHICS_PALETTE_16[i]);
+
+      if(fDist < fBestDist) {
+        fBestDist = fDist;
+        dBest = i;
+      }
+    }
+
+    return dBest;
+  }
+
+  // Otherwise, it's either the closest corner of the cube or the closest gray
+  dCube = 16 + Graphics_getCubeLevel(r) * 36 + Graphics_getCubeLevel(g) * 6 + Graphics_getCubeLevel(b);
+  dGray = (r + g + b) / 3;
+  dGray = 232 + (dGray < 8 ? 0 : dGray > 238 ? 23 : (dGray - 3) / 10);
+
+  return Graphics_getColorDist(color, Graphics_getPaletteColor(dGray)) < 
+    Graphics_getColorDist(color, Graphics_getPaletteColor(dCube)) ? dGray : dCube;
+}
+
+/**
+ * Writes the sequence that sets the given palette colors, without allocating anything.
+ * A negative index is left as it is, and both colors go in the same sequence.
+ * 
+ * @param   { char * }          sOut    Where to write the sequence; this needs room for GRAPHICS_STD_SEQ chars.
+ * @param   { GraphicsMode }    eMode   Which palette the indices are from; this can't be GRAPHICS_MODE_TRUECOLOR.
+ * @param   { int }             dFG     The index of the foreground color.
+ * @param   { int }             dBG     The index of the background color.
+ * @return  { int }                     The length of the sequence.
+*/
+int Graphics_writePaletteCode(char *sOut, GraphicsMode eMode, int dFG, int dBG) {
+  int dLength = 0;
+
+  if(dFG < 0 && dBG < 0)
+    return 0;
+
+  dLength += sprintf(sOut, "\x1b[");
+
+  if(dFG >= 0)
+    dLength += eMode == GRAPHICS_MODE_16 ?
+      sprintf(sOut + dLength, "%d", dFG < 8 ? 30 + dFG : 90 + dFG - 8) :
+      sprintf(sOut + dLength, "38;5;%d", dFG);
+
+  if(dFG >= 0 && dBG >= 0)
+    sOut[dLength++] = ';';
+
+  if(dBG >= 0)
+    dLength += eMode == GRAPHICS_MODE_16 ?
+      sprintf(sOut + dLength, "%d", dBG < 8 ? 40 + dBG : 100 + dBG - 8) :
+      sprintf(sOut + dLength, "48;5;%d", dBG);
+
+  sOut[dLength++] = 'm';
+  sOut[dLength] = 0;
+
+  return dLength;
 }
 
 /**
@@ -181,4 +350,226 @@ void Graphics_delCode(char *sCode) {
   String_kill(sCode);
 }
 
+/**
+ * //
+ * ////
+ * //////    GraphicsCache struct
+ * ////////
+ * ////////// 
+*/
+
+/**
+ * A color sequence that was already written out.
+ * 
+ * @struct
+*/
+struct GraphicsCode {
+  color colorFG;                        // The colors the code sets (negative if it leaves them alone)
+  color colorBG;
+  int dLength;                          // How long the sequence is; 0 means the slot is empty
+  char sCode[GRAPHICS_STD_SEQ * 2];     // The sequence itself
+};
+
+/**
+ * Keeps the color sequences we've used, so each one is only ever written out once.
+ * The codes are found by their colors, and the slot a code sits in doubles as its id.
+ * 
+ * @struct
+*/
+struct GraphicsCache {
+  GraphicsCode *aCodes;                 // An open-addressed table of the codes
+  int nCodes;                           // How many slots are taken
+
+  GraphicsMode eMode;                   // How the codes send their colors
+  unsigned char *aPalette;              // The palette index of every color, keeping only the top bits of each channel
+};
+
+/**
+ * Initializes the cache.
+ * 
+ * @param   { GraphicsCache * }   this  The cache to initialize.
+*/
+void GraphicsCache_init(GraphicsCache *this) {
+  this->aCodes = calloc(GRAPHICS_CACHE_SIZE, sizeof(*this->aCodes));
+  this->nCodes = 0;
+
+  // The table is only built once we need it
+  this->eMode = GRAPHICS_MODE_TRUECOLOR;
+  this->aPalette = NULL;
+}
+
+/**
+ * Frees the table of the cache.
+ * 
+ * @param   { GraphicsCache * }   this  The cache to clean up.
+*/
+void GraphicsCache_exit(GraphicsCache *this) {
+  free(this->aCodes);
+  free(this->aPalette);
+
+  this->aCodes = NULL;
+  this->nCodes = 0;
+  this->aPalette = NULL;
+}
+
+/**
+ * Forgets all the codes in the cache.
+ * Any ids handed out before this stop meaning anything.
+ * 
+ * @param   { GraphicsCache * }   this  The cache to clear.
+*/
+void GraphicsCache_clear(GraphicsCache *this) {
+  int i;
+
+  for(i = 0; i < GRAPHICS_CACHE_SIZE; i++)
+    this->aCodes[i].dLength = 0;
+
+  this->nCodes = 0;
+}
+
+/**
+ * Clears the cache if it's getting full.
+ * Animations lerp through a lot of colors, so without this the table would fill up eventually.
+ * This should only be called between frames, when nobody is holding on to an id.
+ * 
+ * @param   { GraphicsCache * }   this  The cache to trim.
+*/
+void GraphicsCache_trim(GraphicsCache *this) {
+  if(this->nCodes > GRAPHICS_CACHE_SIZE / 2)
+    GraphicsCache_clear(this);
+}
+
+/**
+ * Changes how the codes send their colors.
+ * The lookup table is built here, so no color ever has to be searched for in the palette while drawing.
+ * Anything already in the cache was written for the old mode, so it's thrown out.
+ * 
+ * @param   { GraphicsCache * }   this    The cache to modify.
+ * @param   { GraphicsMode }      eMode   The new mode.
+*/
+void GraphicsCache_setMode(GraphicsCache *this, GraphicsMode eMode) {
+  int i, dMask = (1 << GRAPHICS_LUT_BITS) - 1, dShift = 8 - GRAPHICS_LUT_BITS;
+  int r, g, b;
+
+  if(eMode == this->eMode)
+    return;
+
+  this->eMode = eMode;
+  GraphicsCache_clear(this);
+
+  if(eMode == GRAPHICS_MODE_TRUECOLOR)
+    return;
+
+  if(this->aPalette == NULL)
+    this->aPalette = calloc(GRAPHICS_LUT_SIZE, sizeof(*this->aPalette));
+
+  // Each entry stands for the middle of the colors that share its bits
+  for(i = 0; i < GRAPHICS_LUT_SIZE; i++) {
+    r = (i >> GRAPHICS_LUT_BITS * 2 & dMask) << dShift | 1 << (dShift - 1);
+    g = (i >> GRAPHICS_LUT_BITS & dMask) << dShift | 1 << (dShift - 1);
+    b = (i & dMask) << dShift | 1 << (dShift - 1);
+
+    this->aPalette[i] = Graphics_getPaletteIndex(eMode, Graphics_RGB(r, g, b));
+  }
+}
+
+/**
+ * Returns the color the terminal will actually show for the given one.
+ * Colors that round to the same thing can then share their contexts and their codes.
+ * 
+ * @param   { GraphicsCache * }   this    The cache to read.
+ * @param   { color }             color   The color to round; this may be negative.
+ * @return  { color }                     The color as it will look on the screen.
+*/
+color GraphicsCache_quantize(GraphicsCache *this, color color) {
+  int dShift = 8 - GRAPHICS_LUT_BITS;
+
+  if(color < 0 || this->eMode == GRAPHICS_MODE_TRUECOLOR)
+    return color;
+
+  return Graphics_getPaletteColor(this->aPalette[
+    ((color >> 16 & 0xff) >> dShift) << GRAPHICS_LUT_BITS * 2 | 
+    ((color >> 8 & 0xff) >> dShift) << GRAPHICS_LUT_BITS | 
+    ((color >> 0 & 0xff) >> dShift)]);
+}
+
+/**
+ * Writes the sequence that sets the given colors in the mode of the cache.
+ * The colors are expected to have gone through GraphicsCache_quantize() already, so they're found exactly.
+ * 
+ * @param   { GraphicsCache * }   this      The cache whose mode we use.
+ * @param   { char * }            sOut      Where to write the sequence; this needs room for GRAPHICS_STD_SEQ * 2 chars.
+ * @param   { color }             colorFG   The color of the foreground; this may be negative.
+ * @param   { color }             colorBG   The color of the background; this may be negative.
+ * @return  { int }                         The length of the sequence.
+*/
+int GraphicsCache_writeCode(GraphicsCache *this, char *sOut, color colorFG, color colorBG) {
+  if(this->eMode == GRAPHICS_MODE_TRUECOLOR)
+    return Graphics_writeCode(sOut, colorFG, colorBG);
+
+  return Graphics_writePaletteCode(sOut, this->eMode, 
+    colorFG < 0 ? -1 : Graphics_getPaletteIndex(this->eMode, colorFG),
+    colorBG < 0 ? -1 : Graphics_getPaletteIndex(this->eMode, colorBG));
+}
+
+/**
+ * Returns the id of the code that sets the given colors, writing it out if it's not in the cache yet.
+ * When the table is too full, nothing is added and GRAPHICS_NO_CODE is returned instead.
+ * 
+ * @param   { GraphicsCache * }   this      The cache to look in.
+ * @param   { color }             colorFG   The color of the foreground; this may be negative.
+ * @param   { color }             colorBG   The color of the background; this may be negative.
+ * @return  { int }                         The id of the code.
+*/
+int GraphicsCache_get(GraphicsCache *this, color colorFG, color colorBG) {
+  GraphicsCode *pCode;
+  unsigned int dSlot;
+
+  // Negative colors all mean the same thing
+  colorFG = colorFG < 0 ? -1 : colorFG;
+  colorBG = colorBG < 0 ? -1 : colorBG;
+
+  // There's nothing to write
+  if(colorFG < 0 && colorBG < 0)
+    return GRAPHICS_NO_CODE;
+
+  dSlot = ((unsigned int) colorFG * 0x9e3779b1u ^ (unsigned int) colorBG * 0x85ebca77u) >> 7;
+
+  // Probe until we find the code or an empty slot
+  while(1) {
+    dSlot &= GRAPHICS_CACHE_SIZE - 1;
+    pCode = &this->aCodes[dSlot];
+
+    if(!pCode->dLength)
+      break;
+
+    if(pCode->colorFG == colorFG && pCode->colorBG == colorBG)
+      return dSlot;
+
+    dSlot++;
+  }
+
+  // Don't let the probes get too long
+  if(this->nCodes >= GRAPHICS_CACHE_SIZE / 4 * 3)
+    return GRAPHICS_NO_CODE;
+
+  pCode->colorFG = colorFG;
+  pCode->colorBG = colorBG;
+  pCode->dLength = GraphicsCache_writeCode(this, pCode->sCode, colorFG, colorBG);
+  this->nCodes++;
+
+  return dSlot;
+}
+
+/**
+ * Returns the code with the given id.
+ * 
+ * @param   { GraphicsCache * }   this  The cache to read.
+ * @param   { int }               dId   The id of the code.
+ * @return  { GraphicsCode * }          The code.
+*/
+GraphicsCode *GraphicsCache_getCode(GraphicsCache *this, int dId) {
+  return &this->aCodes[dId];
+}
+
 #endif
\ No newline at end of file
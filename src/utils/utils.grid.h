@@ -5,6 +5,8 @@
  * @ Description:
  * 
  * A grid class that can help us create blocks of text before printing them.
+ * The grid is stored as a row-strided bitboard: every row occupies dStride 64-bit words,
+ *    and bit x of a row lives in word (x >> 6) at position (x & 63).
  */
 
 #ifndef UTILS_GRID_
@@ -13,8 +15,11 @@
 #include "../utils/utils.types.h"
 
 #include <stdlib.h>
+#include <string.h>
 
-#define GRID_MAX_SIZE 64
+#define GRID_WORD_SIZE 64
+#define GRID_WORD_SHIFT 6
+#define GRID_WORD_MASK (GRID_WORD_SIZE - 1)
 
 typedef struct Grid Grid;
 
@@ -33,10 +38,11 @@ typedef struct Grid Grid;
 struct Grid {
   int dWidth;                         // The width of the grid (in bits).
   int dHeight;                        // The height of the grid (in lines).
+  int dStride;                        // How many words each row of the grid occupies.
 
-  uint64_t dBitArray[GRID_MAX_SIZE];  // A 64 x 64 grid of bits
-                                      // This means that our grid can have a maximum size of 64 x 64,
-                                      //    although the project specifications call for much less.
+  uint64_t *dBitArray;                // A heap-allocated block of dHeight rows, each dStride words long
+                                      // The bits past dWidth on the last word of every row are always kept at 0,
+                                      //    so that whole-word operations (like counting) don't have to mask them out.
 };
 
 /**
@@ -49,26 +55,62 @@ Grid *Grid_new() {
   return pGrid;
 }
 
+/**
+ * Returns how many words a grid of the given size needs.
+ * There's always one spare word at the end, so it's never a zero-sized allocation.
+ * 
+ * @param   { int }       dWidth    The width of the grid.
+ * @param   { int }       dHeight   The height of the grid.
+ * @return  { size_t }              The number of words to allocate.
+*/
+size_t Grid_getWordCount(int dWidth, int dHeight) {
+  dWidth = dWidth > 0 ? dWidth : 0;
+  dHeight = dHeight > 0 ? dHeight : 0;
+
+  return (size_t) ((dWidth + GRID_WORD_MASK) >> GRID_WORD_SHIFT) * dHeight + 1;
+}
+
 /**
  * Initializes an instance of the grid class.
- * If the function receives a width or height that is too large, 32 becomes
- *    the default initialization of that parameter.
+ * Allocates enough words to store dWidth bits for each of the dHeight rows.
+ * Negative dimensions are treated as 0.
  * 
  * @param   { Grid * }  this      A pointer to the instance we're going to init.
- * @param   { Grid * }  dWidth    The width of the bit array we wish to use.
- * @param   { Grid * }  dHeight   The height of the bit array we wish to use.
+ * @param   { int }     dWidth    The width of the bit array we wish to use.
+ * @param   { int }     dHeight   The height of the bit array we wish to use.
  * @return  { Grid * }            The pointer to the initialized instance.
 */
 Grid *Grid_init(Grid *this, int dWidth, int dHeight) {
-  int i;
+
+  // Store the dimensions
+  this->dWidth = dWidth > 0 ? dWidth : 0;
+  this->dHeight = dHeight > 0 ? dHeight : 0;
+
+  // Round the width up to the nearest whole word
+  this->dStride = (this->dWidth + GRID_WORD_MASK) >> GRID_WORD_SHIFT;
 
   // Set all the bit strings to 0
-  for(i = 0; i < GRID_MAX_SIZE; i++)
-    this->dBitArray[i] = 0;
+  this->dBitArray = calloc(Grid_getWordCount(dWidth, dHeight), sizeof(uint64_t));
+
+  return this;
+}
 
-  // If the dimensions are too big, use default
-  this->dWidth = dWidth < GRID_MAX_SIZE ? dWidth : GRID_MAX_SIZE;
-  this->dHeight = dHeight < GRID_MAX_SIZE ? dHeight : GRID_MAX_SIZE;
+/**
+ * Initializes a grid on top of words that something else owns.
+ * The words should already be zeroed, and there should be Grid_getWordCount() of them.
+ * A grid made this way must never be passed to Grid_kill(); its owner frees the words.
+ * 
+ * @param   { Grid * }      this        A pointer to the instance we're going to init.
+ * @param   { int }         dWidth      The width of the bit array we wish to use.
+ * @param   { int }         dHeight     The height of the bit array we wish to use.
+ * @param   { uint64_t * }  pBitArray   The words the grid will use.
+ * @return  { Grid * }                  The pointer to the initialized instance.
+*/
+Grid *Grid_wrap(Grid *this, int dWidth, int dHeight, uint64_t *pBitArray) {
+  this->dWidth = dWidth > 0 ? dWidth : 0;
+  this->dHeight = dHeight > 0 ? dHeight : 0;
+  this->dStride = (this->dWidth + GRID_WORD_MASK) >> GRID_WORD_SHIFT;
+  this->dBitArray = pBitArray;
 
   return this;
 }
@@ -77,8 +119,8 @@ Grid *Grid_init(Grid *this, int dWidth, int dHeight) {
  * Creates an initialized instance of the grid class.
  * Sets its current length to 0.
  * 
- * @param   { Grid * }  dWidth    The width of each of the grid lines.
- * @param   { Grid * }  dHeight   The height of the grid.
+ * @param   { int }     dWidth    The width of each of the grid lines.
+ * @param   { int }     dHeight   The height of the grid.
  * @return  { Grid * }            The pointer to the initialized instance.
 */
 Grid *Grid_create(int dWidth, int dHeight) {
@@ -91,9 +133,76 @@ Grid *Grid_create(int dWidth, int dHeight) {
  * @param   { Grid * }  this  The instance to be freed from memory.
 */
 void Grid_kill(Grid *this) {
+  free(this->dBitArray);
   free(this);
 }
 
+/**
+ * Returns a pointer to the first word of a row.
+ * This function assumes that y is within range of the dimensions of the grid.
+ * 
+ * @param   { Grid * }      this  The grid instance we wish to read.
+ * @param   { int }         y     The row we want.
+ * @return  { uint64_t * }        A pointer to the dStride words of that row.
+*/
+uint64_t *Grid_getRow(Grid *this, int y) {
+  return this->dBitArray + (size_t) y * this->dStride;
+}
+
+/**
+ * Returns the mask of the bits that are actually in use on the last word of each row.
+ * 
+ * @param   { Grid * }    this  The grid instance we wish to read.
+ * @return  { uint64_t }        The mask of the valid bits of the final word in a row.
+*/
+uint64_t Grid_getTailMask(Grid *this) {
+  int dTail = this->dWidth & GRID_WORD_MASK;
+
+  return dTail ? (1ULL << dTail) - 1 : ~0ULL;
+}
+
+/**
+ * Returns a word of a row shifted so that bit x holds the value of cell (x - 1).
+ * In other words, every bit sees its western neighbour; bits carry over from the previous word.
+ * This function assumes that y and w are within range of the dimensions of the grid.
+ * 
+ * @param   { Grid * }    this  The grid instance we wish to read.
+ * @param   { int }       y     The row of the word.
+ * @param   { int }       w     The index of the word within the row.
+ * @return  { uint64_t }        The shifted word.
+*/
+uint64_t Grid_getWordWest(Grid *this, int y, int w) {
+  uint64_t *pRow = Grid_getRow(this, y);
+
+  return (pRow[w] << 1) | (w > 0 ? pRow[w - 1] >> GRID_WORD_MASK : 0);
+}
+
+/**
+ * Returns a word of a row shifted so that bit x holds the value of cell (x + 1).
+ * In other words, every bit sees its eastern neighbour; bits carry over from the next word.
+ * Since the padding bits are 0, the last cell of a row never sees anything to its east.
+ * 
+ * @param   { Grid * }    this  The grid instance we wish to read.
+ * @param   { int }       y     The row of the word.
+ * @param   { int }       w     The index of the word within the row.
+ * @return  { uint64_t }        The shifted word.
+*/
+uint64_t Grid_getWordEast(Grid *this, int y, int w) {
+  uint64_t *pRow = Grid_getRow(this, y);
+
+  return (pRow[w] >> 1) | (w + 1 < this->dStride ? pRow[w + 1] << GRID_WORD_MASK : 0);
+}
+
+/**
+ * Copies the contents of another grid onto this one.
+ * Both grids are assumed to have the same dimensions.
+ * 
+ * @param   { Grid * }  this      The grid to overwrite.
+ * @param   { Grid * }  pSource   The grid to copy from.
+*/
+void Grid_copy(Grid *this, Grid *pSource) {
+  memcpy(this->dBitArray, pSource->dBitArray, (size_t) this->dStride * this->dHeight * sizeof(*this->dBitArray));
+}
 
 /**
  * Returns the value at an entry on the grid.
@@ -105,9 +214,7 @@ void Grid_kill(Grid *this) {
  * @return  { int }           Whether or not the bit is a 1 or 0.
 */
 int Grid_getBit(Grid *this, int x, int y) {
-  uint64_t dMask = 1ULL << (GRID_MAX_SIZE - 1);
-
-  return (this->dBitArray[y] & dMask >> x) ? 1 : 0;
+  return (Grid_getRow(this, y)[x >> GRID_WORD_SHIFT] >> (x & GRID_WORD_MASK)) & 1;
 }
 
 /**
@@ -119,10 +226,11 @@ int Grid_getBit(Grid *this, int x, int y) {
  * @param   { int }     n     The new value we want to set the bit to.
 */
 void Grid_setBit(Grid *this, int x, int y, int n) {
-  uint64_t dMask = 1ULL << (GRID_MAX_SIZE - 1);
+  uint64_t *pWord = Grid_getRow(this, y) + (x >> GRID_WORD_SHIFT);
+  uint64_t dMask = 1ULL << (x & GRID_WORD_MASK);
 
-  if(n) this->dBitArray[y] |= dMask >> x;     // If we're making the bit truthy, we need an |=
-  else this->dBitArray[y] &= ~(dMask >> x);   // Otherwise, an &= with the inverse of the mask works
+  if(n) *pWord |= dMask;     // If we're making the bit truthy, we need an |=
+  else *pWord &= ~dMask;     // Otherwise, an &= with the inverse of the mask works
 }
 
 /**
@@ -132,28 +240,252 @@ void Grid_setBit(Grid *this, int x, int y, int n) {
  * @param   { int }     n     Whether or not to set all bits to 1 or 0.
 */
 void Grid_clear(Grid *this, int n) {
-  int i;
+  int y;
+  uint64_t dTailMask;
 
   // Set them all back to 0
-  for(i = 0; i < this->dHeight; i++)
-    this->dBitArray[i] = n ? -1 : 0;
+  if(!n) {
+    memset(this->dBitArray, 0, (size_t) this->dStride * this->dHeight * sizeof(uint64_t));
+    return;
+  }
+
+  // Otherwise, fill every word then trim the padding at the end of each row
+  memset(this->dBitArray, 0xff, (size_t) this->dStride * this->dHeight * sizeof(uint64_t));
+  dTailMask = Grid_getTailMask(this);
+
+  for(y = 0; y < this->dHeight && this->dStride; y++)
+    Grid_getRow(this, y)[this->dStride - 1] &= dTailMask;
 }
 
 /**
  * Returns how many bits are turned on.
+ * Since the padding bits are always 0, we can just count word by word.
  * 
  * @param   { Grid * }  this  The grid instance we wish to read.
  * @return  { int }           How many bits have a 1 value.
 */
 int Grid_getCount(Grid *this) {
-  int i, j, dCount = 0;
+  size_t i, dWords = (size_t) this->dStride * this->dHeight;
+  int dCount = 0;
 
-  for(i = 0; i < this->dWidth; i++)
-    for(j = 0; j < this->dHeight; j++)
-      if(Grid_getBit(this, i, j))
-        dCount++;
+  for(i = 0; i < dWords; i++)
+    dCount += __builtin_popcountll(this->dBitArray[i]);
 
   return dCount;
 }
 
+/**
+ * Grows the set bits of a row through the runs of set bits they sit on within another grid.
+ * Think of it as a one-dimensional flood fill: every run of pBounds that touches a set bit becomes set.
+ * Each word is filled with a few shift-and-mask steps (a Kogge-Stone fill), once towards the east 
+ *    and once towards the west, with the edge bit carried over into the next word.
+ * Both grids are assumed to have the same dimensions, and the row is assumed to lie within pBounds.
+ * 
+ * @param   { Grid * }  this      The grid whose row we want to grow.
+ * @param   { Grid * }  pBounds   The grid whose runs limit the growth.
+ * @param   { int }     y         The row to grow.
+ * @return  { int }               Whether or not the row changed.
+*/
+int Grid_fillRow(Grid *this, Grid *pBounds, int y) {
+  int w, dShift, bChanged = 0;
+  uint64_t dFill, dProp, dCarry;
+  uint64_t *pRow = Grid_getRow(this, y);
+  uint64_t *pBoundsRow = Grid_getRow(pBounds, y);
+
+  // Fill towards higher bits (east), carrying the top bit into the next word
+  for(w = 0, dCarry = 0; w < this->dStride; w++) {
+    dProp = pBoundsRow[w];
+    dFill = (pRow[w] | dCarry) & dProp;
+
+    for(dShift = 1; dShift < GRID_WORD_SIZE; dShift <<= 1) {
+      dFill |= dProp & (dFill << dShift);
+      dProp &= dProp << dShift;
+    }
+
+    bChanged |= dFill != pRow[w];
+    pRow[w] = dFill;
+    dCarry = dFill >> GRID_WORD_MASK;
+  }
+
+  // Fill towards lower bits (west), carrying the bottom bit into the previous word
+  for(w = this->dStride - 1, dCarry = 0; w >= 0; w--) {
+    dProp = pBoundsRow[w];
+    dFill = (pRow[w] | (dCarry << GRID_WORD_MASK)) & dProp;
+
+    for(dShift = 1; dShift < GRID_WORD_SIZE; dShift <<= 1) {
+      dFill |= dProp & (dFill >> dShift);
+      dProp &= dProp >> dShift;
+    }
+
+    bChanged |= dFill != pRow[w];
+    pRow[w] = dFill;
+    dCarry = dFill & 1;
+  }
+
+  return bChanged;
+}
+
+/**
+ * Sets every bit within a rectangle to 0 or 1.
+ * Each row is done a word at a time; the parts of the rectangle outside the grid are ignored.
+ * 
+ * @param   { Grid * }  this      The grid instance we wish to modify.
+ * @param   { int }     x         The x-coordinate of the top-left corner of the rectangle.
+ * @param   { int }     y         The y-coordinate of the top-left corner of the rectangle.
+ * @param   { int }     dWidth    The width of the rectangle.
+ * @param   { int }     dHeight   The height of the rectangle.
+ * @param   { int }     n         Whether to set the bits to 1 or 0.
+*/
+void Grid_setRect(Grid *this, int x, int y, int dWidth, int dHeight, int n) {
+  int j, w, dFirst, dLast;
+  uint64_t dMask, *pRow;
+
+  // Clip the rectangle to the grid
+  if(x < 0) dWidth += x, x = 0;
+  if(y < 0) dHeight += y, y = 0;
+  if(x + dWidth > this->dWidth) dWidth = this->dWidth - x;
+  if(y + dHeight > this->dHeight) dHeight = this->dHeight - y;
+
+  if(dWidth <= 0 || dHeight <= 0)
+    return;
+
+  // The words where the rectangle starts and ends
+  dFirst = x >> GRID_WORD_SHIFT;
+  dLast = (x + dWidth - 1) >> GRID_WORD_SHIFT;
+
+  for(j = y; j < y + dHeight; j++) {
+    pRow = Grid_getRow(this, j);
+
+    for(w = dFirst; w <= dLast; w++) {
+      dMask = ~0ULL;
+
+      // Trim the ends of the run
+      if(w == dFirst) dMask &= ~0ULL << (x & GRID_WORD_MASK);
+      if(w == dLast) dMask &= ~0ULL >> (GRID_WORD_MASK - ((x + dWidth - 1) & GRID_WORD_MASK));
+
+      if(n) pRow[w] |= dMask;
+      else pRow[w] &= ~dMask;
+    }
+  }
+}
+
+/**
+ * Reverses the order of the bits in a word.
+ * The bytes get swapped first, then the bits within each byte.
+ * 
+ * @param   { uint64_t }  dWord   The word to reverse.
+ * @return  { uint64_t }          The reversed word.
+*/
+uint64_t Grid_reverseWord(uint64_t dWord) {
+  dWord = __builtin_bswap64(dWord);
+  dWord = ((dWord >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((dWord & 0x0f0f0f0f0f0f0f0fULL) << 4);
+  dWord = ((dWord >> 2) & 0x3333333333333333ULL) | ((dWord & 0x3333333333333333ULL) << 2);
+  dWord = ((dWord >> 1) & 0x5555555555555555ULL) | ((dWord & 0x5555555555555555ULL) << 1);
+
+  return dWord;
+}
+
+/**
+ * Mirrors the grid from left to right.
+ * Every row is reversed as one long string of words, then shifted back over the padding.
+ * 
+ * @param   { Grid * }  this  The grid instance we wish to modify.
+*/
+void Grid_mirror(Grid *this) {
+  int y, w, dPad = this->dStride * GRID_WORD_SIZE - this->dWidth;
+  uint64_t dWord, *pRow;
+
+  for(y = 0; y < this->dHeight; y++) {
+    pRow = Grid_getRow(this, y);
+
+    // Reverse the order of the words, and the bits within each of them
+    for(w = 0; w < (this->dStride + 1) / 2; w++) {
+      dWord = Grid_reverseWord(pRow[w]);
+      pRow[w] = Grid_reverseWord(pRow[this->dStride - 1 - w]);
+      pRow[this->dStride - 1 - w] = dWord;
+    }
+
+    // The padding ended up at the start of the row, so everything is dPad bits too far east
+    if(dPad) 
+      for(w = 0; w < this->dStride; w++)
+        pRow[w] = (pRow[w] >> dPad) | 
+          (w + 1 < this->dStride ? pRow[w + 1] << (GRID_WORD_SIZE - dPad) : 0);
+  }
+}
+
+/**
+ * Flips the grid upside down by swapping its rows.
+ * 
+ * @param   { Grid * }  this  The grid instance we wish to modify.
+*/
+void Grid_flip(Grid *this) {
+  int y, w;
+  uint64_t dWord, *pTop, *pBottom;
+
+  for(y = 0; y < this->dHeight / 2; y++) {
+    pTop = Grid_getRow(this, y);
+    pBottom = Grid_getRow(this, this->dHeight - 1 - y);
+
+    for(w = 0; w < this->dStride; w++) {
+      dWord = pTop[w];
+      pTop[w] = pBottom[w];
+      pBottom[w] = dWord;
+    }
+  }
+}
+
+/**
+ * Transposes a 64x64 block of bits in place, so bit x of aRows[y] ends up as bit y of aRows[x].
+ * The block is split into quadrants and the off-diagonal ones are swapped, then again within 
+ *    each quadrant, down to single bits; that's 6 passes over the 64 words.
+ * 
+ * @param   { uint64_t[] }  aRows   The 64 rows of the block.
+*/
+void Grid_transposeBlock(uint64_t aRows[GRID_WORD_SIZE]) {
+  int j, k;
+  uint64_t t, m = 0x00000000ffffffffULL;
+
+  for(j = GRID_WORD_SIZE / 2; j; j >>= 1, m ^= m << j) {
+    for(k = 0; k < GRID_WORD_SIZE; k = ((k | j) + 1) & ~j) {
+      t = ((aRows[k] >> j) ^ aRows[k | j]) & m;
+      aRows[k | j] ^= t;
+      aRows[k] ^= t << j;
+    }
+  }
+}
+
+/**
+ * Writes the transpose of a grid onto this one, so (x, y) of the source ends up at (y, x).
+ * This grid should be as wide as the source is tall, and as tall as the source is wide.
+ * The work is done on 64x64 blocks, one word from each of 64 rows at a time.
+ * 
+ * @param   { Grid * }  this      The grid to overwrite.
+ * @param   { Grid * }  pSource   The grid to transpose.
+*/
+void Grid_transpose(Grid *this, Grid *pSource) {
+  int i, dBlockX, dBlockY, y;
+  uint64_t aRows[GRID_WORD_SIZE];
+
+  for(dBlockY = 0; dBlockY < this->dStride; dBlockY++) {
+    for(dBlockX = 0; dBlockX < pSource->dStride; dBlockX++) {
+
+      // Rows past the bottom of the source are empty
+      for(i = 0; i < GRID_WORD_SIZE; i++) {
+        y = (dBlockY << GRID_WORD_SHIFT) + i;
+        aRows[i] = y < pSource->dHeight ? Grid_getRow(pSource, y)[dBlockX] : 0;
+      }
+
+      Grid_transposeBlock(aRows);
+
+      // The columns past the edge of the source are just padding
+      for(i = 0; i < GRID_WORD_SIZE; i++) {
+        y = (dBlockX << GRID_WORD_SHIFT) + i;
+
+        if(y < this->dHeight)
+          Grid_getRow(this, y)[dBlockY] = aRows[i];
+      }
+    }
+  }
+}
+
 #endif
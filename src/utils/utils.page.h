@@ -18,6 +18,8 @@
 #include "./utils.asset.h"
 #include "./utils.types.h"
 
+#include <time.h>
+
 // This is used as a parameter to "setComponentTarget()"
 // It signifies that an int value will not be modified
 #define PAGE_NULL_INT -999
@@ -28,7 +30,15 @@
 #define PAGE_MAX_COUNT (1 << 4)
 #define PAGE_MAX_NAME_LEN (1 << 8)
 
+// The longest a page sleeps when it isn't waiting on anything but input (in ms)
+#define PAGE_MAX_SLEEP 1000
+
+// How many frames in a row have to leave the screen as it was before a page stops drawing
+// Handlers sometimes only react to a key on the frame after it's read, so one isn't enough
+#define PAGE_SETTLE_FRAMES 2
+
 typedef enum PageStatus PageStatus;
+typedef enum PageRefresh PageRefresh;
 
 typedef struct Page Page;
 typedef struct PageManager PageManager;
@@ -40,6 +50,12 @@ enum PageStatus {
   PAGE_INACTIVE,          // The page is currently just residing in memory
 };
 
+enum PageRefresh {
+  PAGE_REFRESH_INPUT,     // The page only changes when a key is pressed
+  PAGE_REFRESH_SECOND,    // The page shows a clock, so it has to be drawn again every second
+  PAGE_REFRESH_FRAME,     // The page is animating, so it has to be drawn every frame
+};
+
 /**
  * //
  * ////
@@ -62,6 +78,7 @@ struct Page {
   AssetManager *pSharedAssetManager;                            // A reference to a shared asset manager so we can access all assets
   EventStore *pSharedEventStore;                                // Where we can access values modified by events
   ThemeManager *pSharedThemeManager;                            // What we use to manager the colors across pages
+  Buffer *pSharedScreen;                                        // What's currently on the screen, so we only print what changed
   p_obj pSharedObject;                                          // Can refer to any piece of shared state the page might need
                                                                 // We use this primarily for the game objects
                     
@@ -72,6 +89,10 @@ struct Page {
                     
   unsigned long long dT;                                        // A variable that stores the current frame number
   unsigned int dStage;                                          // An int that tells us what stage anims are in
+
+  PageRefresh eRefresh;                                         // When the page needs to be drawn again, aside from key presses
+  int dQuietFrames;                                             // How many frames in a row left the screen as it was
+  time_t lastFrameTime;                                         // The second the last frame was drawn in
 };
 
 /**
@@ -102,6 +123,9 @@ Page *Page_init(Page *this, AssetManager *pSharedAssetManager, EventStore *pShar
 
   // Init the component tree and other stuff
   ComponentManager_init(&this->componentManager);
+
+  // The buffer we render to every frame; it only gets cleared between frames
+  this->pBuffer = Buffer_create(0, 0, 0x000000, 0x000000);
   
   // Currently none
   this->sNextName = NULL;
@@ -110,8 +134,12 @@ Page *Page_init(Page *this, AssetManager *pSharedAssetManager, EventStore *pShar
   this->pSharedAssetManager = pSharedAssetManager;
   this->pSharedEventStore = pSharedEventStore;
   this->pSharedThemeManager = pSharedThemeManager;
+  this->pSharedScreen = NULL;
   this->pSharedObject = NULL;
 
+  // The color sequences of the page live with the theme
+  Buffer_setCodeCache(this->pBuffer, &pSharedThemeManager->codeCache);
+
   // Empty hashmaps
   this->pUserStates = HashMap_create();
   
@@ -119,6 +147,11 @@ Page *Page_init(Page *this, AssetManager *pSharedAssetManager, EventStore *pShar
   this->dT = 0ULL;
   this->dStage = 0;
 
+  // Nothing has been drawn yet
+  this->eRefresh = PAGE_REFRESH_INPUT;
+  this->dQuietFrames = 0;
+  this->lastFrameTime = 0;
+
   return this;
 }
 
@@ -152,7 +185,10 @@ void Page_kill(Page *this) {
  * @param   { Page * }  this  The page to render.
 */
 void Page_render(Page *this) {
-  ComponentManager_render(&this->componentManager, this->pBuffer);
+  ComponentManager_render(&this->componentManager, this->pBuffer, this->pSharedScreen);
+
+  // Once the frames stop changing anything, the next ones won't either until something happens
+  this->dQuietFrames = this->componentManager.bHasChanged ? 0 : this->dQuietFrames + 1;
 }
 
 /**
@@ -212,10 +248,12 @@ int Page_update(Page *this) {
     
   // Increment time state
   this->dT++;
+  this->lastFrameTime = time(NULL);
 
   // The page is currently initializing
   if(this->ePageStatus == PAGE_ACTIVE_INIT) {
     this->ePageStatus = PAGE_ACTIVE_RUNNING;
+    this->dQuietFrames = 0;
 
     // We return 0 because we don't want to render until after initting
     return 0;
@@ -237,22 +275,29 @@ int Page_update(Page *this) {
  * @param   { char ** }               aAsset        The asset to be rendered by the component. This may be NULL.
  * @param   { char * }                sColorFGKey   A color key for the foreground from the theme manager.
  * @param   { char * }                sColorBGKey   A color key for the background from the theme manager.
+ * @return  { int }                                 The handle of the component, or COMPONENT_NO_HANDLE if it wasn't added.
 */
-void Page_addComponent(Page *this, char *sKey, char *sParentKey, int x, int y, int w, int h, int dAssetHeight, char **aAsset, char *sColorFGKey, char *sColorBGKey) {
+int Page_addComponent(Page *this, char *sKey, char *sParentKey, int x, int y, int w, int h, int dAssetHeight, char **aAsset, char *sColorFGKey, char *sColorBGKey) {
 
   // The colors we want from the theme  
   color colorFG = ThemeManager_getActive(this->pSharedThemeManager, sColorFGKey);
   color colorBG = ThemeManager_getActive(this->pSharedThemeManager, sColorBGKey);
 
+  int dHandle;
+
   // Not too many components
   if(this->dComponentCount >= PAGE_MAX_COMPONENTS)
-    return;
+    return COMPONENT_NO_HANDLE;
 
   // Add a component; exit if not successful
-  if(!ComponentManager_add(&this->componentManager, sKey, sParentKey, x, y, w, h, dAssetHeight, aAsset, colorFG, colorBG))
-    return;
+  dHandle = ComponentManager_add(&this->componentManager, sKey, sParentKey, x, y, w, h, dAssetHeight, aAsset, colorFG, colorBG);
+
+  if(dHandle == COMPONENT_NO_HANDLE)
+    return COMPONENT_NO_HANDLE;
 
   this->dComponentCount++;
+
+  return dHandle;
 }
 
 /**
@@ -267,9 +312,10 @@ void Page_addComponent(Page *this, char *sKey, char *sParentKey, int x, int y, i
  * @param   { char * }                sColorFGKey   A color key for the foreground from the theme manager.
  * @param   { char * }                sColorBGKey   A color key for the background from the theme manager.
  * @param   { char * }                sAssetKey     The asset to be rendered by the component.
+ * @return  { int }                                 The handle of the component, or COMPONENT_NO_HANDLE if it wasn't added.
 */
-void Page_addComponentAsset(Page *this, char *sKey, char *sParentKey, int x, int y, char *sColorFGKey, char *sColorBGKey, char *sAssetKey) {
-  Page_addComponent(this, sKey, sParentKey, x, y, 
+int Page_addComponentAsset(Page *this, char *sKey, char *sParentKey, int x, int y, char *sColorFGKey, char *sColorBGKey, char *sAssetKey) {
+  return Page_addComponent(this, sKey, sParentKey, x, y, 
     AssetManager_getAssetWidth(this->pSharedAssetManager, sAssetKey),
     AssetManager_getAssetHeight(this->pSharedAssetManager, sAssetKey),
     AssetManager_getAssetHeight(this->pSharedAssetManager, sAssetKey),
@@ -289,8 +335,9 @@ void Page_addComponentAsset(Page *this, char *sKey, char *sParentKey, int x, int
  * @param   { char * }                sColorBGKey   A color key for the background from the theme manager.
  * @param   { int }                   dWrapLength   How wide the text block can be. If 0, then 256 is the default width.
  * @param   { char * }                sText         The text we want to add to the page.
+ * @return  { int }                                 The handle of the component, or COMPONENT_NO_HANDLE if it wasn't added.
 */
-void Page_addComponentText(Page *this, char *sKey, char *sParentKey, int x, int y, char *sColorFGKey, char *sColorBGKey, char *sText) {
+int Page_addComponentText(Page *this, char *sKey, char *sParentKey, int x, int y, char *sColorFGKey, char *sColorBGKey, char *sText) {
   int dChar = 0, dLines = 0, dLineLength = 1024; 
   char **aAsset = calloc(256, sizeof(*aAsset));
 
@@ -315,7 +362,7 @@ void Page_addComponentText(Page *this, char *sKey, char *sParentKey, int x, int
     sText++;
   }
   
-  Page_addComponent(this, sKey, sParentKey, x, y, 
+  return Page_addComponent(this, sKey, sParentKey, x, y, 
     String_charCount(aAsset[0]), dLines + 1, dLines + 1, aAsset, sColorFGKey, sColorBGKey);
 }
 
@@ -329,9 +376,10 @@ void Page_addComponentText(Page *this, char *sKey, char *sParentKey, int x, int
  * @param   { char * }                sParentKey    The key of the component to append to.
  * @param   { int }                   x             The x-coordinate of the component.
  * @param   { int }                   y             The y-coordinate of the component.
+ * @return  { int }                                 The handle of the component, or COMPONENT_NO_HANDLE if it wasn't added.
 */
-void Page_addComponentContainer(Page *this, char *sKey, char *sParentKey, int x, int y) {
-  Page_addComponent(this, sKey, sParentKey, x, y, 0, 0, 0, NULL, "", "");
+int Page_addComponentContainer(Page *this, char *sKey, char *sParentKey, int x, int y) {
+  return Page_addComponent(this, sKey, sParentKey, x, y, 0, 0, 0, NULL, "", "");
 }
 
 /**
@@ -348,9 +396,37 @@ void Page_addComponentContainer(Page *this, char *sKey, char *sParentKey, int x,
  * @param   { int }                   h             The height of the component.
  * @param   { char * }                sColorFGKey   A color key for the foreground from the theme manager.
  * @param   { char * }                sColorBGKey   A color key for the background from the theme manager.
+ * @return  { int }                                 The handle of the component, or COMPONENT_NO_HANDLE if it wasn't added.
+*/
+int Page_addComponentContext(Page *this, char *sKey, char *sParentKey, int x, int y, int w, int h, char *sColorFGKey, char *sColorBGKey) {
+  return Page_addComponent(this, sKey, sParentKey, x, y, w, h, 0, NULL, sColorFGKey, sColorBGKey);
+}
+
+/**
+ * Adds a tilemap, which draws a grid of tiles without making a component for each one.
+ * Its size is worked out from the tiles, so it's best anchored to its top left corner.
+ * 
+ * @param   { Page * }                this            The page to modify.
+ * @param   { char * }                sKey            An identifier for the component.
+ * @param   { char * }                sParentKey      The key of the component to append to.
+ * @param   { int }                   x               The x-coordinate of the component.
+ * @param   { int }                   y               The y-coordinate of the component.
+ * @param   { char * }                sColorFGKey     A color key for the foreground from the theme manager.
+ * @param   { char * }                sColorBGKey     A color key for the background from the theme manager.
+ * @param   { f_tilemap_handler }     fHandler        Draws the tiles that can be seen each frame.
+ * @param   { p_obj }                 pTilemapObject  What the tiles are drawn from; this is passed to the handler.
+ * @param   { int }                   dTileW          The width of a single tile.
+ * @param   { int }                   dTileH          The height of a single tile.
+ * @param   { int }                   dTileCountX     How many tiles there are along a row.
+ * @param   { int }                   dTileCountY     How many tiles there are along a column.
+ * @return  { int }                                   The handle of the component, or COMPONENT_NO_HANDLE if it wasn't added.
 */
-void Page_addComponentContext(Page *this, char *sKey, char *sParentKey, int x, int y, int w, int h, char *sColorFGKey, char *sColorBGKey) {
-  Page_addComponent(this, sKey, sParentKey, x, y, w, h, 0, NULL, sColorFGKey, sColorBGKey);
+int Page_addComponentTilemap(Page *this, char *sKey, char *sParentKey, int x, int y, char *sColorFGKey, char *sColorBGKey, f_tilemap_handler fHandler, p_obj pTilemapObject, int dTileW, int dTileH, int dTileCountX, int dTileCountY) {
+  int dHandle = Page_addComponent(this, sKey, sParentKey, x, y, 0, 0, 0, NULL, sColorFGKey, sColorBGKey);
+
+  ComponentManager_setTilemapByHandle(&this->componentManager, dHandle, fHandler, pTilemapObject, dTileW, dTileH, dTileCountX, dTileCountY);
+
+  return dHandle;
 }
 
 /**
@@ -369,9 +445,10 @@ void Page_addComponentContext(Page *this, char *sKey, char *sParentKey, int x, i
  * @param   { char * }                sBodyText     The message of the popup.
  * @param   { char * }                sOption1      The first option; required.
  * @param   { char * }                sOption2      The second option; may be empty.
+ * @return  { int }                                 The handle of the popup container, or COMPONENT_NO_HANDLE if it wasn't added.
 */
-void Page_addComponentPopup(Page *this, char *sKey, int x, int y, int w, int h, char *sColorFGKey, char *sColorBGKey, char *sBodyText, char *sOption1, char *sOption2) {
-  int i;
+int Page_addComponentPopup(Page *this, char *sKey, int x, int y, int w, int h, char *sColorFGKey, char *sColorBGKey, char *sBodyText, char *sOption1, char *sOption2) {
+  int i, dHandle;
 
   // Holds the component keys
   char sPopupComponent[STRING_KEY_MAX_LENGTH];
@@ -396,7 +473,7 @@ void Page_addComponentPopup(Page *this, char *sKey, int x, int y, int w, int h,
   sprintf(sPopupButtonCountKey, "popup-button-count-%s", sKey);
 
   // Create the popup and its background
-  Page_addComponentContainer(this, sPopupComponent, "root", x, y);
+  dHandle = Page_addComponentContainer(this, sPopupComponent, "root", x, y);
 
   for(i = 0; i < h; i++) {
     sPopupBGText = String_repeat(" ", w + 2);
@@ -431,6 +508,33 @@ void Page_addComponentPopup(Page *this, char *sKey, int x, int y, int w, int h,
   if(Page_getUserState(this, sPopupButtonCurrentKey) == -1) Page_setUserState(this, sPopupButtonCurrentKey, 0);
   if(Page_getUserState(this, sPopupButtonCountKey) == -1) Page_setUserState(this, sPopupButtonCountKey, strlen(sOption2) ? 2 : 1);
   Page_setUserState(this, "is-popup", 0);
+
+  return dHandle;
+}
+
+/**
+ * Returns the handle of a component.
+ * Handles let us modify components without looking up their keys, which helps when there are a lot of them.
+ * Components added one after the other have consecutive handles.
+ * 
+ * @param   { Page * }  this          The page to read.
+ * @param   { char * }  sKey          An identifier for the component.
+ * @return  { int }                   The handle of the component, or COMPONENT_NO_HANDLE if it doesn't exist.
+*/
+int Page_getComponentHandle(Page *this, char *sKey) {
+  return ComponentManager_getHandle(&this->componentManager, sKey);
+}
+
+/**
+ * Changes the position of the component with the given handle.
+ * 
+ * @param   { Page * }  this          The page we want to modify.
+ * @param   { int }     dHandle       The handle of the component we want to modify.
+ * @param   { int }     x             The x-coordinate of the component.
+ * @param   { int }     y             The y-coordinate of the component.
+*/
+void Page_setComponentPosByHandle(Page *this, int dHandle, int x, int y) {
+  ComponentManager_setPosByHandle(&this->componentManager, dHandle, x, y);
 }
 
 /**
@@ -445,6 +549,18 @@ void Page_setComponentPos(Page *this, char *sKey, int x, int y) {
   ComponentManager_setPos(&this->componentManager, sKey, x, y);
 }
 
+/**
+ * Changes the size of the component with the given handle.
+ * 
+ * @param   { Page * }  this          The page we want to modify.
+ * @param   { int }     dHandle       The handle of the component we want to modify.
+ * @param   { int }     w             The width of the component.
+ * @param   { int }     h             The height of the component.
+*/
+void Page_setComponentSizeByHandle(Page *this, int dHandle, int w, int h) {
+  ComponentManager_setSizeByHandle(&this->componentManager, dHandle, w, h);
+}
+
 /**
  * Changes the size of the component.
  * 
@@ -458,36 +574,77 @@ void Page_setComponentSize(Page *this, char *sKey, int w, int h) {
 }
 
 /**
- * Changes the color of a component.
+ * Changes the color of the component with the given handle.
  * 
  * @param   { Page * }  this          The page we want to modify.
- * @param   { char * }  sKey          An identifier for the component we want to modify.
+ * @param   { int }     dHandle       The handle of the component we want to modify.
  * @param   { char * }  sColorFGKey   The foreground color of the component, based on theme.
  * @param   { char * }  sColorBGKey   The background color of the component, based on theme.
 */
-void Page_setComponentColor(Page *this, char *sKey, char *sColorFGKey, char *sColorBGKey) {
+void Page_setComponentColorByHandle(Page *this, int dHandle, char *sColorFGKey, char *sColorBGKey) {
 
   // The colors we want from the theme
   color colorFG = ThemeManager_getActive(this->pSharedThemeManager, sColorFGKey);
   color colorBG = ThemeManager_getActive(this->pSharedThemeManager, sColorBGKey);
 
-  ComponentManager_setColor(&this->componentManager, sKey, 
+  ComponentManager_setColorByHandle(&this->componentManager, dHandle, 
     colorFG < 0 ? COMPONENT_NO_CHANGE : colorFG, 
     colorBG < 0 ? COMPONENT_NO_CHANGE : colorBG);
 }
 
 /**
- * Changes the text stored by a component.
+ * Changes the color of a component.
  * 
  * @param   { Page * }  this          The page we want to modify.
  * @param   { char * }  sKey          An identifier for the component we want to modify.
  * @param   { char * }  sColorFGKey   The foreground color of the component, based on theme.
  * @param   { char * }  sColorBGKey   The background color of the component, based on theme.
 */
-void Page_setComponentText(Page *this, char *sKey, char *sText) {
+void Page_setComponentColor(Page *this, char *sKey, char *sColorFGKey, char *sColorBGKey) {
+  Page_setComponentColorByHandle(this, Page_getComponentHandle(this, sKey), sColorFGKey, sColorBGKey);
+}
+
+/**
+ * Hides or shows the component with the given handle, along with everything inside it.
+ * 
+ * @param   { Page * }  this          The page we want to modify.
+ * @param   { int }     dHandle       The handle of the component we want to modify.
+ * @param   { int }     bIsHidden     Whether or not the component should be hidden.
+*/
+void Page_setComponentHiddenByHandle(Page *this, int dHandle, int bIsHidden) {
+  ComponentManager_setHiddenByHandle(&this->componentManager, dHandle, bIsHidden);
+}
+
+/**
+ * Hides or shows a component, along with everything inside it.
+ * 
+ * @param   { Page * }  this          The page we want to modify.
+ * @param   { char * }  sKey          An identifier for the component we want to modify.
+ * @param   { int }     bIsHidden     Whether or not the component should be hidden.
+*/
+void Page_setComponentHidden(Page *this, char *sKey, int bIsHidden) {
+  ComponentManager_setHidden(&this->componentManager, sKey, bIsHidden);
+}
+
+/**
+ * Changes the text stored by the component with the given handle.
+ * Nothing happens if the component already displays the text.
+ * 
+ * @param   { Page * }  this          The page we want to modify.
+ * @param   { int }     dHandle       The handle of the component we want to modify.
+ * @param   { char * }  sText         The new text of the component.
+*/
+void Page_setComponentTextByHandle(Page *this, int dHandle, char *sText) {
+  Component *pComponent = ComponentManager_get(&this->componentManager, dHandle);
 
   int dChar = 0, dLines = 0, dLineLength = 1024; 
-  char **aAsset = calloc(256, sizeof(*aAsset));
+  char **aAsset;
+
+  // Spare ourselves the allocations
+  if(pComponent == NULL || Component_hasText(pComponent, sText))
+    return;
+
+  aAsset = calloc(256, sizeof(*aAsset));
 
   // Init the first line
   aAsset[dLines] = String_alloc(dLineLength);
@@ -511,8 +668,19 @@ void Page_setComponentText(Page *this, char *sKey, char *sText) {
   }
   
   // Update the size and content of the component
-  ComponentManager_setSize(&this->componentManager, sKey, String_charCount(aAsset[0]), dLines + 1);
-  ComponentManager_setAsset(&this->componentManager, sKey, dLines + 1, aAsset);
+  ComponentManager_setSizeByHandle(&this->componentManager, dHandle, String_charCount(aAsset[0]), dLines + 1);
+  ComponentManager_setAssetByHandle(&this->componentManager, dHandle, dLines + 1, aAsset);
+}
+
+/**
+ * Changes the text stored by a component.
+ * 
+ * @param   { Page * }  this          The page we want to modify.
+ * @param   { char * }  sKey          An identifier for the component we want to modify.
+ * @param   { char * }  sText         The new text of the component.
+*/
+void Page_setComponentText(Page *this, char *sKey, char *sText) {
+  Page_setComponentTextByHandle(this, Page_getComponentHandle(this, sKey), sText);
 }
 
 /**
@@ -709,6 +877,8 @@ void Page_activate(Page *this) {
   this->ePageStatus = PAGE_ACTIVE_INIT;
   this->dT = 0;
   this->dStage = 0;
+  this->eRefresh = PAGE_REFRESH_INPUT;
+  this->dQuietFrames = 0;
 }
 
 /**
@@ -729,6 +899,67 @@ void Page_nextStage(Page *this) {
   this->dStage++;
 }
 
+/**
+ * Tells the engine when the page has to be drawn again, aside from when a key is pressed.
+ * Pages go back to PAGE_REFRESH_INPUT whenever they're activated.
+ * 
+ * @param   { Page * }        this      The page to modify.
+ * @param   { PageRefresh }   eRefresh  When the page needs new frames.
+*/
+void Page_setRefresh(Page *this, PageRefresh eRefresh) {
+  this->eRefresh = eRefresh;
+}
+
+/**
+ * Tells the page something happened, so it draws frames until it settles again.
+ * 
+ * @param   { Page * }  this  The page to wake up.
+*/
+void Page_wake(Page *this) {
+  this->dQuietFrames = 0;
+}
+
+/**
+ * Checks whether the page has to be updated and drawn this frame.
+ * Pages keep getting frames until a few of them leave the screen as it was, since a handler
+ *    sometimes only reacts to what it did in the frame before.
+ * 
+ * @param   { Page * }  this  The page to check.
+ * @return  { int }           Whether or not the page needs a new frame.
+*/
+int Page_needsFrame(Page *this) {
+
+  // Idle pages don't do anything with their frames
+  if(this->ePageStatus == PAGE_INACTIVE || this->ePageStatus == PAGE_ACTIVE_IDLE)
+    return 0;
+
+  if(this->ePageStatus == PAGE_ACTIVE_INIT || this->dQuietFrames < PAGE_SETTLE_FRAMES)
+    return 1;
+
+  switch(this->eRefresh) {
+    case PAGE_REFRESH_FRAME: return 1;
+    case PAGE_REFRESH_SECOND: return time(NULL) != this->lastFrameTime;
+    default: return 0;
+  }
+}
+
+/**
+ * Returns how long the page can go without a new frame if no keys are pressed.
+ * 
+ * @param   { Page * }  this  The page to check.
+ * @return  { int }           How long to wait (in ms); 0 means the page wants the very next frame.
+*/
+int Page_getSleep(Page *this) {
+  if(Page_needsFrame(this))
+    return 0;
+
+  // Wake up right as the next second starts
+  if(this->eRefresh == PAGE_REFRESH_SECOND && this->ePageStatus == PAGE_ACTIVE_RUNNING)
+    return 1000 - IO_getMillis();
+
+  return PAGE_MAX_SLEEP;
+}
+
 /**
  * //
  * ////
@@ -747,6 +978,7 @@ struct PageManager {
   AssetManager *pSharedAssetManager;                          // A reference to the shared asset manager so we only have to pass it during init
   EventStore *pSharedEventStore;                              // A reference to a shared event store so we can access things changed by events
   ThemeManager *pSharedThemeManager;                          // A reference to a shared theme manager which helps us manage the styling of our app
+  Buffer *pScreen;                                            // What the terminal is showing; all the pages draw onto the same one
 
   HashMap *pPageMap;                                          // Stores all the pages we have
   int dPageCount;                                             // How many pages we have
@@ -775,6 +1007,9 @@ void PageManager_init(PageManager *this, AssetManager *pSharedAssetManager, Even
 
   // So we don't have to interact with this all the time
   this->pSharedThemeManager = pSharedThemeManager;
+
+  // Nothing has been drawn yet, so the first frame prints everything
+  this->pScreen = Buffer_create(0, 0, 0x000000, 0x000000);
 }
 
 /**
@@ -784,6 +1019,7 @@ void PageManager_init(PageManager *this, AssetManager *pSharedAssetManager, Even
 */
 void PageManager_exit(PageManager *this) {
   HashMap_kill(this->pPageMap);
+  Buffer_kill(this->pScreen);
 }
 
 /**
@@ -802,6 +1038,7 @@ void PageManager_createPage(PageManager *this, char *sPageKey, f_page_handler fH
 
   // Create the page
   pPage = Page_create(this->pSharedAssetManager, this->pSharedEventStore, this->pSharedThemeManager, fHandler);
+  pPage->pSharedScreen = this->pScreen;
 
   // Set the created page as the active page (by default)
   strcpy(this->sActivePage, sPageKey);
@@ -859,6 +1096,35 @@ void PageManager_update(PageManager *this) {
   }
 }
 
+/**
+ * Wakes the active page up, usually because a key was pressed.
+ * 
+ * @param   { PageManager * }   this  The page manager object.
+*/
+void PageManager_wake(PageManager *this) {
+  Page_wake(HashMap_get(this->pPageMap, this->sActivePage));
+}
+
+/**
+ * Checks whether the active page has to be updated and drawn this frame.
+ * 
+ * @param   { PageManager * }   this  The page manager object.
+ * @return  { int }                   Whether or not the active page needs a new frame.
+*/
+int PageManager_needsFrame(PageManager *this) {
+  return Page_needsFrame(HashMap_get(this->pPageMap, this->sActivePage));
+}
+
+/**
+ * Returns how long the active page can go without a new frame if no keys are pressed.
+ * 
+ * @param   { PageManager * }   this  The page manager object.
+ * @return  { int }                   How long to wait (in ms); 0 means the page wants the very next frame.
+*/
+int PageManager_getSleep(PageManager *this) {
+  return Page_getSleep(HashMap_get(this->pPageMap, this->sActivePage));
+}
+
 /**
  * Gives a page a shared object.
  * 
@@ -98,12 +98,15 @@ void QueueEntry_chain(QueueEntry *this, QueueEntry *pNext) {
 /**
  * A class that holds queue entries and provides methods for managing these.
  * This is essentially just a singly-linked list.
+ * Popped entries are kept aside and reused, so a queue that's filled and emptied 
+ *    every frame stops allocating once it's been as long as it gets.
  * 
  * @class
 */
 struct Queue {
   QueueEntry *pHead;  // The first entry in the queue
   QueueEntry *pTail;  // The last entry in the queue
+  QueueEntry *pSpare; // The entries that were popped, ready to be pushed again
 };
 
 /**
@@ -125,6 +128,7 @@ Queue *Queue_new() {
 Queue *Queue_init(Queue *this) {
   this->pHead = NULL;
   this->pTail = NULL;
+  this->pSpare = NULL;
 
   return this;
 }
@@ -157,6 +161,14 @@ void Queue_kill(Queue *this) {
     free(pHead);
   }
 
+  // And the spare entries
+  while(this->pSpare != NULL) {
+    pHead = this->pSpare;
+    this->pSpare = this->pSpare->pNext;
+
+    free(pHead);
+  }
+
   // Free the queue itself
   free(this);
 }
@@ -181,7 +193,15 @@ p_obj Queue_getHead(Queue *this) {
  * @param   { p_obj }     pObject   The object we wish to enqueue.
 */
 void Queue_push(Queue *this, p_obj pObject) {
-  QueueEntry *pQueueEntry = QueueEntry_create(pObject);
+  QueueEntry *pQueueEntry = this->pSpare;
+
+  // Reuse a popped entry if there's one
+  if(pQueueEntry != NULL) {
+    this->pSpare = pQueueEntry->pNext;
+    QueueEntry_init(pQueueEntry, pObject);
+  } else {
+    pQueueEntry = QueueEntry_create(pObject);
+  }
 
   // Do stuf acc. to if its the first element or not
   if(this->pHead == NULL)
@@ -195,8 +215,7 @@ void Queue_push(Queue *this, p_obj pObject) {
 
 /**
  * Removes an entry from the head of the queue.
- * Note that this also frees the instance from memory, BUT 
- *    it DOESN'T free the pObject member of the entry.
+ * Note that the entry is kept for the next push, and the pObject member of the entry isn't freed.
  * 
  * @param   { Queue * }   this  The queue object we wish to modify.
 */
@@ -213,8 +232,9 @@ void Queue_pop(Queue *this) {
   // Set the new head to the next element
   this->pHead = this->pHead->pNext;
 
-  // Free the element
-  free(pHead);
+  // Keep the element for the next push
+  pHead->pNext = this->pSpare;
+  this->pSpare = pHead;
 }
 
 #endif
\ No newline at end of file
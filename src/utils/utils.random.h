@@ -0,0 +1,159 @@
+/**
+ * @ Author: MMMM
+ * @ Create Time: 2026-10-16 10:02:11
+ * @ Modified time: 2026-10-16 10:02:11
+ * @ Description:
+ *
+ * A small seedable random number generator (xoshiro256**).
+ * Unlike rand(), every generator has its own state, so the same seed always gives the same numbers
+ *    and separate threads don't step on each other.
+ */
+
+#ifndef UTILS_RANDOM_
+#define UTILS_RANDOM_
+
+#include "./utils.types.h"
+
+#include <time.h>
+
+typedef struct Random Random;
+
+/**
+ * //
+ * ////
+ * //////    Random struct
+ * ////////
+ * //////////
+*/
+
+/**
+ * The state of a generator.
+ * This is not a class; just keep one around wherever you need random numbers.
+*/
+struct Random {
+  uint64_t aState[4];   // The 256 bits of state of xoshiro256**
+};
+
+/**
+ * Scrambles a 64-bit value (splitmix64).
+ * This is what we use to stretch a single seed into the full state of the generator.
+ *
+ * @param   { uint64_t * }  pValue  The value to advance; it changes every call.
+ * @return  { uint64_t }            The scrambled output.
+*/
+uint64_t Random_splitMix(uint64_t *pValue) {
+  uint64_t z = (*pValue += 0x9e3779b97f4a7c15ULL);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+  return z ^ (z >> 31);
+}
+
+/**
+ * Creates a seed that differs between calls, even within the same second.
+ * The time, the processor clock and a running counter all get mixed in.
+ * Each thread counts on its own, and where its counter lives tells the threads apart.
+ *
+ * @return  { uint64_t }  A fresh seed that is never 0.
+*/
+uint64_t Random_makeSeed() {
+  static _Thread_local uint64_t dCounter = 0;
+  uint64_t dValue = ((uint64_t) time(NULL) << 20) ^ (uint64_t) clock() ^ (++dCounter << 44) ^
+    (uint64_t) (uintptr_t) &dCounter;
+  uint64_t dSeed = Random_splitMix(&dValue);
+
+  return dSeed ? dSeed : 1;
+}
+
+/**
+ * Seeds the generator.
+ *
+ * @param   { Random * }  this    The generator to seed.
+ * @param   { uint64_t }  dSeed   The seed to use.
+*/
+void Random_seed(Random *this, uint64_t dSeed) {
+  this->aState[0] = Random_splitMix(&dSeed);
+  this->aState[1] = Random_splitMix(&dSeed);
+  this->aState[2] = Random_splitMix(&dSeed);
+  this->aState[3] = Random_splitMix(&dSeed);
+}
+
+/**
+ * Rotates the bits of a word to the left.
+ *
+ * @param   { uint64_t }  dValue  The word to rotate.
+ * @param   { int }       dShift  How many bits to rotate by (1 to 63).
+ * @return  { uint64_t }          The rotated word.
+*/
+uint64_t Random_rotate(uint64_t dValue, int dShift) {
+  return (dValue << dShift) | (dValue >> (64 - dShift));
+}
+
+/**
+ * Returns the next 64 random bits of the generator.
+ *
+ * @param   { Random * }  this  The generator to advance.
+ * @return  { uint64_t }        The random bits.
+*/
+uint64_t Random_next(Random *this) {
+  uint64_t *s = this->aState;
+  uint64_t dResult = Random_rotate(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = Random_rotate(s[3], 45);
+
+  return dResult;
+}
+
+/**
+ * Returns a random number from 0 up to (but not including) dMax, without modulo bias.
+ * We scale a 32-bit number up with a multiply, and only redraw on the rare leftover values.
+ *
+ * @param   { Random * }  this  The generator to use.
+ * @param   { uint32_t }  dMax  The upper limit (exclusive); should be at least 1.
+ * @return  { uint32_t }        A number in [0, dMax).
+*/
+uint32_t Random_range(Random *this, uint32_t dMax) {
+  uint64_t dProduct = (Random_next(this) >> 32) * dMax;
+  uint32_t dThreshold;
+
+  // The low half falling under this means that value is over-represented, so try again
+  if((uint32_t) dProduct < dMax) {
+    dThreshold = -dMax % dMax;
+
+    while((uint32_t) dProduct < dThreshold)
+      dProduct = (Random_next(this) >> 32) * dMax;
+  }
+
+  return (uint32_t) (dProduct >> 32);
+}
+
+/**
+ * Returns a word whose bits are each set with a probability of dDensity / 256.
+ * Each bit of the density (lowest first) either ORs or ANDs in another random word; 
+ *    ORing pushes the probability of a bit towards 1 and ANDing pushes it towards 0.
+ *
+ * @param   { Random * }  this      The generator to use.
+ * @param   { int }       dDensity  The chance of each bit being set, out of 256.
+ * @return  { uint64_t }            The random bits.
+*/
+uint64_t Random_getBits(Random *this, int dDensity) {
+  uint64_t dBits = 0;
+  int i;
+
+  if(dDensity <= 0) return 0;
+  if(dDensity >= 256) return ~0ULL;
+
+  for(i = 0; i < 8; i++)
+    dBits = (dDensity >> i) & 1 ? dBits | Random_next(this) : dBits & Random_next(this);
+
+  return dBits;
+}
+
+#endif
@@ -179,8 +179,9 @@ color Theme_getColor(Theme *this, char *sKey) {
  * @struct
 */
 struct ThemeManager {
-  char *sActiveTheme;   // The key of the active theme
-  HashMap *pThemeMap;   // Stores all the themes
+  char *sActiveTheme;         // The key of the active theme
+  HashMap *pThemeMap;         // Stores all the themes
+  GraphicsCache codeCache;    // The color sequences the pages have used; they're thrown out with the theme
 };
 
 /**
@@ -193,6 +194,7 @@ void ThemeManager_init(ThemeManager *this) {
   // Init some stuff
   this->sActiveTheme = "default";
   this->pThemeMap = HashMap_create();
+  GraphicsCache_init(&this->codeCache);
 
   // Create the default theme
   Theme *pDefaultTheme = Theme_create();
@@ -213,6 +215,7 @@ void ThemeManager_init(ThemeManager *this) {
 */
 void ThemeManager_exit(ThemeManager *this) {
   HashMap_kill(this->pThemeMap);
+  GraphicsCache_exit(&this->codeCache);
 }
 
 /**
@@ -229,6 +232,19 @@ void ThemeManager_setActive(ThemeManager *this, char *sKey) {
 
   // Copy the key of the active theme
   this->sActiveTheme = sKey;
+
+  // The colors we'll be using are about to change
+  GraphicsCache_clear(&this->codeCache);
+}
+
+/**
+ * Changes how the colors of the themes are sent to the terminal.
+ * 
+ * @param   { ThemeManager * }  this    The theme manager.
+ * @param   { GraphicsMode }    eMode   How to send the colors.
+*/
+void ThemeManager_setColorMode(ThemeManager *this, GraphicsMode eMode) {
+  GraphicsCache_setMode(&this->codeCache, eMode);
 }
 
 /**
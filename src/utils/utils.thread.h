@@ -41,6 +41,8 @@ typedef struct ThreadManager ThreadManager;
  *    instead of calling any of the Thread methods defined above; this is similar to how the
  *    EventManager abstracts some methods of the Event class.
  * It allows us to do this without having to pollute the global namespace with variables.
+ * Threads start running the moment they're created and look things up in the hashmaps on their own,
+ *    so every access to the hashmaps goes through the map mutex.
  * Note that this also uses the implementations we defined for both Windows and Unix, without
  *    it having to know the stuff they do under the hood. This keeps our code clean. You can think
  *    of this as some sort of "manager" which handles all our thread and mutex instances.
@@ -52,6 +54,7 @@ struct ThreadManager {
   HashMap *pThreadMap;                                // Stores references to all the threads
   HashMap *pStateMap;                                 // For each thread, we have a state mutex to tell it to keep running        
   HashMap *pMutexMap;                                 // Stores references to all the mutexes
+  Mutex *pMapMutex;                                   // Guards the hashmaps, since threads read them while others are being added
 
   int dThreadCount;                                   // Stores the length of the threads array
   int dMutexCount;                                    // Stores the length of the mutexes array
@@ -69,6 +72,7 @@ ThreadManager *ThreadManager_init(ThreadManager *this) {
   this->pThreadMap = HashMap_create();
   this->pStateMap = HashMap_create();
   this->pMutexMap = HashMap_create();
+  this->pMapMutex = Mutex_create("thread-manager");
 
   // Set the array sizes to 0
   this->dThreadCount = 0;
@@ -92,6 +96,8 @@ void ThreadManager_exit(ThreadManager *this) {
   char *sThreadKeyArray[THREAD_MAX_COUNT];
   char *sMutexKeyArray[MUTEX_MAX_COUNT];
 
+  Mutex_lock(this->pMapMutex);
+
   // Store the keys here
   HashMap_getKeys(this->pThreadMap, sThreadKeyArray);
   HashMap_getKeys(this->pMutexMap, sMutexKeyArray);
@@ -136,6 +142,27 @@ void ThreadManager_exit(ThreadManager *this) {
   HashMap_kill(this->pThreadMap);
   HashMap_kill(this->pMutexMap);
   HashMap_kill(this->pStateMap);
+
+  Mutex_unlock(this->pMapMutex);
+  Mutex_kill(this->pMapMutex);
+}
+
+/**
+ * Looks up an entry of one of the hashmaps of the manager.
+ * 
+ * @param   { ThreadManager * }   this    A reference to the thread manager object.
+ * @param   { HashMap * }         pMap    The hashmap to look in.
+ * @param   { char * }            sKey    The key of the entry.
+ * @return  { p_obj }                     The entry, or NULL if there's none.
+*/
+p_obj ThreadManager_find(ThreadManager *this, HashMap *pMap, char *sKey) {
+  p_obj pEntry;
+
+  Mutex_lock(this->pMapMutex);
+  pEntry = HashMap_get(pMap, sKey);
+  Mutex_unlock(this->pMapMutex);
+
+  return pEntry;
 }
 
 /**
@@ -150,16 +177,18 @@ void ThreadManager_exit(ThreadManager *this) {
  * @param   { int }               tArg_ANY          A parameter that the callback function might need (ie, an enum).
 */
 void ThreadManager_createThread(ThreadManager *this, char *sThreadKey, char *sMutexKey, f_void_callback fCallee, p_obj pArgs_ANY, int tArg_ANY) {
-  Mutex *pStateMutex = HashMap_get(this->pStateMap, sThreadKey), *pDataMutex;
-  Thread *pThread = HashMap_get(this->pThreadMap, sThreadKey);
+  Mutex *pStateMutex, *pDataMutex;
+  Thread *pThread;
 
-  // Duplicate key
-  if(pThread != NULL)
-    return;
+  // The thread starts right away, and it can't see the hashmaps until it's been added to them
+  Mutex_lock(this->pMapMutex);
+  pThread = HashMap_get(this->pThreadMap, sThreadKey);
 
-  // If we don't have too many threads yet
-  if(this->dThreadCount >= THREAD_MAX_COUNT)
+  // Duplicate key, or we have too many threads already
+  if(pThread != NULL || this->dThreadCount >= THREAD_MAX_COUNT) {
+    Mutex_unlock(this->pMapMutex);
     return;
+  }
 
   // The data mutex is the mutex at the specified index
   // Also, we have a new state mutex specifically for the new thread (these are not saved in the array of mutexes)
@@ -167,8 +196,10 @@ void ThreadManager_createThread(ThreadManager *this, char *sThreadKey, char *sMu
   pDataMutex = HashMap_get(this->pMutexMap, sMutexKey);
 
   // If the mutex does not exist
-  if(pDataMutex == NULL)
+  if(pDataMutex == NULL) {
+    Mutex_unlock(this->pMapMutex);
     return;
+  }
 
   // The state mutex keeps the thread alive
   // The thread always checks whether or not this mutex is still locked
@@ -184,6 +215,7 @@ void ThreadManager_createThread(ThreadManager *this, char *sThreadKey, char *sMu
   HashMap_add(this->pStateMap, sThreadKey, pStateMutex);
 
   this->dThreadCount++;
+  Mutex_unlock(this->pMapMutex);
 }
 
 /**
@@ -196,21 +228,23 @@ void ThreadManager_createThread(ThreadManager *this, char *sThreadKey, char *sMu
  * @param   { char * }            sMutexKey   The identifier for the mutex.
 */
 void ThreadManager_createMutex(ThreadManager *this, char *sMutexKey) {
-  Mutex *pMutex = HashMap_get(this->pMutexMap, sMutexKey);
+  Mutex *pMutex;
 
-  // Duplicate key
-  if(pMutex != NULL)
-    return;
+  Mutex_lock(this->pMapMutex);
+  pMutex = HashMap_get(this->pMutexMap, sMutexKey);
 
-  // If we don't have too many mutexes yet
-  if(this->dMutexCount >= MUTEX_MAX_COUNT)
+  // Duplicate key, or we have too many mutexes already
+  if(pMutex != NULL || this->dMutexCount >= MUTEX_MAX_COUNT) {
+    Mutex_unlock(this->pMapMutex);
     return;
+  }
 
   // Create and save the new mutex
   pMutex = Mutex_create(sMutexKey);
   HashMap_add(this->pMutexMap, sMutexKey, pMutex); 
 
   this->dMutexCount++;
+  Mutex_unlock(this->pMapMutex);
 }
 
 /**
@@ -231,14 +265,16 @@ void ThreadManager_killThread(ThreadManager *this, char *sThreadKey) {
   // Release the mutex associated with the thread
   // This automatically kills the thread afterwards, since Thread_kill is called when the 
   //    thread routine terminates
-  Mutex_unlock((Mutex *) HashMap_get(this->pStateMap, sThreadKey));
+  Mutex_unlock((Mutex *) ThreadManager_find(this, this->pStateMap, sThreadKey));
 
   // Wait for thread to die
-  while(HashMap_get(this->pStateMap, sThreadKey) != NULL);
+  while(ThreadManager_find(this, this->pStateMap, sThreadKey) != NULL);
 
   // Update the hashmap
+  Mutex_lock(this->pMapMutex);
   HashMap_del(this->pThreadMap, sThreadKey);
   HashMap_del(this->pStateMap, sThreadKey);
+  Mutex_unlock(this->pMapMutex);
 
   // Shorten the length of the list
   // We can execute this before the loop because of the i + 1
@@ -253,9 +289,9 @@ void ThreadManager_killThread(ThreadManager *this, char *sThreadKey) {
  * @param   { char * }            sMutexKey   The name of the mutex we will lock.
 */
 void ThreadManager_lockMutex(ThreadManager *this, char *sMutexKey) {
-  Mutex *pMutex = HashMap_get(this->pMutexMap, sMutexKey);
+  Mutex *pMutex = ThreadManager_find(this, this->pMutexMap, sMutexKey);
 
-  if(HashMap_get(this->pMutexMap, sMutexKey) != NULL)
+  if(pMutex != NULL)
     Mutex_lock(pMutex);
 }
 
@@ -268,10 +304,39 @@ void ThreadManager_lockMutex(ThreadManager *this, char *sMutexKey) {
  * @return  { int }                           Whether or not the operation was successful.
 */
 void ThreadManager_unlockMutex(ThreadManager *this, char *sMutexKey) {
-  Mutex *pMutex = HashMap_get(this->pMutexMap, sMutexKey);
+  Mutex *pMutex = ThreadManager_find(this, this->pMutexMap, sMutexKey);
 
-  if(HashMap_get(this->pMutexMap, sMutexKey) != NULL)
+  if(pMutex != NULL)
     Mutex_unlock(pMutex);
 }
 
+/**
+ * Gives a thread a signal that can wake it up before its sleep is over.
+ * 
+ * @param   { ThreadManager * }   this          A reference to an instance of ThreadManager to modify.
+ * @param   { char * }            sThreadKey    The name of the thread.
+ * @param   { Signal * }          pWakeSignal   The signal to wait on between runs.
+*/
+void ThreadManager_setThreadSignal(ThreadManager *this, char *sThreadKey, Signal *pWakeSignal) {
+  Thread *pThread = ThreadManager_find(this, this->pThreadMap, sThreadKey);
+
+  if(pThread != NULL)
+    pThread->pWakeSignal = pWakeSignal;
+}
+
+/**
+ * Changes how long a thread sleeps before it runs again.
+ * Threads can call this on themselves, in which case it applies to the sleep right after the current run.
+ * 
+ * @param   { ThreadManager * }   this          A reference to an instance of ThreadManager to modify.
+ * @param   { char * }            sThreadKey    The name of the thread.
+ * @param   { long }              dMillis       How long the thread sleeps between runs.
+*/
+void ThreadManager_setThreadSleep(ThreadManager *this, char *sThreadKey, long dMillis) {
+  Thread *pThread = ThreadManager_find(this, this->pThreadMap, sThreadKey);
+
+  if(pThread != NULL)
+    pThread->dSleep = dMillis;
+}
+
 #endif
\ No newline at end of file
@@ -166,6 +166,25 @@ void IO_flushBuffer() {
   fflush(stdout);
 }
 
+/**
+ * Returns how far into the current second of the clock we are.
+ * File times count from 1601, but that's a whole number of seconds before time() starts counting,
+ *    so the seconds still line up with time().
+ * 
+ * @return  {int}   The milliseconds past the current second.
+*/
+int IO_getMillis() {
+  FILETIME now;
+  ULARGE_INTEGER dTicks;
+
+  GetSystemTimeAsFileTime(&now);
+  dTicks.LowPart = now.dwLowDateTime;
+  dTicks.HighPart = now.dwHighDateTime;
+
+  // The ticks are 100 nanoseconds each
+  return (int) (dTicks.QuadPart / 10000 % 1000);
+}
+
 /**
  * Helper function that gets a single character without return key.
  * 